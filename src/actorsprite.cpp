@@ -332,7 +332,7 @@ void ActorSprite::setupSpriteDisplay(const SpriteDisplay &display,
             + combineDye2((*it)->sprite, color);
 
         int variant = (*it)->variant;
-        addSprite(AnimatedSprite::delayedLoad(file, variant));
+        addSprite(AnimatedSprite::delayedLoad(file, variant, this));
     }
 
     // Ensure that something is shown, if desired
@@ -342,7 +342,7 @@ void ActorSprite::setupSpriteDisplay(const SpriteDisplay &display,
         {
             addSprite(AnimatedSprite::delayedLoad(
                 paths.getStringValue("sprites")
-                + paths.getStringValue("spriteErrorFile")));
+                + paths.getStringValue("spriteErrorFile"), 0, this));
         }
         else
         {
@@ -39,6 +39,7 @@
 #include "utils/checkutils.h"
 #include "utils/dtor.h"
 #include "utils/gettext.h"
+#include "utils/nametable.h"
 #include "utils/stringutils.h"
 
 #include "net/net.h"
@@ -220,7 +221,9 @@ void ActorSpriteManager::setMap(Map *map)
 void ActorSpriteManager::setPlayer(LocalPlayer *player)
 {
     player_node = player;
-    mActors.insert(player);
+    if (player && mActors.insert(player).second)
+        mBeingsByName.insert(std::pair<int, Being*>(player->getNameId(),
+            player));
     if (socialWindow)
         socialWindow->updateAttackFilter();
     if (socialWindow)
@@ -233,6 +236,7 @@ Being *ActorSpriteManager::createBeing(int id, ActorSprite::Type type,
     Being *being = new Being(id, type, subtype, mMap);
 
     mActors.insert(being);
+    mBeingsByName.insert(std::pair<int, Being*>(being->getNameId(), being));
     return being;
 }
 
@@ -262,7 +266,43 @@ void ActorSpriteManager::erase(ActorSprite *actor)
     if (!actor || actor == player_node)
         return;
 
-    mActors.erase(actor);
+    if (mActors.erase(actor) && actor->getType() != ActorSprite::FLOOR_ITEM)
+    {
+        removeBeingName(actor,
+            static_cast<const Being*>(actor)->getNameId());
+    }
+}
+
+void ActorSpriteManager::removeBeingName(ActorSprite *const actor,
+                                         const int nameId)
+{
+    std::pair<BeingsByName::iterator, BeingsByName::iterator> range
+        = mBeingsByName.equal_range(nameId);
+    for (BeingsByName::iterator it = range.first; it != range.second; ++ it)
+    {
+        if ((*it).second == actor)
+        {
+            mBeingsByName.erase(it);
+            return;
+        }
+    }
+}
+
+void ActorSpriteManager::updateBeingName(Being *const being,
+                                         const int oldNameId)
+{
+    std::pair<BeingsByName::iterator, BeingsByName::iterator> range
+        = mBeingsByName.equal_range(oldNameId);
+    for (BeingsByName::iterator it = range.first; it != range.second; ++ it)
+    {
+        if ((*it).second == being)
+        {
+            mBeingsByName.erase(it);
+            mBeingsByName.insert(std::pair<int, Being*>(
+                being->getNameId(), being));
+            return;
+        }
+    }
 }
 
 void ActorSpriteManager::undelete(ActorSprite *actor)
@@ -664,23 +704,22 @@ bool ActorSpriteManager::pickUpNearest(int x, int y, int maxdist)
 Being *ActorSpriteManager::findBeingByName(const std::string &name,
                                            ActorSprite::Type type) const
 {
-    for_actors
-    {
-        if (!*it)
-            continue;
+    // names never interned can't belong to any being
+    const int nameId = NameTable::find(name);
+    if (nameId < 0)
+        return nullptr;
 
-        if ((*it)->getType() == ActorSprite::FLOOR_ITEM
-            || (*it)->getType() == ActorSprite::PORTAL)
-        {
+    const std::pair<BeingsByNameConstIterator, BeingsByNameConstIterator>
+        range = mBeingsByName.equal_range(nameId);
+    for (BeingsByNameConstIterator it = range.first; it != range.second;
+         ++ it)
+    {
+        Being *const being = (*it).second;
+        if (being->getType() == ActorSprite::PORTAL)
             continue;
-        }
 
-        Being *being = static_cast<Being*>(*it);
-        if (being->getName() == name &&
-            (type == ActorSprite::UNKNOWN || type == being->getType()))
-        {
+        if (type == ActorSprite::UNKNOWN || type == being->getType())
             return being;
-        }
     }
     return nullptr;
 }
@@ -778,8 +817,14 @@ void ActorSpriteManager::logic()
          it_end = mDeleteActors.end();
          it != it_end; ++it)
     {
-        mActors.erase(*it);
-        delete *it;
+        ActorSprite *const actor = *it;
+        if (mActors.erase(actor)
+            && actor->getType() != ActorSprite::FLOOR_ITEM)
+        {
+            removeBeingName(actor,
+                static_cast<const Being*>(actor)->getNameId());
+        }
+        delete actor;
     }
 
     mDeleteActors.clear();
@@ -803,9 +848,14 @@ void ActorSpriteManager::clear()
     }
     mActors.clear();
     mDeleteActors.clear();
+    mBeingsByName.clear();
 
     if (player_node)
+    {
         mActors.insert(player_node);
+        mBeingsByName.insert(std::pair<int, Being*>(
+            player_node->getNameId(), player_node));
+    }
 }
 
 Being *ActorSpriteManager::findNearestLivingBeing(int x, int y,
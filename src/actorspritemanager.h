@@ -30,6 +30,8 @@
 
 #include "utils/stringvector.h"
 
+#include <map>
+
 class LocalPlayer;
 class Map;
 
@@ -37,6 +39,9 @@ typedef std::set<ActorSprite*> ActorSprites;
 typedef ActorSprites::iterator ActorSpritesIterator;
 typedef ActorSprites::const_iterator ActorSpritesConstIterator;
 
+typedef std::multimap<int, Being*> BeingsByName;
+typedef BeingsByName::const_iterator BeingsByNameConstIterator;
+
 class ActorSpriteManager: public ConfigListener
 {
     public:
@@ -144,6 +149,12 @@ class ActorSpriteManager: public ConfigListener
         Being *findBeingByName(const std::string &name,
                                ActorSprite::Type type = Being::UNKNOWN) const;
 
+        /**
+         * Moves being in name index after its name changed. Beings not
+         * created by this manager are ignored.
+         */
+        void updateBeingName(Being *const being, const int oldNameId);
+
        /**
         * Finds a nearest being by name and (optionally) by type.
         */
@@ -296,8 +307,11 @@ class ActorSpriteManager: public ConfigListener
         void loadAttackList();
         void storeAttackList();
 
+        void removeBeingName(ActorSprite *const actor, const int nameId);
+
         ActorSprites mActors;
         ActorSprites mDeleteActors;
+        BeingsByName mBeingsByName;
         Map *mMap;
         std::string mSpellHeal1;
         std::string mSpellHeal2;
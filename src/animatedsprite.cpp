@@ -72,7 +72,8 @@ AnimatedSprite *AnimatedSprite::load(const std::string &filename, int variant)
 }
 
 AnimatedSprite *AnimatedSprite::delayedLoad(const std::string &filename,
-                                            int variant)
+                                            int variant,
+                                            const ActorSprite *owner)
 {
     if (!mEnableCache)
         return load(filename, variant);
@@ -85,7 +86,7 @@ AnimatedSprite *AnimatedSprite::delayedLoad(const std::string &filename,
     }
 
     AnimatedSprite *as = new AnimatedSprite(nullptr);
-    as->setDelayLoad(filename, variant);
+    as->setDelayLoad(filename, variant, owner);
     return as;
 }
 
@@ -353,13 +354,14 @@ void AnimatedSprite::setAlpha(float alpha)
 
 void *AnimatedSprite::getHash()
 {
-    if (mFrame)
-        return mFrame;
-//    if (mFrame && mFrame->image)
-//        return mFrame->image;
-//    if (mAnimation)
-//        return mAnimation;
-    return this;
+    // frames are owned by sprite definition, so key stays valid while
+    // cache holds reference to it. Without frame nothing is drawn.
+    return mFrame;
+}
+
+Resource *AnimatedSprite::getHashResource() const
+{
+    return mFrame ? mSprite : nullptr;
 }
 
 bool AnimatedSprite::updateNumber(unsigned num)
@@ -383,7 +385,7 @@ bool AnimatedSprite::updateNumber(unsigned num)
 }
 
 void AnimatedSprite::setDelayLoad(const std::string &filename,
-                                  int variant)
+                                  int variant, const ActorSprite *owner)
 {
     if (mDelayLoad)
     {
@@ -391,8 +393,8 @@ void AnimatedSprite::setDelayLoad(const std::string &filename,
         ResourceManager::removeDelayLoad(mDelayLoad);
         delete mDelayLoad;
     }
-    mDelayLoad = new AnimationDelayLoad(filename, variant, this);
-    ResourceManager::addDelayedAnimation(mDelayLoad); 
+    mDelayLoad = new AnimationDelayLoad(filename, variant, this, owner);
+    ResourceManager::addDelayedAnimation(mDelayLoad);
 }
 
 void AnimatedSprite::clearDelayLoad()
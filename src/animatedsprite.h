@@ -28,6 +28,7 @@
 #include <map>
 #include <string>
 
+class ActorSprite;
 class Animation;
 class AnimationDelayLoad;
 struct Frame;
@@ -54,8 +55,14 @@ class AnimatedSprite : public Sprite
         static AnimatedSprite *load(const std::string &filename,
                                     int variant = 0);
 
+        /**
+         * Creates sprite which is loaded later, if sprite definition is not
+         * in cache. Owner actor is used to prioritize loading.
+         */
         static AnimatedSprite *delayedLoad(const std::string &filename,
-                                           int variant = 0);
+                                           int variant = 0,
+                                           const ActorSprite *owner
+                                           = nullptr);
 
         virtual ~AnimatedSprite();
 
@@ -88,6 +95,8 @@ class AnimatedSprite : public Sprite
 
         virtual void *getHash();
 
+        virtual Resource *getHashResource() const;
+
         bool updateNumber(unsigned num);
 
         void clearDelayLoad();
@@ -101,7 +110,8 @@ class AnimatedSprite : public Sprite
     private:
         bool updateCurrentAnimation(unsigned int dt);
 
-        void setDelayLoad(const std::string &filename, int variant);
+        void setDelayLoad(const std::string &filename, int variant,
+                          const ActorSprite *owner);
 
         SpriteDirection mDirection;    /**< The sprite direction. */
         int mLastTime;                 /**< The last time update was called. */
@@ -21,17 +21,29 @@
 #include "animationdelayload.h"
 
 #include "animatedsprite.h"
+#include "graphics.h"
+#include "localplayer.h"
+
+#include "gui/viewport.h"
 
 #include "resources/resourcemanager.h"
 
+#include <cstdlib>
+
 #include "debug.h"
 
+// pixels around screen where actors still count as visible
+static const int viewMargin = 96;
+
 AnimationDelayLoad::AnimationDelayLoad(const std::string &fileName,
-                                       int variant, AnimatedSprite *sprite) :
+                                       int variant, AnimatedSprite *sprite,
+                                       const ActorSprite *owner) :
     mFileName(fileName),
     mVariant(variant),
     mSprite(sprite),
-    mAction(SpriteAction::STAND)
+    mOwner(owner),
+    mAction(SpriteAction::STAND),
+    mPriority(calcPriority())
 {
 }
 
@@ -61,3 +73,36 @@ void AnimationDelayLoad::load()
         mSprite->play(mAction);
     }
 }
+
+int AnimationDelayLoad::calcPriority() const
+{
+    if (!mOwner || !player_node)
+        return PRIORITY_OTHER;
+
+    if (mOwner == player_node)
+        return PRIORITY_PLAYER;
+    if (mOwner == player_node->getTarget())
+        return PRIORITY_TARGET;
+
+    if (mOwner->getType() == ActorSprite::PLAYER)
+    {
+        const Party *const party = static_cast<const Being*>(
+            mOwner)->getParty();
+        if (party && party == player_node->getParty())
+            return PRIORITY_PARTY;
+    }
+
+    return PRIORITY_OTHER;
+}
+
+bool AnimationDelayLoad::isVisible() const
+{
+    if (!mOwner || !viewport || !mainGraphics)
+        return true;
+
+    const int x = mOwner->getPixelX() - viewport->getCameraX();
+    const int y = mOwner->getPixelY() - viewport->getCameraY();
+
+    return x >= -viewMargin && x <= mainGraphics->mWidth + viewMargin
+        && y >= -viewMargin && y <= mainGraphics->mHeight + viewMargin;
+}
@@ -23,13 +23,24 @@
 
 #include <string>
 
+class ActorSprite;
 class AnimatedSprite;
 
 class AnimationDelayLoad
 {
     public:
+        enum
+        {
+            PRIORITY_PLAYER = 0,
+            PRIORITY_TARGET = 1,
+            PRIORITY_PARTY = 2,
+            PRIORITY_OTHER = 3,
+            PRIORITY_COUNT = 4
+        };
+
         AnimationDelayLoad(const std::string &fileName,
-                           int variant, AnimatedSprite *sprite);
+                           int variant, AnimatedSprite *sprite,
+                           const ActorSprite *owner);
 
         ~AnimationDelayLoad();
 
@@ -40,11 +51,40 @@ class AnimationDelayLoad
         void setAction(std::string action)
         { mAction = action; }
 
+        const std::string &getFileName() const
+        { return mFileName; }
+
+        int getVariant() const
+        { return mVariant; }
+
+        /**
+         * Returns load priority, lower loads first. Sprites of local
+         * player, target and party go before other actors.
+         */
+        int getPriority() const
+        { return mPriority; }
+
+        /**
+         * Recalculates priority, because target or party could change
+         * after load was created.
+         */
+        void updatePriority()
+        { mPriority = calcPriority(); }
+
+        /**
+         * Returns true if owner actor is near screen.
+         */
+        bool isVisible() const;
+
     private:
+        int calcPriority() const;
+
         std::string mFileName;
         int mVariant;
         AnimatedSprite *mSprite;
+        const ActorSprite *mOwner;
         std::string mAction;
+        int mPriority;
 };
 
 #endif // ANIMATIONDELAYLOAD_H
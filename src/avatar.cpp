@@ -28,6 +28,8 @@
 
 #include "debug.h"
 
+unsigned int Avatar::mVersions = 0;
+
 Avatar::Avatar(const std::string &name):
         mId(0),
         mCharId(0),
@@ -45,7 +47,8 @@ Avatar::Avatar(const std::string &name):
         mExp(0),
         mGender(GENDER_UNSPECIFIED),
         mRace(-1),
-        mIp("")
+        mIp(""),
+        mVersion(++ mVersions)
 {
 }
 
@@ -41,19 +41,19 @@ public:
     /**
      * Returns the avatar's name.
      */
-    std::string getName() const
+    const std::string &getName() const
     { return mName; }
 
     /**
      * Set the avatar's name.
      */
     void setName(const std::string &name)
-    { mName = name; }
+    { mName = name; changed(); }
 
     /**
      * Returns the avatar's original name.
      */
-    std::string getOriginalName() const
+    const std::string &getOriginalName() const
     { return mOriginalName; }
 
     std::string getComplexName() const;
@@ -64,7 +64,7 @@ public:
      * Set the avatar's original name.
      */
     void setOriginalName(const std::string &name)
-    { mOriginalName = name; }
+    { mOriginalName = name; changed(); }
 
     /**
      * Returns the avatar's online status.
@@ -76,99 +76,109 @@ public:
      * Set the avatar's online status.
      */
     void setOnline(bool online)
-    { mOnline = online; }
+    { mOnline = online; changed(); }
 
     int getHp() const
     { return mHp; }
 
     void setHp(int hp)
-    { mHp = hp; }
+    { mHp = hp; changed(); }
 
     int getMaxHp() const
     { return mMaxHp; }
 
     void setMaxHp(int maxHp)
-    { mMaxHp = maxHp; }
+    { mMaxHp = maxHp; changed(); }
 
     int getDamageHp() const
     { return mDamageHp; }
 
     void setDamageHp(int damageHp)
-    { mDamageHp = damageHp; }
+    { mDamageHp = damageHp; changed(); }
 
     bool getDisplayBold() const
     { return mDisplayBold; }
 
     void setDisplayBold(bool displayBold)
-    { mDisplayBold = displayBold; }
+    { mDisplayBold = displayBold; changed(); }
 
     int getLevel() const
     { return mLevel; }
 
     void setLevel(int level)
-    { mLevel = level; }
+    { mLevel = level; changed(); }
 
-    std::string getMap() const
+    const std::string &getMap() const
     { return mMap; }
 
     void setMap(std::string map)
-    { mMap = map; }
+    { mMap = map; changed(); }
 
     int getX() const
     { return mX; }
 
     void setX(int x)
-    { mX = x; }
+    { mX = x; changed(); }
 
     int getY() const
     { return mY; }
 
     void setY(int y)
-    { mY = y; }
+    { mY = y; changed(); }
 
     int getType() const
     { return mType; }
 
     void setType(int n)
-    { mType = n; }
+    { mType = n; changed(); }
 
     int getExp() const
     { return mExp; }
 
     void setExp(int n)
-    { mExp = n; }
+    { mExp = n; changed(); }
 
     int getID() const
     { return mId; }
 
     void setID(int id)
-    { mId = id; }
+    { mId = id; changed(); }
 
     int getCharId() const
     { return mCharId; }
 
     void setCharId(int id)
-    { mCharId = id; }
+    { mCharId = id; changed(); }
 
     int getGender() const
     { return mGender; }
 
     void setGender(int g)
-    { mGender = g; }
+    { mGender = g; changed(); }
 
     int getRace() const
     { return mRace; }
 
     void setRace(int r)
-    { mRace = r; }
+    { mRace = r; changed(); }
 
     const std::string &getIp() const
     { return mIp; }
 
     void setIp(std::string ip)
-    { mIp = ip; }
+    { mIp = ip; changed(); }
+
+    /**
+     * Returns number changed by every setter. Numbers are unique for all
+     * avatars, so shown data can be cached by version.
+     */
+    unsigned int getVersion() const
+    { return mVersion; }
 
 protected:
+    void changed()
+    { mVersion = ++ mVersions; }
+
     int mId;
     int mCharId;
     std::string mName;
@@ -187,6 +197,9 @@ protected:
     int mGender;
     int mRace;
     std::string mIp;
+    unsigned int mVersion;
+
+    static unsigned int mVersions;
 };
 
 #endif // AVATAR_H
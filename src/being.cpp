@@ -76,6 +76,7 @@
 
 #include "utils/dtor.h"
 #include "utils/gettext.h"
+#include "utils/nametable.h"
 #include "utils/stringutils.h"
 #include "utils/xml.h"
 
@@ -241,6 +242,7 @@ Being::Being(int id, Type type, uint16_t subtype, Map *map):
     mDistance(0),
     mIsReachable(REACH_UNKNOWN),
     mGoodStatus(-1),
+    mNameId(NameTable::EMPTY),
     mErased(false),
     mEnemy(false),
     mIp(""),
@@ -792,18 +794,23 @@ void Being::handleSkill(Being *victim, int damage, int skillId)
 
 void Being::setName(const std::string &name)
 {
+    const int oldNameId = mNameId;
     if (mType == NPC)
     {
         mName = name.substr(0, name.find('#', 0));
+        mNameId = NameTable::intern(mName);
         showName();
     }
     else
     {
         mName = name;
+        mNameId = NameTable::intern(mName);
 
         if (mType == PLAYER && getShowName())
             showName();
     }
+    if (mNameId != oldNameId && actorSpriteManager)
+        actorSpriteManager->updateBeingName(this, oldNameId);
 }
 
 void Being::setShowName(bool doShowName)
@@ -1630,7 +1637,7 @@ void Being::showName()
     delete mDispName;
     mDispName = nullptr;
 
-    if (mHideErased && player_relations.getRelation(mName) ==
+    if (mHideErased && player_relations.getRelation(mNameId) ==
         PlayerRelation::ERASED)
     {
         return;
@@ -1712,26 +1719,26 @@ void Being::updateColors()
             {
                 mNameColor = &userPalette->getColor(UserPalette::GUILD);
             }
-            else if (player_relations.getRelation(mName) ==
+            else if (player_relations.getRelation(mNameId) ==
                      PlayerRelation::FRIEND)
             {
                 mNameColor = &userPalette->getColor(UserPalette::FRIEND);
             }
-            else if (player_relations.getRelation(mName) ==
+            else if (player_relations.getRelation(mNameId) ==
                      PlayerRelation::DISREGARDED
-                     || player_relations.getRelation(mName) ==
+                     || player_relations.getRelation(mNameId) ==
                      PlayerRelation::BLACKLISTED)
             {
                 mNameColor = &userPalette->getColor(UserPalette::DISREGARDED);
             }
-            else if (player_relations.getRelation(mName) ==
+            else if (player_relations.getRelation(mNameId) ==
                      PlayerRelation::IGNORED
-                     || player_relations.getRelation(mName) ==
+                     || player_relations.getRelation(mNameId) ==
                      PlayerRelation::ENEMY2)
             {
                 mNameColor = &userPalette->getColor(UserPalette::IGNORED);
             }
-            else if (player_relations.getRelation(mName) ==
+            else if (player_relations.getRelation(mNameId) ==
                      PlayerRelation::ERASED)
             {
                 mNameColor = &userPalette->getColor(UserPalette::ERASED);
@@ -1787,7 +1794,7 @@ void Being::setSprite(unsigned int slot, int id, std::string color,
             filename = combineDye(filename, color);
 
             equipmentSprite = AnimatedSprite::delayedLoad(
-                paths.getStringValue("sprites") + filename);
+                paths.getStringValue("sprites") + filename, 0, this);
         }
 
         if (equipmentSprite)
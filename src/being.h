@@ -279,6 +279,12 @@ class Being : public ActorSprite, public ConfigListener
         const std::string &getName() const
         { return mName; }
 
+        /**
+         * Returns interned id of the being name (see NameTable).
+         */
+        int getNameId() const
+        { return mNameId; }
+
         /**
          * Sets the name for the being.
          *
@@ -897,6 +903,7 @@ class Being : public ActorSprite, public ConfigListener
         int mDistance;
         int mIsReachable; /**< 0 - unknown, 1 - reachable, 2 - not reachable*/
         int mGoodStatus;
+        int mNameId;
 
         static int mUpdateConfigTime;
         static unsigned int mConfLineLim;
@@ -80,9 +80,11 @@
 #include "net/partyhandler.h"
 #include "net/worldinfo.h"
 
+#include "resources/atlasmanager.h"
 #include "resources/beinginfo.h"
 #include "resources/chardb.h"
 #include "resources/colordb.h"
+#include "resources/dye.h"
 #include "resources/emotedb.h"
 #include "resources/image.h"
 #include "resources/imagehelper.h"
@@ -97,13 +99,17 @@
 #include "resources/npcdb.h"
 #include "resources/resourcemanager.h"
 
+#include "utils/blitkernels.h"
+#include "utils/framepacer.h"
 #include "utils/gettext.h"
 #include "utils/mkdir.h"
 #include "utils/paths.h"
+#include "utils/profiler.h"
 #include "utils/stringutils.h"
 
 #include "utils/translation/translationmanager.h"
 
+#include "test/loadstats.h"
 #include "test/testlauncher.h"
 #include "test/testmain.h"
 
@@ -182,15 +188,13 @@ extern "C" char const *_nl_locale_name_default(void);
 #endif
 
 /**
- * Advances game logic counter.
+ * Updates game logic counter from monotonic clock.
  * Called every 10 milliseconds by SDL_AddTimer()
  * @see MILLISECONDS_IN_A_TICK value
  */
 uint32_t nextTick(uint32_t interval, void *param A_UNUSED)
 {
-    tick_time++;
-    if (tick_time == MAX_TICK_VALUE)
-        tick_time = 0;
+    tick_time = FramePacer::getTicks() % MAX_TICK_VALUE;
     return interval;
 }
 
@@ -529,9 +533,17 @@ void Client::gameInit()
     ImageHelper::setEnableAlpha(config.getFloatValue("guialpha") != 1.0f);
 #endif
 
+    BlitKernels::init(config.getBoolValue("simdBlit"));
+    logger->log("Software blit kernels: %s", BlitKernels::getModeName());
+
     graphicsManager.initGraphics(mOptions.noOpenGL);
 
     runCounters = config.getBoolValue("packetcounters");
+    LoadStats::init();
+    DepricatedEvent::setBatching(config.getBoolValue("batchStatEvents"));
+#ifdef ENABLE_PROFILER
+    Profiler::init();
+#endif
 
     applyVSync();
 
@@ -622,19 +634,12 @@ void Client::gameInit()
 
     // Initialize logic and seconds counters
     tick_time = 0;
+    FramePacer::init(MILLISECONDS_IN_A_TICK);
     mLogicCounterId = SDL_AddTimer(MILLISECONDS_IN_A_TICK, nextTick, nullptr);
     mSecondsCounterId = SDL_AddTimer(1000, nextSecond, nullptr);
 
     const int fpsLimit = config.getIntValue("fpslimit");
     mLimitFps = fpsLimit > 0;
-
-    // Initialize frame limiting
-    mFpsManager.framecount = 0;
-    mFpsManager.rateticks = 0;
-    mFpsManager.lastticks = 0;
-    mFpsManager.rate = 0;
-
-    SDL_initFramerate(&mFpsManager);
     setFramerate(fpsLimit);
     config.addListener("fpslimit", this);
     config.addListener("guialpha", this);
@@ -685,9 +690,12 @@ void Client::gameClear()
     SDL_RemoveTimer(mLogicCounterId);
     SDL_RemoveTimer(mSecondsCounterId);
 
+    LoadStats::close();
+
     // Unload XML databases
     CharDB::unload();
     ColorDB::unload();
+    Dye::unload();
     EmoteDB::unload();
     ItemDB::unload();
     MonsterDB::unload();
@@ -747,6 +755,7 @@ void Client::gameClear()
         logger->log1("Quitting6");
 
     ActorSprite::unload();
+    AtlasManager::clear();
 
     ResourceManager::deleteInstance();
 
@@ -815,8 +824,6 @@ int Client::testsExec()
 
 int Client::gameExec()
 {
-    int lastTickTime = tick_time;
-
     if (!mumbleManager)
         mumbleManager = new MumbleManager();
 
@@ -824,6 +831,11 @@ int Client::gameExec()
 
     while (mState != STATE_EXIT)
     {
+        LoadStats::frame();
+        PROFILER_FRAME();
+        FramePacer::beginFrame();
+        logger->flush();
+
         if (mGame)
         {
             // Let the game handle the events while it is active
@@ -834,6 +846,7 @@ int Client::gameExec()
             // Handle SDL events
             while (SDL_PollEvent(&event))
             {
+                FramePacer::inputReceived();
                 switch (event.type)
                 {
                     case SDL_QUIT:
@@ -882,9 +895,14 @@ int Client::gameExec()
         if (Net::getGeneralHandler())
             Net::getGeneralHandler()->flushNetwork();
 
-        int k = 0;
-        while (lastTickTime != tick_time && k < 40)
+        PROFILER_BEGIN(ZONE_LOGIC);
+        // long catch-up is spread over frames, see FramePacer
+        const int steps = FramePacer::getLogicSteps();
+        for (int k = 0; k < steps; k ++)
         {
+            // send packets made by previous step without waiting frame end
+            if (k > 0 && Net::getGeneralHandler())
+                Net::getGeneralHandler()->flushNetwork();
             if (gui)
                 gui->logic();
             if (mGame)
@@ -893,26 +911,27 @@ int Client::gameExec()
                 gui->handleInput();
 
             sound.logic();
-
-            ++lastTickTime;
-            k ++;
+            DepricatedEvent::deliverQueued();
         }
-        logic_count += k;
+        logic_count += steps;
         if (gui)
             gui->slowLogic();
         if (mGame)
             mGame->slowLogic();
-
-        // This is done because at some point tick_time will wrap.
-        lastTickTime = tick_time;
+        PROFILER_END(ZONE_LOGIC);
 
         // Update the screen when application is active, delay otherwise.
         if (SDL_GetAppState() & SDL_APPACTIVE)
         {
             frame_count++;
+            PROFILER_BEGIN(ZONE_DRAW);
             if (gui)
                 gui->draw();
+            PROFILER_END(ZONE_DRAW);
+            PROFILER_BEGIN(ZONE_SCREEN);
             mainGraphics->updateScreen();
+            PROFILER_END(ZONE_SCREEN);
+            FramePacer::endFrame();
 //            logger->log("active");
         }
         else
@@ -922,7 +941,7 @@ int Client::gameExec()
         }
 
         if (mLimitFps)
-            SDL_framerateDelay(&mFpsManager);
+            FramePacer::delay();
 
         // TODO: Add connect timeouts
         if (mState == STATE_CONNECT_GAME &&
@@ -1014,8 +1033,8 @@ int Client::gameExec()
         if (mState != mOldState)
         {
             DepricatedEvent evt(EVENT_STATECHANGE);
-            evt.setInt("oldState", mOldState);
-            evt.setInt("newState", mState);
+            evt.state().oldState = mOldState;
+            evt.state().newState = mState;
             DepricatedEvent::trigger(CHANNEL_CLIENT, evt);
 
             if (mOldState == STATE_GAME)
@@ -1214,6 +1233,12 @@ int Client::gameExec()
                         resman->addToSearchPath(mLocalDataDir
                             + PHYSFS_getDirSeparator()
                             + mUpdatesDir + "/local/", false);
+
+                        if (config.getBoolValue("useContentPack"))
+                        {
+                            resman->loadContentPack(mLocalDataDir
+                                + PHYSFS_getDirSeparator() + mUpdatesDir);
+                        }
                     }
 
                     // Read default paths file 'data/paths.xml'
@@ -1231,8 +1256,8 @@ int Client::gameExec()
                     TranslationManager::loadCurrentLang();
 
                     DepricatedEvent evt2(EVENT_STATECHANGE);
-                    evt2.setInt("newState", STATE_LOAD_DATA);
-                    evt2.setInt("oldState", mOldState);
+                    evt2.state().newState = STATE_LOAD_DATA;
+                    evt2.state().oldState = mOldState;
                     DepricatedEvent::trigger(CHANNEL_CLIENT, evt2);
 
                     // Load XML databases
@@ -2412,7 +2437,7 @@ void Client::setFramerate(int fpsLimit)
     if (!fpsLimit || !instance()->mLimitFps)
         return;
 
-    SDL_setFramerate(&instance()->mFpsManager, fpsLimit);
+    FramePacer::setFramerate(fpsLimit);
 }
 
 int Client::getFramerate()
@@ -2420,7 +2445,7 @@ int Client::getFramerate()
     if (!instance()->mLimitFps)
         return 0;
 
-    return SDL_getFramerate(&instance()->mFpsManager);
+    return FramePacer::getFramerate();
 }
 
 void Client::closeDialogs()
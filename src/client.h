@@ -30,7 +30,6 @@
 #include <guichan/actionlistener.hpp>
 
 #include <SDL.h>
-#include <SDL_framerate.h>
 
 #include <string>
 
@@ -375,7 +374,6 @@ private:
     bool mInputFocused;
     bool mMouseFocused;
     float mGuiAlpha;
-    FPSmanager mFpsManager;
 };
 
 #endif // CLIENT_H
@@ -26,6 +26,7 @@
 #include "actorspritemanager.h"
 #include "channelmanager.h"
 #include "channel.h"
+#include "client.h"
 #include "configuration.h"
 #include "game.h"
 #include "guildmanager.h"
@@ -61,6 +62,10 @@
 #include "openglgraphics.h"
 #endif
 
+#ifdef ENABLE_ALLOC_PROFILER
+#include "debug/allocprofiler.h"
+#endif
+
 #ifdef DEBUG_DUMP_LEAKS1
 #include "resources/image.h"
 #include "resources/resource.h"
@@ -216,6 +221,8 @@ void CommandHandler::handleCommand(const std::string &command, ChatTab *tab)
         handleDumpTests(args, tab);
     else if (type == "dumpogl")
         handleDumpOGL(args, tab);
+    else if (type == "allocprofiler")
+        handleAllocProfiler(args, tab);
     else if (tab->handleCommand(type, args))
         ;
     else if (type == "hack")
@@ -1370,3 +1377,65 @@ void CommandHandler::handleDumpOGL(const std::string &args A_UNUSED,
     OpenGLGraphics::dumpSettings();
 #endif
 }
+
+void CommandHandler::handleAllocProfiler(const std::string &args A_UNUSED,
+                                         ChatTab *tab)
+{
+#ifdef ENABLE_ALLOC_PROFILER
+    if (!AllocProfiler::isAvailable())
+    {
+        tab->chatLog(_("Allocation profiler not available in memory debug "
+            "or benchmarks builds."));
+        return;
+    }
+
+    std::string cmd = args;
+    std::string param;
+    const size_t idx = args.find(" ");
+    if (idx != std::string::npos)
+    {
+        cmd = args.substr(0, idx);
+        param = args.substr(idx + 1);
+        trim(param);
+    }
+
+    if (cmd == "start")
+    {
+        const int interval = param.empty() ? 0 : atoi(param.c_str());
+        AllocProfiler::start(interval);
+        tab->chatLog(_("Allocation profiler started."));
+    }
+    else if (cmd == "stop")
+    {
+        AllocProfiler::stop();
+        tab->chatLog(_("Allocation profiler stopped."));
+    }
+    else if (cmd == "reset")
+    {
+        AllocProfiler::reset();
+        tab->chatLog(_("Allocation profiler data cleared."));
+    }
+    else if (cmd == "dump")
+    {
+        const std::string dir = Client::getLocalDataDirectory();
+        if (AllocProfiler::dumpReport(dir + "/alloc_report.txt", 50)
+            && AllocProfiler::dumpFolded(dir + "/alloc_folded.txt"))
+        {
+            tab->chatLog(strprintf(_("Saved %d callsites to %s"),
+                AllocProfiler::getCallsitesCount(), dir.c_str()));
+        }
+        else
+        {
+            tab->chatLog(_("Allocation profiler dump failed."));
+        }
+    }
+    else
+    {
+        tab->chatLog(strprintf(_("Allocation profiler: %s, %d callsites."),
+            AllocProfiler::isEnabled() ? _("running") : _("stopped"),
+            AllocProfiler::getCallsitesCount()));
+    }
+#else
+    tab->chatLog(_("Allocation profiler not compiled in."));
+#endif
+}
@@ -308,6 +308,8 @@ class CommandHandler
 
         void handleDumpOGL(const std::string &args, ChatTab *tab);
 
+        void handleAllocProfiler(const std::string &args, ChatTab *tab);
+
         void outString(ChatTab *tab, const std::string &str,
                        const std::string &def);
 
@@ -41,15 +41,147 @@
 
 #include <SDL.h>
 
+#include <map>
+
 #include "debug.h"
 
 #define BUFFER_WIDTH 100
 #define BUFFER_HEIGHT 100
 
-static const unsigned cache_max_size = 10;
-static const unsigned cache_clean_part = 3;
+static const int item_image_size = BUFFER_WIDTH * BUFFER_HEIGHT * 4;
+
 bool CompoundSprite::mEnableDelay = true;
 
+namespace
+{
+    typedef std::map<VectorPointers, CompoundItem*> CompoundCache;
+    typedef std::list<CompoundItem*> UnusedItems;
+
+    // composed frames shared between all beings
+    CompoundCache compoundCache;
+    // not referenced cached frames, most recently used first
+    UnusedItems unusedItems;
+    int cacheBytes = 0;
+    int cacheLimit = -1;
+
+    // scratch buffers reused by every redraw
+    SDL_Surface *scratchSurface = nullptr;
+    SDL_Surface *scratchAlphaSurface = nullptr;
+    Graphics *scratchGraphics = nullptr;
+    VectorPointers scratchKey;
+
+    int itemBytes(const CompoundItem *const item)
+    {
+        int bytes = 0;
+        if (item->image)
+            bytes += item_image_size;
+        if (item->alphaImage)
+            bytes += item_image_size;
+        return bytes;
+    }
+
+    void deleteItem(CompoundItem *const item)
+    {
+        cacheBytes -= itemBytes(item);
+        delete item;
+    }
+
+    void evictItems()
+    {
+        if (cacheLimit < 0)
+            cacheLimit = config.getIntValue("compoundCacheSize") * 1024 * 1024;
+
+        while (cacheBytes > cacheLimit && !unusedItems.empty())
+        {
+            CompoundItem *const item = unusedItems.back();
+            unusedItems.pop_back();
+            compoundCache.erase(item->data);
+            deleteItem(item);
+        }
+    }
+
+    CompoundItem *acquireItem(const VectorPointers &key)
+    {
+        CompoundCache::iterator it = compoundCache.find(key);
+        if (it == compoundCache.end())
+            return nullptr;
+
+        CompoundItem *const item = (*it).second;
+        if (!item->refCount)
+            unusedItems.erase(item->unusedPos);
+        item->refCount ++;
+        return item;
+    }
+
+    void releaseItem(CompoundItem *const item)
+    {
+        item->refCount --;
+        if (item->refCount > 0)
+            return;
+
+        if (!item->inCache)
+        {
+            deleteItem(item);
+            return;
+        }
+
+        unusedItems.push_front(item);
+        item->unusedPos = unusedItems.begin();
+        evictItems();
+    }
+
+    void addItem(CompoundItem *const item)
+    {
+        item->refCount = 1;
+        cacheBytes += itemBytes(item);
+        if (compoundCache.find(item->data) == compoundCache.end())
+        {
+            compoundCache[item->data] = item;
+            item->inCache = true;
+            evictItems();
+        }
+    }
+
+    bool initScratch()
+    {
+        if (scratchSurface)
+            return true;
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        const int rmask = 0xff000000;
+        const int gmask = 0x00ff0000;
+        const int bmask = 0x0000ff00;
+        const int amask = 0x000000ff;
+#else
+        const int rmask = 0x000000ff;
+        const int gmask = 0x0000ff00;
+        const int bmask = 0x00ff0000;
+        const int amask = 0xff000000;
+#endif
+
+        scratchSurface = SDL_CreateRGBSurface(SDL_HWSURFACE,
+            BUFFER_WIDTH, BUFFER_HEIGHT, 32, rmask, gmask, bmask, amask);
+        scratchAlphaSurface = SDL_CreateRGBSurface(SDL_HWSURFACE,
+            BUFFER_WIDTH, BUFFER_HEIGHT, 32, rmask, gmask, bmask, amask);
+
+        if (!scratchSurface || !scratchAlphaSurface)
+        {
+            if (scratchSurface)
+                SDL_FreeSurface(scratchSurface);
+            if (scratchAlphaSurface)
+                SDL_FreeSurface(scratchAlphaSurface);
+            scratchSurface = nullptr;
+            scratchAlphaSurface = nullptr;
+            return false;
+        }
+
+        scratchGraphics = new Graphics();
+        scratchGraphics->setBlitMode(Graphics::BLIT_GFX);
+        scratchGraphics->setTarget(scratchSurface);
+        return true;
+    }
+}
+
 CompoundSprite::CompoundSprite() :
     mCacheItem(nullptr),
     mImage(nullptr),
@@ -294,10 +426,48 @@ void CompoundSprite::clear()
         mSprites.clear();
     }
     mNeedsRedraw = true;
-    delete_all(imagesCache);
-    imagesCache.clear();
-    delete mCacheItem;
-    mCacheItem = nullptr;
+    if (mCacheItem)
+    {
+        releaseItem(mCacheItem);
+        mCacheItem = nullptr;
+    }
+    else
+    {
+        delete mImage;
+        delete mAlphaImage;
+    }
+    mImage = nullptr;
+    mAlphaImage = nullptr;
+}
+
+void CompoundSprite::clearCache()
+{
+    for (CompoundCache::iterator it = compoundCache.begin(),
+         it_end = compoundCache.end(); it != it_end; ++ it)
+    {
+        CompoundItem *const item = (*it).second;
+        // used items will be deleted by last owner
+        if (item->refCount)
+            item->inCache = false;
+        else
+            deleteItem(item);
+    }
+    compoundCache.clear();
+    unusedItems.clear();
+    cacheLimit = -1;
+
+    delete scratchGraphics;
+    scratchGraphics = nullptr;
+    if (scratchSurface)
+    {
+        SDL_FreeSurface(scratchSurface);
+        scratchSurface = nullptr;
+    }
+    if (scratchAlphaSurface)
+    {
+        SDL_FreeSurface(scratchAlphaSurface);
+        scratchAlphaSurface = nullptr;
+    }
 }
 
 void CompoundSprite::ensureSize(size_t layerCount)
@@ -342,29 +512,13 @@ unsigned int CompoundSprite::getFrameCount(unsigned int layer)
 
 void CompoundSprite::redraw() const
 {
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-    int rmask = 0xff000000;
-    int gmask = 0x00ff0000;
-    int bmask = 0x0000ff00;
-    int amask = 0x000000ff;
-#else
-    int rmask = 0x000000ff;
-    int gmask = 0x0000ff00;
-    int bmask = 0x00ff0000;
-    int amask = 0xff000000;
-#endif
-
-    SDL_Surface *surface = SDL_CreateRGBSurface(SDL_HWSURFACE,
-        BUFFER_WIDTH, BUFFER_HEIGHT, 32, rmask, gmask, bmask, amask);
-
-    if (!surface)
+    if (!initScratch())
         return;
 
-    Graphics *graphics = new Graphics();
-    graphics->setBlitMode(Graphics::BLIT_GFX);
-    graphics->setTarget(surface);
-    graphics->_beginDraw();
+    SDL_SetAlpha(scratchSurface, SDL_SRCALPHA, SDL_ALPHA_OPAQUE);
+    SDL_FillRect(scratchSurface, nullptr, 0);
+
+    scratchGraphics->_beginDraw();
 
     int tileX = 32 / 2;
     int tileY = 32;
@@ -386,27 +540,20 @@ void CompoundSprite::redraw() const
     mOffsetX = tileX - BUFFER_WIDTH / 2;
     mOffsetY = tileY - BUFFER_HEIGHT;
 
-    drawSpritesSDL(graphics, posX, posY);
-
-    delete graphics;
-    graphics = nullptr;
+    drawSpritesSDL(scratchGraphics, posX, posY);
 
-    SDL_Surface *surfaceA = SDL_CreateRGBSurface(SDL_HWSURFACE,
-        BUFFER_WIDTH, BUFFER_HEIGHT, 32, rmask, gmask, bmask, amask);
-
-    SDL_SetAlpha(surface, 0, SDL_ALPHA_OPAQUE);
-    SDL_BlitSurface(surface, nullptr, surfaceA, nullptr);
+    scratchGraphics->_endDraw();
 
     delete mImage;
     delete mAlphaImage;
 
-    mImage = imageHelper->load(surface);
-    SDL_FreeSurface(surface);
+    mImage = imageHelper->load(scratchSurface);
 
     if (ImageHelper::mEnableAlpha)
     {
-        mAlphaImage = imageHelper->load(surfaceA);
-        SDL_FreeSurface(surfaceA);
+        SDL_SetAlpha(scratchSurface, 0, SDL_ALPHA_OPAQUE);
+        SDL_BlitSurface(scratchSurface, nullptr, scratchAlphaSurface, nullptr);
+        mAlphaImage = imageHelper->load(scratchAlphaSurface);
     }
     else
     {
@@ -473,89 +620,76 @@ void CompoundSprite::updateImages() const
     }
 }
 
-bool CompoundSprite::updateFromCache() const
+void CompoundSprite::buildCacheKey(VectorPointers &key) const
 {
-//    static int hits = 0;
-//    static int miss = 0;
-
-    if (mCacheItem && mCacheItem->image)
+    key.clear();
+    for (SpriteConstIterator it = mSprites.begin(), it_end = mSprites.end();
+         it != it_end; ++ it)
     {
-        imagesCache.push_front(mCacheItem);
-        mCacheItem = nullptr;
-        if (imagesCache.size() > cache_max_size)
-        {
-            for (unsigned f = 0; f < cache_clean_part; f ++)
-            {
-                CompoundItem *item = imagesCache.back();
-                imagesCache.pop_back();
-                delete item;
-            }
-        }
+        if (*it)
+            key.push_back((*it)->getHash());
+        else
+            key.push_back(nullptr);
     }
+    // with alpha fix layer images carry alpha, so composed image depends on it
+    key.push_back(reinterpret_cast<void*>(static_cast<size_t>(
+        mAlpha * 255.0f + 0.5f)));
+}
 
-//    logger->log("cache size: %d, hit %d, miss %d",
-//        (int)imagesCache.size(), hits, miss);
+bool CompoundSprite::updateFromCache() const
+{
+    buildCacheKey(scratchKey);
 
-    for (ImagesCache::iterator it = imagesCache.begin(),
-         it_end = imagesCache.end(); it != it_end; ++ it)
+    if (mCacheItem)
     {
-        CompoundItem *ic = *it;
-        if (ic && ic->data.size() == size())
+        if (mCacheItem->data == scratchKey)
         {
-            bool fail(false);
-            VectorPointers::const_iterator it2 = ic->data.begin();
-            VectorPointers::const_iterator it2_end = ic->data.end();
-
-            for (SpriteConstIterator it1 = mSprites.begin(),
-                 it1_end = mSprites.end();
-                 it1 != it1_end && it2 != it2_end;
-                 ++ it1, ++ it2)
-            {
-                void *ptr1 = nullptr;
-                void *ptr2 = nullptr;
-                if (*it1)
-                    ptr1 = (*it1)->getHash();
-                if (*it2)
-                    ptr2 = *it2;
-                if (ptr1 != ptr2)
-                {
-                    fail = true;
-                    break;
-                }
-            }
-            if (!fail)
-            {
-//                hits ++;
-                mImage = (*it)->image;
-                mAlphaImage = (*it)->alphaImage;
-                imagesCache.erase(it);
-                mCacheItem = ic;
-                return true;
-            }
+            mImage = mCacheItem->image;
+            mAlphaImage = mCacheItem->alphaImage;
+            mOffsetX = mCacheItem->offsetX;
+            mOffsetY = mCacheItem->offsetY;
+            return true;
         }
+        releaseItem(mCacheItem);
+        mCacheItem = nullptr;
     }
+
     mImage = nullptr;
     mAlphaImage = nullptr;
-//    miss++;
-    return false;
+
+    CompoundItem *const item = acquireItem(scratchKey);
+    if (!item)
+        return false;
+
+    mCacheItem = item;
+    mImage = item->image;
+    mAlphaImage = item->alphaImage;
+    mOffsetX = item->offsetX;
+    mOffsetY = item->offsetY;
+    return true;
 }
 
 void CompoundSprite::initCurrentCacheItem() const
 {
-    delete mCacheItem;
-    mCacheItem = new CompoundItem();
-    mCacheItem->image = mImage;
-    mCacheItem->alphaImage = mAlphaImage;
-//    mCacheItem->alpha = mAlpha;
-
+    CompoundItem *const item = new CompoundItem();
+    item->image = mImage;
+    item->alphaImage = mAlphaImage;
+    item->offsetX = mOffsetX;
+    item->offsetY = mOffsetY;
+//    item->alpha = mAlpha;
+    buildCacheKey(item->data);
     for (SpriteConstIterator it = mSprites.begin(), it_end = mSprites.end();
          it != it_end; ++ it)
     {
-        if (*it)
-            mCacheItem->data.push_back((*it)->getHash());
-        else
-            mCacheItem->data.push_back(nullptr);
+        Resource *const resource = *it ? (*it)->getHashResource() : nullptr;
+        if (resource)
+        {
+            resource->incRef();
+            item->resources.push_back(resource);
+        }
     }
+    addItem(item);
+    mCacheItem = item;
 }
 
 bool CompoundSprite::updateNumber(unsigned num)
@@ -576,7 +710,11 @@ bool CompoundSprite::updateNumber(unsigned num)
 CompoundItem::CompoundItem() :
 //    alpha(1.0f),
     image(nullptr),
-    alphaImage(nullptr)
+    alphaImage(nullptr),
+    offsetX(0),
+    offsetY(0),
+    refCount(0),
+    inCache(false)
 {
 }
 
@@ -584,4 +722,9 @@ CompoundItem::~CompoundItem()
 {
     delete image;
     delete alphaImage;
+    for (std::vector<Resource*>::const_iterator it = resources.begin(),
+         it_end = resources.end(); it != it_end; ++ it)
+    {
+        (*it)->decRef();
+    }
 }
@@ -28,9 +28,13 @@
 #include <vector>
 
 class Image;
+class Resource;
 
-typedef std::list <void*> VectorPointers;
+typedef std::vector<void*> VectorPointers;
 
+/**
+ * Composed frame shared by all compound sprites with same layer hashes.
+ */
 class CompoundItem
 {
     public:
@@ -40,8 +44,15 @@ class CompoundItem
 
 //        float alpha;
         VectorPointers data;
+        // resources owning keys in data, referenced while item exists
+        std::vector<Resource*> resources;
         Image *image;
         Image *alphaImage;
+        int offsetX;
+        int offsetY;
+        int refCount;
+        bool inCache;
+        std::list<CompoundItem*>::iterator unusedPos;
 };
 
 class CompoundSprite : public Sprite
@@ -124,6 +135,12 @@ public:
     static void setEnableDelay(bool b)
     { mEnableDelay = b; }
 
+    /**
+     * Drops all unused composed frames. Frames still drawn by sprites
+     * are freed when released.
+     */
+    static void clearCache();
+
 private:
     void redraw() const;
 
@@ -133,8 +150,8 @@ private:
 
     void initCurrentCacheItem() const;
 
-    typedef std::list<CompoundItem*> ImagesCache;
-    mutable ImagesCache imagesCache;
+    void buildCacheKey(VectorPointers &key) const;
+
     mutable CompoundItem *mCacheItem;
 
     mutable Image *mImage;
@@ -0,0 +1,434 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debug/allocprofiler.h"
+
+#ifdef ENABLE_ALLOC_PROFILER
+
+#include "logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <new>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __GLIBC__
+#include <cxxabi.h>
+#include <execinfo.h>
+#endif
+
+#include "debug.h"
+
+#ifdef __GNUC__
+#define ALLOC_TLS __thread
+#else
+#define ALLOC_TLS
+#endif
+
+namespace
+{
+    enum
+    {
+        MAX_FRAMES = 16,
+        // sample() and operator new frames
+        SKIP_FRAMES = 2,
+        CALLSITES = 4096,
+        THREAD_BUFFER = 32
+    };
+
+    struct AllocSample
+    {
+        void *frames[MAX_FRAMES];
+        int depth;
+        unsigned int bytes;
+    };
+
+    struct Callsite
+    {
+        void *frames[MAX_FRAMES];
+        int depth;
+        unsigned int hash;
+        unsigned int count;
+        unsigned long long bytes;
+    };
+
+    Callsite callsites[CALLSITES];
+    int callsitesCount = 0;
+    unsigned int droppedSamples = 0;
+    volatile int tableLock = 0;
+
+    ALLOC_TLS AllocSample threadSamples[THREAD_BUFFER];
+    ALLOC_TLS int threadSamplesCount = 0;
+    ALLOC_TLS long threadCountdown = 0;
+    ALLOC_TLS unsigned int threadRandom = 0;
+    ALLOC_TLS bool threadBusy = false;
+    ALLOC_TLS bool threadMain = false;
+
+    void lockTable()
+    {
+        while (__sync_lock_test_and_set(&tableLock, 1))
+        {
+        }
+    }
+
+    void unlockTable()
+    {
+        __sync_lock_release(&tableLock);
+    }
+
+    unsigned int hashFrames(void *const *frames, const int depth)
+    {
+        unsigned int hash = 2166136261U;
+        for (int f = 0; f < depth; f ++)
+        {
+            hash ^= static_cast<unsigned int>(
+                reinterpret_cast<size_t>(frames[f]));
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+
+    long nextCountdown(const int interval)
+    {
+        // xorshift, jitter keeps periodic allocations from aliasing
+        if (!threadRandom)
+        {
+            threadRandom = static_cast<unsigned int>(
+                reinterpret_cast<size_t>(&threadRandom)) | 1;
+        }
+        threadRandom ^= threadRandom << 13;
+        threadRandom ^= threadRandom >> 17;
+        threadRandom ^= threadRandom << 5;
+        return interval / 2 + threadRandom % interval;
+    }
+
+    std::string frameName(void *const frame)
+    {
+        std::string name;
+#ifdef __GLIBC__
+        char **const symbols = backtrace_symbols(&frame, 1);
+        if (symbols)
+        {
+            // format is "path/binary(symbol+0x12) [0x4005d0]"
+            name = symbols[0];
+            free(symbols);
+            const size_t start = name.find('(');
+            const size_t end = name.find_first_of("+)", start);
+            if (start != std::string::npos && end != std::string::npos
+                && end > start + 1)
+            {
+                name = name.substr(start + 1, end - start - 1);
+                int status = 0;
+                char *const demangled = abi::__cxa_demangle(
+                    name.c_str(), nullptr, nullptr, &status);
+                if (demangled)
+                {
+                    if (!status)
+                        name = demangled;
+                    free(demangled);
+                }
+            }
+            else
+            {
+                // no symbol, keep binary name and offset
+                const size_t pos = name.find(" [");
+                if (pos != std::string::npos)
+                    name = name.substr(0, pos);
+                const size_t slash = name.rfind('/', start);
+                if (slash != std::string::npos)
+                    name = name.substr(slash + 1);
+            }
+        }
+#endif
+        if (name.empty())
+        {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%p", frame);
+            name = buf;
+        }
+        for (size_t f = 0; f < name.size(); f ++)
+        {
+            if (name[f] == ';' || name[f] == ' ')
+                name[f] = '_';
+        }
+        return name;
+    }
+
+    class CallsiteBytesSorter
+    {
+        public:
+            bool operator() (const int index1, const int index2) const
+            {
+                return callsites[index1].bytes > callsites[index2].bytes;
+            }
+    } callsiteBytesSorter;
+
+    void getSortedCallsites(std::vector<int> &sorted)
+    {
+        lockTable();
+        for (int f = 0; f < CALLSITES; f ++)
+        {
+            if (callsites[f].count)
+                sorted.push_back(f);
+        }
+        unlockTable();
+        std::sort(sorted.begin(), sorted.end(), callsiteBytesSorter);
+    }
+}
+
+volatile bool AllocProfiler::mEnabled = false;
+int AllocProfiler::mInterval = 512 * 1024;
+
+bool AllocProfiler::isAvailable()
+{
+#if !defined(ENABLE_MEM_DEBUG) && !defined(BENCHMARKS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocProfiler::start(const int interval)
+{
+    if (!isAvailable())
+    {
+        logger->log1("Allocation profiler not available: operator new "
+            "is replaced by memory debug or benchmarks build");
+        return;
+    }
+    // only main thread buffers samples, see sample()
+    threadMain = true;
+    if (interval > 0)
+        mInterval = interval;
+    threadCountdown = nextCountdown(mInterval);
+    mEnabled = true;
+    logger->log("Allocation profiler started, interval %d bytes", mInterval);
+}
+
+void AllocProfiler::stop()
+{
+    mEnabled = false;
+    flush();
+    logger->log("Allocation profiler stopped, %d callsites, %u dropped",
+        callsitesCount, droppedSamples);
+}
+
+void AllocProfiler::reset()
+{
+    threadSamplesCount = 0;
+    lockTable();
+    for (int f = 0; f < CALLSITES; f ++)
+        callsites[f].count = 0;
+    callsitesCount = 0;
+    droppedSamples = 0;
+    unlockTable();
+}
+
+int AllocProfiler::getCallsitesCount()
+{
+    return callsitesCount;
+}
+
+void AllocProfiler::sample(const size_t size)
+{
+    if (threadBusy)
+        return;
+
+    threadCountdown -= static_cast<long>(size);
+    if (threadCountdown > 0)
+        return;
+
+    threadBusy = true;
+    const int interval = mInterval;
+    threadCountdown = nextCountdown(interval);
+
+    AllocSample &sample = threadSamples[threadSamplesCount ++];
+    // each sample stands for interval bytes of allocations
+    sample.bytes = size > static_cast<size_t>(interval)
+        ? static_cast<unsigned int>(size) : interval;
+#ifdef __GLIBC__
+    sample.depth = backtrace(sample.frames, MAX_FRAMES);
+#else
+    sample.frames[0] = __builtin_return_address(0);
+    sample.depth = 1;
+#endif
+
+    // other threads can exit any time and lose buffer, so their samples
+    // are merged at once. Samples are rare, so this is cheap.
+    if (threadSamplesCount == THREAD_BUFFER || !threadMain)
+        flush();
+    threadBusy = false;
+}
+
+void AllocProfiler::flush()
+{
+    lockTable();
+    for (int f = 0; f < threadSamplesCount; f ++)
+    {
+        const AllocSample &sample = threadSamples[f];
+        const unsigned int hash = hashFrames(sample.frames, sample.depth);
+        unsigned int idx = hash % CALLSITES;
+        bool stored = false;
+
+        for (int probe = 0; probe < CALLSITES; probe ++)
+        {
+            Callsite &site = callsites[idx];
+            if (!site.count)
+            {
+                // keep load low, long probe chains slow down flush
+                if (callsitesCount >= CALLSITES * 3 / 4)
+                    break;
+                std::copy(sample.frames, sample.frames + sample.depth,
+                    site.frames);
+                site.depth = sample.depth;
+                site.hash = hash;
+                site.count = 1;
+                site.bytes = sample.bytes;
+                callsitesCount ++;
+                stored = true;
+                break;
+            }
+            if (site.hash == hash && site.depth == sample.depth
+                && std::equal(sample.frames, sample.frames + sample.depth,
+                site.frames))
+            {
+                site.count ++;
+                site.bytes += sample.bytes;
+                stored = true;
+                break;
+            }
+            idx = (idx + 1) % CALLSITES;
+        }
+        if (!stored)
+            droppedSamples ++;
+    }
+    unlockTable();
+    threadSamplesCount = 0;
+}
+
+bool AllocProfiler::dumpReport(const std::string &fileName, const int top)
+{
+    threadBusy = true;
+    flush();
+
+    std::vector<int> sorted;
+    getSortedCallsites(sorted);
+
+    std::ofstream file(fileName.c_str(), std::ios::out);
+    if (!file.is_open())
+    {
+        threadBusy = false;
+        return false;
+    }
+
+    unsigned long long total = 0;
+    for (std::vector<int>::const_iterator it = sorted.begin(),
+         it_end = sorted.end(); it != it_end; ++ it)
+    {
+        total += callsites[*it].bytes;
+    }
+
+    file << "# sampling interval " << mInterval << " bytes, "
+        << sorted.size() << " callsites, " << droppedSamples
+        << " dropped samples, estimated " << total << " bytes" << std::endl;
+
+    int num = 0;
+    for (std::vector<int>::const_iterator it = sorted.begin(),
+         it_end = sorted.end(); it != it_end && num < top; ++ it, ++ num)
+    {
+        const Callsite &site = callsites[*it];
+        file << std::endl << site.bytes << " bytes, " << site.count
+            << " samples" << std::endl;
+        for (int f = SKIP_FRAMES; f < site.depth; f ++)
+            file << "    " << frameName(site.frames[f]) << std::endl;
+    }
+    threadBusy = false;
+    return true;
+}
+
+bool AllocProfiler::dumpFolded(const std::string &fileName)
+{
+    threadBusy = true;
+    flush();
+
+    std::vector<int> sorted;
+    getSortedCallsites(sorted);
+
+    std::ofstream file(fileName.c_str(), std::ios::out);
+    if (!file.is_open())
+    {
+        threadBusy = false;
+        return false;
+    }
+
+    for (std::vector<int>::const_iterator it = sorted.begin(),
+         it_end = sorted.end(); it != it_end; ++ it)
+    {
+        const Callsite &site = callsites[*it];
+        // root frame first
+        for (int f = site.depth - 1; f >= SKIP_FRAMES; f --)
+        {
+            file << frameName(site.frames[f]);
+            if (f > SKIP_FRAMES)
+                file << ";";
+        }
+        file << " " << site.bytes << std::endl;
+    }
+    threadBusy = false;
+    return true;
+}
+
+// benchmarks and memory debug replace operator new too
+#if !defined(ENABLE_MEM_DEBUG) && !defined(BENCHMARKS)
+void *operator new(size_t size)
+{
+    void *const ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    if (AllocProfiler::isEnabled())
+        AllocProfiler::sample(size);
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    void *const ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    if (AllocProfiler::isEnabled())
+        AllocProfiler::sample(size);
+    return ptr;
+}
+
+void operator delete(void *ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) throw()
+{
+    free(ptr);
+}
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCPROFILER_H
+#define ALLOCPROFILER_H
+
+#ifdef ENABLE_ALLOC_PROFILER
+
+#include <string>
+
+#include <stddef.h>
+
+/**
+ * Sampling allocation profiler. Global operator new records call stack of
+ * about one allocation per sampling interval bytes. Samples are buffered
+ * per thread and merged into fixed callsite table, so profiling can run in
+ * normal game sessions.
+ */
+class AllocProfiler
+{
+    public:
+        /**
+         * Starts sampling. Interval is average bytes between samples.
+         * Must be called from main thread.
+         */
+        static void start(const int interval);
+
+        static void stop();
+
+        /**
+         * Forgets all collected callsites.
+         */
+        static void reset();
+
+        static bool isEnabled()
+        { return mEnabled; }
+
+        /**
+         * Returns false if operator new hook is compiled out, because
+         * memory debug or benchmarks replace it.
+         */
+        static bool isAvailable();
+
+        /**
+         * Writes top callsites by allocated bytes.
+         */
+        static bool dumpReport(const std::string &fileName, const int top);
+
+        /**
+         * Writes callsites in folded stacks format for flamegraph.pl.
+         */
+        static bool dumpFolded(const std::string &fileName);
+
+        static void sample(const size_t size);
+
+        static int getCallsitesCount();
+
+    private:
+        static void flush();
+
+        static volatile bool mEnabled;
+        static int mInterval;
+};
+
+#endif
+
+#endif
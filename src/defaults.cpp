@@ -151,6 +151,8 @@ DefaultsData* getConfigDefaults()
     AddDEF(configData, "playGuiSound", true);
     AddDEF(configData, "playMusic", true);
     AddDEF(configData, "packetcounters", true);
+    AddDEF(configData, "loadStats", false);
+    AddDEF(configData, "batchStatEvents", true);
     AddDEF(configData, "safemode", false);
     AddDEF(configData, "font", "fonts/dejavusans.ttf");
     AddDEF(configData, "boldFont", "fonts/dejavusans-bold.ttf");
@@ -213,6 +215,11 @@ DefaultsData* getConfigDefaults()
     AddDEF(configData, "adjustPerfomance", true);
     AddDEF(configData, "enableAlphaFix", false);
     AddDEF(configData, "disableAdvBeingCaching", false);
+    AddDEF(configData, "compoundCacheSize", 16);
+    AddDEF(configData, "mapChunkCache", true);
+    AddDEF(configData, "mapChunkCacheSize", 32);
+    AddDEF(configData, "prefetchMaps", true);
+    AddDEF(configData, "prefetchWarpDistance", 8);
     AddDEF(configData, "disableBeingCaching", false);
     AddDEF(configData, "enableReorderSprites", true);
     AddDEF(configData, "showip", false);
@@ -260,6 +267,16 @@ DefaultsData* getConfigDefaults()
     AddDEF(configData, "videodetected", false);
     AddDEF(configData, "hideErased", false);
     AddDEF(configData, "enableDelayedAnimations", true);
+    AddDEF(configData, "delayedLoadBudget", 2);
+    AddDEF(configData, "useContentPack", true);
+    AddDEF(configData, "compressContentPack", false);
+    AddDEF(configData, "textureUploadBudget", 2048);
+    AddDEF(configData, "npotTextures", true);
+    AddDEF(configData, "useAtlases", true);
+    AddDEF(configData, "atlasPageSize", 1024);
+    AddDEF(configData, "atlasImageSize", 64);
+    AddDEF(configData, "textureBudget", 256);
+    AddDEF(configData, "simdBlit", true);
     AddDEF(configData, "enableCompoundSpriteDelay", true);
     AddDEF(configData, "npcfontSize", 13);
     return configData;
@@ -22,126 +22,149 @@
 #include "depricatedevent.h"
 
 #include "listener.h"
-#include "variabledata.h"
+
+#include <algorithm>
 
 #include "debug.h"
 
-ListenMap DepricatedEvent::mBindings;
+Listeners DepricatedEvent::mBindings[CHANNELS_SIZE];
+EventQueue DepricatedEvent::mQueue;
+EventQueue DepricatedEvent::mDelivering;
+int DepricatedEvent::mTriggerDepth = 0;
+bool DepricatedEvent::mRemoved = false;
+bool DepricatedEvent::mBatching = false;
 
-DepricatedEvent::~DepricatedEvent()
+void DepricatedEvent::trigger(Channels channel, const DepricatedEvent &event)
 {
-    VariableMap::iterator it = mData.begin();
-    while (it != mData.end())
+    const Listeners &listeners = mBindings[channel];
+
+    // Listeners removed while triggering are set to null and erased later,
+    // so indexes stay valid.
+    mTriggerDepth ++;
+    for (size_t f = 0; f < listeners.size(); f ++)
     {
-        delete it->second;
-        it->second = nullptr;
-        ++it;
+        Listener *const listener = listeners[f];
+        if (listener)
+            listener->processEvent(channel, event);
     }
-}
-
-void DepricatedEvent::setInt(const std::string &key, int value)
-                             throw (BadDepricatedEvent)
-{
-    if (mData.find(key) != mData.end())
-        throw KEY_ALREADY_EXISTS;
+    mTriggerDepth --;
 
-    mData[key] = new IntData(value);
+    if (!mTriggerDepth && mRemoved)
+        compact();
 }
 
-int DepricatedEvent::getInt(const std::string &key) const
-                            throw (BadDepricatedEvent)
+void DepricatedEvent::queue(Channels channel, const DepricatedEvent &event)
 {
-    VariableMap::const_iterator it = mData.find(key);
-    if (it == mData.end())
-        throw BAD_KEY;
-
-    if (!it->second || it->second->getType() != VariableData::DATA_INT)
-        throw BAD_VALUE;
+    if (!mBatching)
+    {
+        trigger(channel, event);
+        return;
+    }
 
-    return static_cast<IntData *>(it->second)->getData();
+    switch (event.getName())
+    {
+        case EVENT_UPDATEATTRIBUTE:
+        case EVENT_UPDATESTAT:
+            if (!merge(channel, event))
+                mQueue.push_back(std::make_pair(channel, event));
+            break;
+        default:
+            trigger(channel, event);
+            break;
+    }
 }
 
-void DepricatedEvent::setString(const std::string &key,
-                                const std::string &value)
-                                throw (BadDepricatedEvent)
+bool DepricatedEvent::merge(const Channels channel,
+                            const DepricatedEvent &event)
 {
-    if (mData.find(key) != mData.end())
-        throw KEY_ALREADY_EXISTS;
-
-    mData[key] = new StringData(value);
+    for (EventQueue::iterator it = mQueue.begin(), it_end = mQueue.end();
+         it != it_end; ++ it)
+    {
+        DepricatedEvent &queued = it->second;
+        if (it->first != channel || queued.getName() != event.getName())
+            continue;
+
+        // keep old values from first event and new values from last one
+        if (event.getName() == EVENT_UPDATEATTRIBUTE)
+        {
+            if (queued.attribute().id != event.attribute().id)
+                continue;
+            queued.attribute().newValue = event.attribute().newValue;
+            return true;
+        }
+        else
+        {
+            StatEventData &stat = queued.stat();
+            const StatEventData &newStat = event.stat();
+            if (stat.id != newStat.id || stat.changed != newStat.changed)
+                continue;
+            stat.base = newStat.base;
+            stat.mod = newStat.mod;
+            stat.exp = newStat.exp;
+            stat.expNeeded = newStat.expNeeded;
+            return true;
+        }
+    }
+    return false;
 }
 
-const std::string &DepricatedEvent::getString(const std::string &key)
-                                    const throw (BadDepricatedEvent)
+void DepricatedEvent::deliverQueued()
 {
-    VariableMap::const_iterator it = mData.find(key);
-    if (it == mData.end())
-        throw BAD_KEY;
-
-    if (!it->second || it->second->getType() != VariableData::DATA_STRING)
-        throw BAD_VALUE;
+    if (mQueue.empty())
+        return;
 
-    return static_cast<StringData *>(it->second)->getData();
+    // listeners can queue new events, they are sent on next call
+    mDelivering.swap(mQueue);
+    for (EventQueue::const_iterator it = mDelivering.begin(),
+         it_end = mDelivering.end(); it != it_end; ++ it)
+    {
+        trigger(it->first, it->second);
+    }
+    mDelivering.clear();
 }
 
-
-void DepricatedEvent::setFloat(const std::string &key, double value)
-                               throw (BadDepricatedEvent)
+void DepricatedEvent::remove(Listener *listener)
 {
-    if (mData.find(key) != mData.end())
-        throw KEY_ALREADY_EXISTS;
-
-    mData[key] = new FloatData(value);
+    for (int f = 0; f < CHANNELS_SIZE; f ++)
+        unbind(listener, static_cast<Channels>(f));
 }
 
-double DepricatedEvent::getFloat(const std::string &key) const
-                                 throw (BadDepricatedEvent)
+void DepricatedEvent::bind(Listener *listener, Channels channel)
 {
-    VariableMap::const_iterator it = mData.find(key);
-    if (it == mData.end())
-        throw BAD_KEY;
-
-    if (!it->second || it->second->getType() != VariableData::DATA_FLOAT)
-        throw BAD_VALUE;
-
-    return static_cast<FloatData *>(it->second)->getData();
+    Listeners &listeners = mBindings[channel];
+    if (std::find(listeners.begin(), listeners.end(), listener)
+        == listeners.end())
+    {
+        listeners.push_back(listener);
+    }
 }
 
-void DepricatedEvent::trigger(Channels channel, const DepricatedEvent &event)
+void DepricatedEvent::unbind(Listener *listener, Channels channel)
 {
-    ListenMap::const_iterator it = mBindings.find(channel);
-
-    // Make sure something is listening
-    if (it == mBindings.end())
+    Listeners &listeners = mBindings[channel];
+    Listeners::iterator it = std::find(listeners.begin(),
+        listeners.end(), listener);
+    if (it == listeners.end())
         return;
 
-    // Loop though all listeners
-    ListenerSet::const_iterator lit = it->second.begin();
-    ListenerSet::const_iterator lit_end = it->second.end();
-    while (lit != lit_end)
+    if (mTriggerDepth)
     {
-        if (*lit)
-            (*lit)->processEvent(channel, event);
-        ++lit;
+        *it = nullptr;
+        mRemoved = true;
     }
-}
-
-void DepricatedEvent::remove(Listener *listener)
-{
-    ListenMap::iterator it = mBindings.begin();
-    while (it != mBindings.end())
+    else
     {
-        it->second.erase(listener);
-        ++it;
+        listeners.erase(it);
     }
 }
 
-void DepricatedEvent::bind(Listener *listener, Channels channel)
-{
-    mBindings[channel].insert(listener);
-}
-
-void DepricatedEvent::unbind(Listener *listener, Channels channel)
+void DepricatedEvent::compact()
 {
-    mBindings[channel].erase(listener);
+    for (int f = 0; f < CHANNELS_SIZE; f ++)
+    {
+        Listeners &listeners = mBindings[f];
+        listeners.erase(std::remove(listeners.begin(), listeners.end(),
+            static_cast<Listener*>(nullptr)), listeners.end());
+    }
+    mRemoved = false;
 }
@@ -22,9 +22,8 @@
 #ifndef DEPRICATED_EVENT_H
 #define DEPRICATED_EVENT_H
 
-#include <map>
-#include <set>
 #include <string>
+#include <vector>
 
 enum Channels
 {
@@ -38,7 +37,8 @@ enum Channels
     CHANNEL_NOTICES,
     CHANNEL_NPC,
     CHANNEL_STATUS,
-    CHANNEL_STORAGE
+    CHANNEL_STORAGE,
+    CHANNELS_SIZE
 };
 
 enum DepricatedEvents
@@ -95,64 +95,134 @@ enum DepricatedEvents
     EVENT_WHISPERERROR
 };
 
-// Possible exception that can be thrown
-enum BadDepricatedEvent
+/**
+ * Payload of EVENT_UPDATEATTRIBUTE.
+ */
+struct AttributeEventData
+{
+    int id;
+    int oldValue;
+    int newValue;
+};
+
+/**
+ * Payload of EVENT_UPDATESTAT. Meaning of old values depends on changed
+ * field: old base, old mod, or old exp and old exp needed.
+ */
+struct StatEventData
 {
-    BAD_KEY = 0,
-    BAD_VALUE,
-    KEY_ALREADY_EXISTS
+    enum
+    {
+        BASE = 0,
+        MOD,
+        EXP
+    };
+
+    int id;
+    int changed;
+    int base;
+    int mod;
+    int exp;
+    int expNeeded;
+    int oldValue1;
+    int oldValue2;
 };
 
+/**
+ * Payload of EVENT_STATECHANGE.
+ */
+struct StateEventData
+{
+    int oldState;
+    int newState;
+};
+
+/**
+ * Payload of EVENT_TRADING.
+ */
+struct TradingEventData
+{
+    bool trading;
+};
+
+/**
+ * Payload of text events (EVENT_SERVERNOTICE, EVENT_MAPLOADED).
+ * Text must live while event is triggered, so text events can't be queued.
+ */
+struct TextEventData
+{
+    const std::string *text;
+};
+
+class DepricatedEvent;
 class Listener;
-class VariableData;
-typedef std::map<std::string, VariableData *> VariableMap;
 
-typedef std::set<Listener *> ListenerSet;
-typedef std::map<Channels, ListenerSet > ListenMap;
+typedef std::vector<Listener*> Listeners;
+typedef std::vector<std::pair<Channels, DepricatedEvent> > EventQueue;
 
 #define SERVER_NOTICE(message) { \
+const std::string eventText(message); \
 DepricatedEvent event(EVENT_SERVERNOTICE); \
-event.setString("message", message); \
+event.text().text = &eventText; \
 DepricatedEvent::trigger(CHANNEL_NOTICES, event); }
 
 class DepricatedEvent
 {
     public:
-        // String passed can be retivered with getName()
-        // and is to used to identify what type of event
-        // this is.
-        DepricatedEvent(DepricatedEvents name) : mDepricatedEventName(name)
+        // Event name is used to identify what type of event this is,
+        // and what payload it has.
+        DepricatedEvent(DepricatedEvents name) :
+            mDepricatedEventName(name),
+            mData()
         { }
 
-        ~DepricatedEvent();
-
         DepricatedEvents getName() const
         { return mDepricatedEventName; }
 
-        // Sets or gets a interger with a key to identify
-        void setInt(const std::string &key, int value)
-        throw (BadDepricatedEvent);
+        AttributeEventData &attribute()
+        { return mData.attribute; }
+
+        const AttributeEventData &attribute() const
+        { return mData.attribute; }
+
+        StatEventData &stat()
+        { return mData.stat; }
+
+        const StatEventData &stat() const
+        { return mData.stat; }
 
-        int getInt(const std::string &key)
-        const throw (BadDepricatedEvent);
+        StateEventData &state()
+        { return mData.state; }
 
-        // Sets or gets a string with a key to identify
-        void setString(const std::string &key,
-                       const std::string &value)
-        throw (BadDepricatedEvent);
+        const StateEventData &state() const
+        { return mData.state; }
 
-        const std::string &getString(const std::string &key)
-        const throw (BadDepricatedEvent);
+        TradingEventData &trading()
+        { return mData.trading; }
 
-        // Sets or gets a floating point number with key to identify
-        void setFloat(const std::string &key, double value)
-        throw (BadDepricatedEvent);
-        double getFloat(const std::string &key)
-        const throw (BadDepricatedEvent);
+        const TradingEventData &trading() const
+        { return mData.trading; }
+
+        TextEventData &text()
+        { return mData.text; }
+
+        const TextEventData &text() const
+        { return mData.text; }
 
         // Sends event to all listener on the channel
         static void trigger(Channels channel, const DepricatedEvent &event);
 
+        // Sends attribute and stat events at next deliverQueued call, if
+        // batching is enabled. Events for same attribute or stat are merged.
+        // Other events are sent at once.
+        static void queue(Channels channel, const DepricatedEvent &event);
+
+        // Sends queued events, called once per logic tick
+        static void deliverQueued();
+
+        static void setBatching(bool batching)
+        { mBatching = batching; }
+
         // Removes a listener from all channels
         static void remove(Listener *listener);
 
@@ -161,11 +231,28 @@ class DepricatedEvent
         static void unbind(Listener *listener, Channels channel);
 
     private:
+        static bool merge(const Channels channel,
+                          const DepricatedEvent &event);
+
+        static void compact();
+
         DepricatedEvents mDepricatedEventName;
 
-        static ListenMap mBindings;
+        union
+        {
+            StatEventData stat;
+            AttributeEventData attribute;
+            StateEventData state;
+            TradingEventData trading;
+            TextEventData text;
+        } mData;
 
-        VariableMap mData;
+        static Listeners mBindings[CHANNELS_SIZE];
+        static EventQueue mQueue;
+        static EventQueue mDelivering;
+        static int mTriggerDepth;
+        static bool mRemoved;
+        static bool mBatching;
 };
 
 #endif
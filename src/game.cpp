@@ -26,6 +26,7 @@
 #include "animatedsprite.h"
 #include "channelmanager.h"
 #include "commandhandler.h"
+#include "compoundsprite.h"
 #include "effectmanager.h"
 #include "emoteshortcut.h"
 #include "guildmanager.h"
@@ -80,14 +81,21 @@
 #include "net/packetcounters.h"
 #include "net/playerhandler.h"
 
+#include "resources/imagestreamer.h"
 #include "resources/imagewriter.h"
 #include "resources/mapdb.h"
+#include "resources/mapprefetcher.h"
 #include "resources/mapreader.h"
 #include "resources/resourcemanager.h"
 
+#include "test/loadstats.h"
+
 #include "utils/dtor.h"
+#include "utils/framepacer.h"
 #include "utils/gettext.h"
 #include "utils/mkdir.h"
+#include "utils/objectpool.h"
+#include "utils/profiler.h"
 
 #include "utils/translation/translationmanager.h"
 
@@ -458,6 +466,10 @@ Game::~Game()
     del_0(mumbleManager)
 
     Being::clearCache();
+    CompoundSprite::clearCache();
+    MapPrefetcher::clear();
+    ImageStreamer::unload();
+    ObjectPool::logStats();
 
     mInstance = nullptr;
 
@@ -543,16 +555,24 @@ bool Game::saveScreenshot()
 
 void Game::logic()
 {
+    PROFILER_SCOPE(ZONE_GAME_LOGIC);
     handleInput();
 
     // Handle all necessary game logic
+    PROFILER_BEGIN(ZONE_ACTORS);
     ActorSprite::actorLogic();
     if (actorSpriteManager)
         actorSpriteManager->logic();
+    PROFILER_END(ZONE_ACTORS);
+    PROFILER_BEGIN(ZONE_PARTICLES);
     if (particleEngine)
         particleEngine->update();
+    PROFILER_END(ZONE_PARTICLES);
     if (mCurrentMap)
+    {
         mCurrentMap->update();
+        MapPrefetcher::logic(mCurrentMap);
+    }
 
     cur_time = static_cast<int>(time(nullptr));
 }
@@ -578,7 +598,11 @@ void Game::slowLogic()
     if (shopWindow)
         shopWindow->updateTimes();
     if (mainGraphics->getOpenGL())
+    {
+        ImageStreamer::logic();
         ResourceManager::delayedLoad();
+        ResourceManager::checkTextureBudget();
+    }
     PacketCounters::update();
 
     // Handle network stuff
@@ -893,6 +917,7 @@ void Game::handleActive(SDL_Event &event)
  */
 void Game::handleInput()
 {
+    PROFILER_SCOPE(ZONE_INPUT);
     if (joystick)
         joystick->logic();
 
@@ -900,6 +925,9 @@ void Game::handleInput()
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
+        FramePacer::inputReceived();
+        if (event.type == SDL_KEYDOWN || event.type == SDL_MOUSEBUTTONDOWN)
+            LoadStats::input();
         updateHistory(event);
         checkKeys();
 
@@ -950,6 +978,8 @@ void Game::changeMap(const std::string &mapPath)
     // Clean up floor items, beings and particles
     if (actorSpriteManager)
         actorSpriteManager->clear();
+    // Composed frames depend on map tile size
+    CompoundSprite::clearCache();
 
     // Close the popup menu on map change so that invalid options can't be
     // executed.
@@ -1032,10 +1062,13 @@ void Game::changeMap(const std::string &mapPath)
     mCurrentMap = newMap;
 //    mCurrentMap = 0;
 
+    // new map holds own references to prefetched resources
+    MapPrefetcher::release();
+
     if (mumbleManager)
         mumbleManager->setMap(mapPath);
     DepricatedEvent event(EVENT_MAPLOADED);
-    event.setString("mapPath", mapPath);
+    event.text().text = &mapPath;
     DepricatedEvent::trigger(CHANNEL_GAME, event);
 }
 
@@ -29,9 +29,11 @@
 #include "graphicsvertexes.h"
 #include "logger.h"
 
+#include "resources/atlasmanager.h"
 #include "resources/image.h"
 #include "resources/imagehelper.h"
 #include "resources/openglimagehelper.h"
+#include "utils/blitkernels.h"
 #include "utils/stringutils.h"
 
 #include <guichan/sdl/sdlpixel.hpp>
@@ -56,10 +58,6 @@
 #endif
 #endif
 
-static unsigned int *cR = nullptr;
-static unsigned int *cG = nullptr;
-static unsigned int *cB = nullptr;
-
 Graphics::Graphics() :
     mWidth(0),
     mHeight(0),
@@ -73,8 +71,6 @@ Graphics::Graphics() :
     mOpenGL(0),
     mEnableResize(false),
     mNoFrame(false),
-    mOldPixel(0),
-    mOldAlpha(0),
     mName("Software"),
     mStartFreeMem(0),
     mSync(false)
@@ -198,7 +194,14 @@ bool Graphics::setOpenGLMode()
         OpenGLImageHelper::mTextureSize = texSize;
         logger->log("OpenGL texture size: %d pixels",
             OpenGLImageHelper::mTextureSize);
+        const bool npot = config.getBoolValue("npotTextures")
+            && graphicsManager.supportExtension(
+            "GL_ARB_texture_non_power_of_two");
+        if (npot)
+            logger->log1("using GL_ARB_texture_non_power_of_two");
+        OpenGLImageHelper::setNpotTextures(npot);
     }
+    AtlasManager::init();
     return videoInfo();
 #else
     return false;
@@ -410,8 +413,8 @@ bool Graphics::drawRescaledImage(Image *image, int srcX, int srcY,
     srcRect.w = static_cast<uint16_t>(width);
     srcRect.h = static_cast<uint16_t>(height);
 
-    returnValue = !(SDL_BlitSurface(tmpImage->mSDLSurface,
-        &srcRect, mTarget, &dstRect) < 0);
+    returnValue = !(blitSurface(tmpImage->mSDLSurface,
+        &srcRect, &dstRect, image->mAlpha) < 0);
 
     delete tmpImage;
 
@@ -442,8 +445,8 @@ bool Graphics::drawImage(const Image *image, int srcX, int srcY,
 
     if (mBlitMode == BLIT_NORMAL)
     {
-        return !(SDL_BlitSurface(image->mSDLSurface, &srcRect,
-                                 mTarget, &dstRect) < 0);
+        return !(blitSurface(image->mSDLSurface, &srcRect,
+                             &dstRect, image->mAlpha) < 0);
     }
     else
     {
@@ -487,7 +490,7 @@ void Graphics::drawImagePattern(const Image *image, int x, int y, int w, int h)
             srcRect.w = static_cast<uint16_t>(dw);
             srcRect.h = static_cast<uint16_t>(dh);
 
-            SDL_BlitSurface(image->mSDLSurface, &srcRect, mTarget, &dstRect);
+            blitSurface(image->mSDLSurface, &srcRect, &dstRect, image->mAlpha);
         }
     }
 }
@@ -536,8 +539,8 @@ void Graphics::drawRescaledImagePattern(Image *image, int x, int y,
             srcRect.w = static_cast<uint16_t>(dw);
             srcRect.h = static_cast<uint16_t>(dh);
 
-            SDL_BlitSurface(tmpImage->mSDLSurface, &srcRect,
-                            mTarget, &dstRect);
+            blitSurface(tmpImage->mSDLSurface, &srcRect,
+                        &dstRect, image->mAlpha);
         }
     }
 
@@ -655,6 +658,18 @@ void Graphics::drawImagePattern2(GraphicsVertexes *vert, const Image *img)
 
     std::vector<DoubleRect*> *arr = vert->getRectsSDL();
 
+    if (BlitKernels::canBlend(img->mSDLSurface, mTarget))
+    {
+        const int alpha = BlitKernels::alphaFromFloat(img->mAlpha);
+        for (std::vector<DoubleRect*>::const_iterator it = arr->begin(),
+             it_end = arr->end(); it != it_end; ++it)
+        {
+            BlitKernels::blend(img->mSDLSurface, &(*it)->src,
+                mTarget, &(*it)->dst, alpha);
+        }
+        return;
+    }
+
     for (std::vector<DoubleRect*>::const_iterator it = arr->begin(),
          it_end = arr->end(); it != it_end; ++it)
     {
@@ -809,6 +824,17 @@ void Graphics::drawTile(ImageVertexes *vert)
     DoubleRects *rects = &vert->sdl;
     DoubleRects::const_iterator it = rects->begin();
     DoubleRects::const_iterator it_end = rects->end();
+    if (BlitKernels::canBlend(img->mSDLSurface, mTarget))
+    {
+        const int alpha = BlitKernels::alphaFromFloat(img->mAlpha);
+        while (it != it_end)
+        {
+            BlitKernels::blend(img->mSDLSurface, &(*it)->src,
+                mTarget, &(*it)->dst, alpha);
+            ++ it;
+        }
+        return;
+    }
     while (it != it_end)
     {
         SDL_LowerBlit(img->mSDLSurface, &(*it)->src, mTarget, &(*it)->dst);
@@ -872,6 +898,22 @@ bool Graphics::calcWindow(GraphicsVertexes* vert,
         imgRect.grid[4]);
 }
 
+int Graphics::blitSurface(SDL_Surface *const src, SDL_Rect *const srcRect,
+                          SDL_Rect *const dstRect, const float alpha)
+{
+    if (!BlitKernels::canBlend(src, mTarget))
+        return SDL_BlitSurface(src, srcRect, mTarget, dstRect);
+
+    const int res = SDL_FakeUpperBlit(src, srcRect, mTarget, dstRect);
+    if (res == 1)
+    {
+        BlitKernels::blend(src, srcRect, mTarget, dstRect,
+            BlitKernels::alphaFromFloat(alpha));
+        return 0;
+    }
+    return res;
+}
+
 int Graphics::SDL_FakeUpperBlit(SDL_Surface *src, SDL_Rect *srcrect,
                                 SDL_Surface *dst, SDL_Rect *dstrect)
 {
@@ -1055,61 +1097,14 @@ void Graphics::fillRectangle(const gcn::Rectangle& rectangle)
                 break;
             }
             case 4:
-            {
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-                const unsigned pb = (pixel & 0xff) * mColor.a;
-                const unsigned pg = (pixel & 0xff00) * mColor.a;
-                const unsigned pr = (pixel & 0xff0000) * mColor.a;
-                const unsigned a1 = (255 - mColor.a);
-
-                for (y = y1; y < y2; y++)
+                // kernels need rgb in low 24 bits, on any byte order
+                if (BlitKernels::canFill(mTarget))
                 {
-                    uint8_t *p0 = static_cast<uint8_t *>(mTarget->pixels)
-                        + y * mTarget->pitch;
-                    for (x = x1; x < x2; x++)
-                    {
-                        uint8_t *p = p0 + x * 4;
-                        uint32_t dst = *reinterpret_cast<uint32_t *>(p);
-                        const unsigned int b = (pb + (dst & 0xff) * a1) >> 8;
-                        const unsigned int g = (pg + (dst & 0xff00) * a1) >> 8;
-                        const unsigned int r = (pr
-                            + (dst & 0xff0000) * a1) >> 8;
-
-                        *reinterpret_cast<uint32_t *>(p) = ((b & 0xff)
-                            | (g & 0xff00) | (r & 0xff0000));
-                    }
+                    BlitKernels::fill(mTarget, x1, y1, x2, y2,
+                        pixel, BlitKernels::alphaFromByte(mColor.a));
+                    break;
                 }
-#else
-                if (!cR)
-                {
-                    cR = new unsigned int[0x100];
-                    cG = new unsigned int[0x100];
-                    cB = new unsigned int[0x100];
-                    mOldPixel = 0;
-                    mOldAlpha = mColor.a;
-                }
-
-                if (pixel != mOldPixel || mColor.a != mOldAlpha)
-                {
-                    const unsigned pb = (pixel & 0xff) * mColor.a;
-                    const unsigned pg = (pixel & 0xff00) * mColor.a;
-                    const unsigned pr = (pixel & 0xff0000) * mColor.a;
-                    const unsigned a1 = (255 - mColor.a);
-
-                    const unsigned int a2 = a1 * 0xff;
-                    const unsigned int a3 = a1 * 0xff00;
-
-                    for (int f = 0; f <= 0xff; f ++)
-                    {
-                        cB[f] = ((pb + f * a1) >> 8) & 0xff;
-                        cG[f] = ((pg + f * a2) >> 8) & 0xff00;
-                        cR[f] = ((pr + f * a3) >> 8) & 0xff0000;
-                    }
-
-                    mOldPixel = pixel;
-                    mOldAlpha = mColor.a;
-                }
-
+                // other channel layouts
                 for (y = y1; y < y2; y++)
                 {
                     uint32_t *p0 = reinterpret_cast<uint32_t*>(
@@ -1118,14 +1113,10 @@ void Graphics::fillRectangle(const gcn::Rectangle& rectangle)
                     for (x = x1; x < x2; x++)
                     {
                         uint32_t *p = p0 + x;
-                        const uint32_t dst = *p;
-                        *p = cB[dst & 0xff] | cG[(dst & 0xff00) >> 8]
-                            | cR[(dst & 0xff0000) >> 16];
+                        *p = gcn::SDLAlpha32(pixel, *p, mColor.a);
                     }
                 }
-#endif
                 break;
-            }
             default:
                 break;
         }
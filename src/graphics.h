@@ -322,6 +322,13 @@ class Graphics : public gcn::SDLGraphics
         int SDL_FakeUpperBlit(SDL_Surface *src, SDL_Rect *srcrect,
                               SDL_Surface *dst, SDL_Rect *dstrect);
 
+        /**
+         * Blits surface to target. 32 bit surfaces with alpha channel are
+         * blended with alpha by blit kernels, others by SDL.
+         */
+        int blitSurface(SDL_Surface *const src, SDL_Rect *const srcRect,
+                        SDL_Rect *const dstRect, const float alpha);
+
         int mBpp;
         bool mFullscreen;
         bool mHWAccel;
@@ -333,8 +340,6 @@ class Graphics : public gcn::SDLGraphics
         int mOpenGL;
         bool mEnableResize;
         bool mNoFrame;
-        uint32_t mOldPixel;
-        int mOldAlpha;
         std::string mName;
         int mStartFreeMem;
         bool mSync;
@@ -26,6 +26,9 @@
 
 #include "debug.h"
 
+IMPLEMENT_POOLED_OBJECT(DoubleRect, "DoubleRect", 1024)
+IMPLEMENT_POOLED_OBJECT(ImageVertexes, "ImageVertexes", 256)
+
 #ifdef USE_OPENGL
 int GraphicsVertexes::mUseOpenGL = 0;
 const unsigned int vertexBufSize = 500;
@@ -27,6 +27,8 @@
 #include "graphics.h"
 #include "localconsts.h"
 
+#include "utils/objectpool.h"
+
 #ifdef USE_OPENGL
 //#define NO_SDL_GLEXT
 #define GL_GLEXT_PROTOTYPES 1
@@ -46,6 +48,8 @@
 
 struct DoubleRect
 {
+    DECLARE_POOLED_OBJECT
+
     SDL_Rect src;
     SDL_Rect dst;
 };
@@ -122,6 +126,8 @@ typedef std::vector<DoubleRect*> DoubleRects;
 
 class ImageVertexes
 {
+    DECLARE_POOLED_OBJECT
+
     public:
         ImageVertexes();
 
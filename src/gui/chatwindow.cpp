@@ -921,7 +921,7 @@ void ChatWindow::processEvent(Channels channel, const DepricatedEvent &event)
     if (channel == CHANNEL_NOTICES)
     {
         if (event.getName() == EVENT_SERVERNOTICE && localChatTab)
-            localChatTab->chatLog(event.getString("message"), BY_SERVER);
+            localChatTab->chatLog(*event.text().text, BY_SERVER);
     }
     else if (channel == CHANNEL_ATTRIBUTES)
     {
@@ -930,15 +930,15 @@ void ChatWindow::processEvent(Channels channel, const DepricatedEvent &event)
 
         if (event.getName() == EVENT_UPDATEATTRIBUTE)
         {
-            switch (event.getInt("id"))
+            switch (event.attribute().id)
             {
                 case EXP:
                 {
-                    if (event.getInt("oldValue") > event.getInt("newValue"))
+                    if (event.attribute().oldValue > event.attribute().newValue)
                         break;
 
-                    int change = event.getInt("newValue")
-                                 - event.getInt("oldValue");
+                    int change = event.attribute().newValue
+                                 - event.attribute().oldValue;
 
                     if (change != 0)
                         battleChatLog("+" + toString(change) + " xp");
@@ -946,7 +946,7 @@ void ChatWindow::processEvent(Channels channel, const DepricatedEvent &event)
                 }
                 case LEVEL:
                     battleChatLog("Level: " + toString(
-                        event.getInt("newValue")));
+                        event.attribute().newValue));
                     break;
                 default:
                     break;
@@ -957,18 +957,18 @@ void ChatWindow::processEvent(Channels channel, const DepricatedEvent &event)
             if (!config.getBoolValue("showJobExp"))
                 return;
 
-            int id = event.getInt("id");
+            int id = event.stat().id;
             if (id == Net::getPlayerHandler()->getJobLocation())
             {
                 std::pair<int, int> exp
                     = PlayerInfo::getStatExperience(id);
-                if (event.getInt("oldValue1") > exp.first
-                    || !event.getInt("oldValue2"))
+                if (event.stat().oldValue1 > exp.first
+                    || !event.stat().oldValue2)
                 {
                     return;
                 }
 
-                int change = exp.first - event.getInt("oldValue1");
+                int change = exp.first - event.stat().oldValue1;
                 if (change != 0)
                     battleChatLog("+" + toString(change) + " job");
             }
@@ -1379,7 +1379,7 @@ void ChatWindow::resortChatLog(std::string line, Own own,
 
     if (tradeChatTab)
     {
-        if (findI(line, mTradeFilter) != std::string::npos)
+        if (mTradeFilter.find(line))
         {
 //            logger->log("trade: " + line);
             tradeChatTab->chatLog(line, own, ignoreRecord, tryRemoveColors);
@@ -1444,11 +1444,12 @@ void ChatWindow::initTradeFilter()
             {
                 std::string str = line;
                 if (!str.empty())
-                    mTradeFilter.push_back(str);
+                    mTradeFilter.add(str);
             }
         }
         tradeFile.close();
     }
+    mTradeFilter.build();
 }
 
 void ChatWindow::updateOnline(std::set<std::string> &onlinePlayers)
@@ -1611,7 +1612,7 @@ void ChatWindow::addToAwayLog(std::string line)
     if (mAwayLog.size() > 20)
         mAwayLog.pop_front();
 
-    if (findI(line, mHighlights) != std::string::npos)
+    if (mHighlights.find(line))
         mAwayLog.push_back("##9away:" + line);
 }
 
@@ -1636,15 +1637,17 @@ void ChatWindow::parseHighlights()
     if (!player_node)
         return;
 
-    splitToStringVector(mHighlights, config.getStringValue(
+    StringVect words;
+    splitToStringVector(words, config.getStringValue(
         "highlightWords"), ',');
-
-    mHighlights.push_back(player_node->getName());
+    mHighlights.add(words);
+    mHighlights.add(player_node->getName());
+    mHighlights.build();
 }
 
-bool ChatWindow::findHighlight(std::string &str)
+bool ChatWindow::findHighlight(const std::string &str) const
 {
-    return findI(str, mHighlights) != std::string::npos;
+    return mHighlights.find(str);
 }
 
 void ChatWindow::copyToClipboard(int x, int y)
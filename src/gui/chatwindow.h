@@ -29,6 +29,7 @@
 
 #include "gui/widgets/window.h"
 
+#include "utils/stringmatcher.h"
 #include "utils/stringvector.h"
 
 #include <guichan/actionlistener.hpp>
@@ -266,7 +267,7 @@ class ChatWindow : public Window,
 
         void parseHighlights();
 
-        bool findHighlight(std::string &str);
+        bool findHighlight(const std::string &str) const;
 
         void copyToClipboard(int x, int y);
 
@@ -346,14 +347,14 @@ class ChatWindow : public Window,
         bool mReturnToggles; /**< Marks whether <Return> toggles the chat log
                                 or not */
 
-        StringVect mTradeFilter;
+        StringMatcher mTradeFilter;
 
         gcn::DropDown *mColorPicker;
         ColorListModel *mColorListModel;
         int mChatColor;
         unsigned int mChatHistoryIndex;
         std::list<std::string> mAwayLog;
-        StringVect mHighlights;
+        StringMatcher mHighlights;
         bool mGMLoaded;
         bool mHaveMouse;
         bool mAutoHide;
@@ -33,6 +33,7 @@
 #include "gui/setup_video.h"
 #include "gui/viewport.h"
 
+#include "gui/widgets/button.h"
 #include "gui/widgets/chattab.h"
 #include "gui/widgets/label.h"
 #include "gui/widgets/layout.h"
@@ -42,9 +43,11 @@
 #include "gui/widgets/tabbedarea.h"
 
 #include "resources/imagehelper.h"
+#include "resources/openglimagehelper.h"
 
 #include "net/packetcounters.h"
 
+#include "utils/framepacer.h"
 #include "utils/gettext.h"
 #include "utils/stringutils.h"
 
@@ -72,6 +75,10 @@ DebugWindow::DebugWindow():
     mTabs->addTab(std::string(_("Map")), mMapWidget);
     mTabs->addTab(std::string(_("Target")), mTargetWidget);
     mTabs->addTab(std::string(_("Net")), mNetWidget);
+#ifdef ENABLE_PROFILER
+    mProfilerWidget = new ProfilerDebugTab;
+    mTabs->addTab(std::string(_("Profiler")), mProfilerWidget);
+#endif
 
     mTabs->setDimension(gcn::Rectangle(0, 0, 600, 300));
     add(mTabs);
@@ -79,6 +86,9 @@ DebugWindow::DebugWindow():
     mMapWidget->resize(getWidth(), getHeight());
     mTargetWidget->resize(getWidth(), getHeight());
     mNetWidget->resize(getWidth(), getHeight());
+#ifdef ENABLE_PROFILER
+    mProfilerWidget->resize(getWidth(), getHeight());
+#endif
     loadWindowState();
 }
 
@@ -90,6 +100,10 @@ DebugWindow::~DebugWindow()
     mTargetWidget = nullptr;
     delete mNetWidget;
     mNetWidget = nullptr;
+#ifdef ENABLE_PROFILER
+    delete mProfilerWidget;
+    mProfilerWidget = nullptr;
+#endif
 }
 
 void DebugWindow::slowLogic()
@@ -109,6 +123,11 @@ void DebugWindow::slowLogic()
         case 2:
             mNetWidget->logic();
             break;
+#ifdef ENABLE_PROFILER
+        case 3:
+            mProfilerWidget->logic();
+            break;
+#endif
     }
 
     if (player_node)
@@ -139,7 +158,8 @@ void DebugWindow::widgetResized(const gcn::Event &event)
 }
 
 MapDebugTab::MapDebugTab() :
-    mTexturesLabel(nullptr)
+    mTexturesLabel(nullptr),
+    mTextureMemLabel(nullptr)
 {
     LayoutHelper h(this);
     ContainerPlacer place = h.getPlacer(0, 0);
@@ -177,20 +197,31 @@ MapDebugTab::MapDebugTab() :
 
     mFPSLabel = new Label(strprintf(_("%d FPS"), 0));
     mLPSLabel = new Label(strprintf(_("%d LPS"), 0));
+    mFrameTimeLabel = new Label(strprintf(
+        _("Frame time: %.1f ms, max %.1f ms, skipped ticks: %d"),
+        88.8, 888.8, 8888));
+    mLatencyLabel = new Label(strprintf(
+        _("Input latency: %.1f ms, max %.1f ms"), 88.8, 888.8));
 
     place(0, 0, mFPSLabel, 2);
     place(0, 1, mLPSLabel, 2);
-    place(0, 2, mMusicFileLabel, 2);
-    place(0, 3, mMapLabel, 2);
-    place(0, 4, mMinimapLabel, 2);
-    place(0, 5, mXYLabel, 2);
-    place(0, 6, mTileMouseLabel, 2);
-    place(0, 7, mParticleCountLabel, 2);
-    place(0, 8, mMapActorCountLabel, 2);
+    place(0, 2, mFrameTimeLabel, 2);
+    place(0, 3, mLatencyLabel, 2);
+    place(0, 4, mMusicFileLabel, 2);
+    place(0, 5, mMapLabel, 2);
+    place(0, 6, mMinimapLabel, 2);
+    place(0, 7, mXYLabel, 2);
+    place(0, 8, mTileMouseLabel, 2);
+    place(0, 9, mParticleCountLabel, 2);
+    place(0, 10, mMapActorCountLabel, 2);
 #ifdef USE_OPENGL
+    mTextureMemLabel = new Label(strprintf(
+        _("Textures: %d KiB (images %d, text %d, atlas %d, padding %d)"),
+        88888, 88888, 88888, 88888, 88888));
+    place(0, 11, mTextureMemLabel, 2);
 #ifdef DEBUG_OPENGL_LEAKS
     mTexturesLabel = new Label(strprintf("%s %s", _("Textures count:"), "?"));
-    place(0, 9, mTexturesLabel, 2);
+    place(0, 12, mTexturesLabel, 2);
 #endif
 #endif
     place.getCell().matchColWidth(0, 0);
@@ -239,6 +270,17 @@ void MapDebugTab::logic()
                 strprintf("%s %d", _("Map actors count:"),
                 map->getActorsCount()));
 #ifdef USE_OPENGL
+            mTextureMemLabel->setCaption(strprintf(
+                _("Textures: %d KiB (images %d, text %d, atlas %d, "
+                "padding %d)"),
+                OpenGLImageHelper::getTotalTextureBytes() / 1024,
+                OpenGLImageHelper::getTextureBytes(
+                OpenGLImageHelper::TEXTURE_IMAGE) / 1024,
+                OpenGLImageHelper::getTextureBytes(
+                OpenGLImageHelper::TEXTURE_TEXT) / 1024,
+                OpenGLImageHelper::getTextureBytes(
+                OpenGLImageHelper::TEXTURE_ATLAS) / 1024,
+                OpenGLImageHelper::getPaddingBytes() / 1024));
 #ifdef DEBUG_OPENGL_LEAKS
             mTexturesLabel->setCaption(strprintf("%s %d",
                 _("Textures count:"), textures_count));
@@ -263,6 +305,16 @@ void MapDebugTab::logic()
 
     mFPSLabel->setCaption(strprintf(mFPSText.c_str(), fps));
     mLPSLabel->setCaption(strprintf(_("%d LPS"), lps));
+
+    const FramePacer::Stats &stats = FramePacer::getStats();
+    mFrameTimeLabel->setCaption(strprintf(
+        _("Frame time: %.1f ms, max %.1f ms, skipped ticks: %d"),
+        static_cast<double>(stats.frameAvg) / 1000,
+        static_cast<double>(stats.frameMax) / 1000, stats.droppedTicks));
+    mLatencyLabel->setCaption(strprintf(
+        _("Input latency: %.1f ms, max %.1f ms"),
+        static_cast<double>(stats.latencyAvg) / 1000,
+        static_cast<double>(stats.latencyMax) / 1000));
 }
 
 TargetDebugTab::TargetDebugTab()
@@ -405,3 +457,65 @@ void NetDebugTab::logic()
     mOutPackets1Label->setCaption(strprintf(_("Out: %d bytes/s"),
         PacketCounters::getOutBytes()));
 }
+
+#ifdef ENABLE_PROFILER
+ProfilerDebugTab::ProfilerDebugTab()
+{
+    LayoutHelper h(this);
+    ContainerPlacer place = h.getPlacer(0, 0);
+
+    std::string histogram = _("Histogram, ms:");
+    for (int f = 0; f < Profiler::BUCKETS - 1; f ++)
+    {
+        histogram += strprintf(" <%.2f",
+            Profiler::getBucketLimit(f) / 1000.0);
+    }
+    histogram += " >";
+    mHistogramLabel = new Label(histogram);
+    place(0, 0, mHistogramLabel, 2);
+
+    for (int f = 0; f < Profiler::ZONES_NR; f ++)
+    {
+        mZoneLabels[f] = new Label("                ");
+        place(0, f + 1, mZoneLabels[f], 2);
+    }
+
+    mDumpButton = new Button(_("Dump trace"), "dump", this);
+    place(0, Profiler::ZONES_NR + 1, mDumpButton);
+
+    place.getCell().matchColWidth(0, 0);
+    place = h.getPlacer(0, 1);
+    setDimension(gcn::Rectangle(0, 0, 600, 300));
+}
+
+void ProfilerDebugTab::logic()
+{
+    Profiler::ZoneStats stats;
+    for (int f = 0; f < Profiler::ZONES_NR; f ++)
+    {
+        const Profiler::Zone zone = static_cast<Profiler::Zone>(f);
+        Profiler::getStats(zone, stats);
+        std::string str = strprintf(_("%s: last %.2f, avg %.2f, max %.2f ms, "
+            "calls %d ["), Profiler::getZoneName(zone), stats.last / 1000.0,
+            stats.avg / 1000.0, stats.max / 1000.0, stats.calls);
+        for (int i = 0; i < Profiler::BUCKETS; i ++)
+        {
+            if (i)
+                str += " ";
+            str += toString(stats.histogram[i]);
+        }
+        str += "]";
+        mZoneLabels[f]->setCaption(str);
+        mZoneLabels[f]->adjustSize();
+    }
+}
+
+void ProfilerDebugTab::action(const gcn::ActionEvent &event)
+{
+    if (event.getId() == "dump")
+    {
+        Profiler::dumpTrace(Client::getLocalDataDirectory()
+            + "/profiler_trace.json");
+    }
+}
+#endif
@@ -26,6 +26,11 @@
 #include "gui/widgets/container.h"
 #include "gui/widgets/window.h"
 
+#include "utils/profiler.h"
+
+#include <guichan/actionlistener.hpp>
+
+class Button;
 class Container;
 class DebugWindow;
 class Label;
@@ -64,9 +69,12 @@ class MapDebugTab : public DebugTab
         Label *mMapActorCountLabel;
         Label *mXYLabel;
         Label *mTexturesLabel;
+        Label *mTextureMemLabel;
         int mUpdateTime;
         Label *mFPSLabel;
         Label *mLPSLabel;
+        Label *mFrameTimeLabel;
+        Label *mLatencyLabel;
         std::string mFPSText;
 };
 
@@ -107,6 +115,25 @@ class NetDebugTab : public DebugTab
         Label *mOutPackets1Label;
 };
 
+#ifdef ENABLE_PROFILER
+class ProfilerDebugTab : public DebugTab, public gcn::ActionListener
+{
+    friend class DebugWindow;
+
+    public:
+        ProfilerDebugTab();
+
+        void logic();
+
+        void action(const gcn::ActionEvent &event);
+
+    private:
+        Label *mHistogramLabel;
+        Label *mZoneLabels[Profiler::ZONES_NR];
+        Button *mDumpButton;
+};
+#endif
+
 /**
  * The debug window.
  *
@@ -138,6 +165,9 @@ class DebugWindow : public Window
         MapDebugTab *mMapWidget;
         TargetDebugTab *mTargetWidget;
         NetDebugTab *mNetWidget;
+#ifdef ENABLE_PROFILER
+        ProfilerDebugTab *mProfilerWidget;
+#endif
 };
 
 extern DebugWindow *debugWindow;
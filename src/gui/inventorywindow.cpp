@@ -620,7 +620,7 @@ void InventoryWindow::processEvent(Channels channel A_UNUSED,
 {
     if (event.getName() == EVENT_UPDATEATTRIBUTE)
     {
-        int id = event.getInt("id");
+        int id = event.attribute().id;
         if (id == TOTAL_WEIGHT || id == MAX_WEIGHT)
             updateWeight();
     }
@@ -442,10 +442,10 @@ void KillStats::processEvent(Channels channel A_UNUSED,
 {
     if (event.getName() == EVENT_UPDATEATTRIBUTE)
     {
-        int id = event.getInt("id");
+        int id = event.attribute().id;
         if (id == EXP || id == EXP_NEEDED)
         {
-            gainXp(event.getInt("newValue") - event.getInt("oldValue"));
+            gainXp(event.attribute().newValue - event.attribute().oldValue);
 //            update();
         }
         else if (id == LEVEL)
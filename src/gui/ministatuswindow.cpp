@@ -226,7 +226,7 @@ void MiniStatusWindow::processEvent(Channels channel A_UNUSED,
 {
     if (event.getName() == EVENT_UPDATEATTRIBUTE)
     {
-        int id = event.getInt("id");
+        int id = event.attribute().id;
         if (id == HP || id == MAX_HP)
             StatusWindow::updateHPBar(mHpBar);
         else if (id == MP || id == MAX_MP)
@@ -37,6 +37,9 @@
 
 #include <guichan/exception.hpp>
 
+#include <algorithm>
+#include <vector>
+
 #include "debug.h"
 
 const unsigned int CACHE_SIZE = 256;
@@ -51,7 +54,17 @@ class SDLTextChunk
 {
     public:
         SDLTextChunk(const std::string &text0, const gcn::Color &color0) :
-            img(nullptr), text(text0), color(color0)
+            img(nullptr), text(text0), color(color0), style(0), width(0)
+        {
+        }
+
+        SDLTextChunk(const std::string &text0, const gcn::Color &color0,
+                     const gcn::Color &outlineColor0,
+                     const gcn::Color &shadowColor0,
+                     const unsigned char style0) :
+            img(nullptr), text(text0), color(color0),
+            outlineColor(outlineColor0), shadowColor(shadowColor0),
+            style(style0), width(0)
         {
         }
 
@@ -63,7 +76,22 @@ class SDLTextChunk
 
         bool operator==(const SDLTextChunk &chunk) const
         {
-            return (chunk.text == text && chunk.color == color);
+            if (chunk.style != style || chunk.text != text
+                || chunk.color != color)
+            {
+                return false;
+            }
+            if ((style & SDLFont::TEXT_OUTLINE)
+                && chunk.outlineColor != outlineColor)
+            {
+                return false;
+            }
+            if ((style & SDLFont::TEXT_SHADOW)
+                && chunk.shadowColor != shadowColor)
+            {
+                return false;
+            }
+            return true;
         }
 
         void generate(TTF_Font *font, float alpha)
@@ -85,13 +113,152 @@ class SDLTextChunk
                 return;
             }
 
+            width = surface->w;
+            if (style)
+            {
+                SDL_Surface *const styled = createStyledSurface(surface);
+                SDL_FreeSurface(surface);
+                if (!styled)
+                {
+                    img = nullptr;
+                    return;
+                }
+                surface = styled;
+            }
+
             img = imageHelper->createTextSurface(surface, alpha);
             SDL_FreeSurface(surface);
         }
 
+        /**
+         * Builds outline and shadow around rendered text in one surface.
+         * Layers are drawn from back to front: shadow, outline, text.
+         */
+        SDL_Surface *createStyledSurface(SDL_Surface *const surface) const
+        {
+            const int pad = SDLFont::getStylePadding(style);
+            const int shadowOffset = (style & SDLFont::TEXT_OUTLINE) ? 2 : 1;
+            const int w = surface->w;
+            const int h = surface->h;
+            const int width = w + pad + ((style & SDLFont::TEXT_SHADOW)
+                ? shadowOffset : pad);
+            const int height = h + pad + ((style & SDLFont::TEXT_SHADOW)
+                ? shadowOffset : pad);
+
+            const SDL_PixelFormat *const fmt = surface->format;
+            SDL_Surface *const styled = SDL_CreateRGBSurface(SDL_SWSURFACE,
+                width, height, 32, fmt->Rmask, fmt->Gmask, fmt->Bmask,
+                fmt->Amask);
+            if (!styled)
+                return nullptr;
+
+            if (SDL_MUSTLOCK(surface))
+                SDL_LockSurface(surface);
+
+            // glyph coverage, with padding around
+            std::vector<uint8_t> mask(width * height, 0);
+            const int srcPitch = surface->pitch / 4;
+            const uint32_t *const src
+                = static_cast<const uint32_t*>(surface->pixels);
+            for (int y = 0; y < h; y ++)
+            {
+                const uint32_t *const row = src + y * srcPitch;
+                uint8_t *const dst = &mask[(y + pad) * width + pad];
+                for (int x = 0; x < w; x ++)
+                    dst[x] = static_cast<uint8_t>(getAlpha(fmt, row[x]));
+            }
+
+            if (SDL_MUSTLOCK(surface))
+                SDL_UnlockSurface(surface);
+
+            if (SDL_MUSTLOCK(styled))
+                SDL_LockSurface(styled);
+
+            const int dstPitch = styled->pitch / 4;
+            uint32_t *const dst = static_cast<uint32_t*>(styled->pixels);
+            for (int y = 0; y < height; y ++)
+            {
+                const uint8_t *const row = &mask[y * width];
+                for (int x = 0; x < width; x ++)
+                {
+                    unsigned r = 0;
+                    unsigned g = 0;
+                    unsigned b = 0;
+                    unsigned a = 0;
+
+                    if (style & SDLFont::TEXT_SHADOW)
+                    {
+                        const int sx = x - shadowOffset;
+                        const int sy = y - shadowOffset;
+                        if (sx >= 0 && sy >= 0)
+                        {
+                            blend(r, g, b, a, shadowColor,
+                                mask[sy * width + sx]);
+                        }
+                    }
+                    if (style & SDLFont::TEXT_OUTLINE)
+                    {
+                        uint8_t v = 0;
+                        if (x > 0 && row[x - 1] > v)
+                            v = row[x - 1];
+                        if (x + 1 < width && row[x + 1] > v)
+                            v = row[x + 1];
+                        if (y > 0 && row[x - width] > v)
+                            v = row[x - width];
+                        if (y + 1 < height && row[x + width] > v)
+                            v = row[x + width];
+                        blend(r, g, b, a, outlineColor, v);
+                    }
+                    blend(r, g, b, a, color, row[x]);
+
+                    dst[y * dstPitch + x] = SDL_MapRGBA(styled->format,
+                        static_cast<uint8_t>(r), static_cast<uint8_t>(g),
+                        static_cast<uint8_t>(b), static_cast<uint8_t>(a));
+                }
+            }
+
+            if (SDL_MUSTLOCK(styled))
+                SDL_UnlockSurface(styled);
+
+            return styled;
+        }
+
+        static unsigned getAlpha(const SDL_PixelFormat *const fmt,
+                                 const uint32_t c)
+        {
+            if (!fmt->Amask)
+                return 255;
+            const unsigned v = (c & fmt->Amask) >> fmt->Ashift;
+            return (v << fmt->Aloss) + (v >> (8 - (fmt->Aloss << 1)));
+        }
+
+        /**
+         * Draws layer pixel over accumulated pixel. Layer alpha is color
+         * alpha scaled by glyph coverage.
+         */
+        static void blend(unsigned &r, unsigned &g, unsigned &b,
+                          unsigned &a, const gcn::Color &col,
+                          const unsigned coverage)
+        {
+            const unsigned srcA = coverage * col.a / 255;
+            if (!srcA)
+                return;
+
+            const unsigned dstA = a * (255 - srcA) / 255;
+            const unsigned outA = srcA + dstA;
+            r = (col.r * srcA + r * dstA) / outA;
+            g = (col.g * srcA + g * dstA) / outA;
+            b = (col.b * srcA + b * dstA) / outA;
+            a = outA;
+        }
+
         Image *img;
         std::string text;
         gcn::Color color;
+        gcn::Color outlineColor;
+        gcn::Color shadowColor;
+        unsigned char style;
+        int width;
 };
 
 typedef std::list<SDLTextChunk>::iterator CacheIterator;
@@ -206,9 +373,43 @@ void SDLFont::drawString(gcn::Graphics *graphics,
      */
     col.a = 255;
 
-    SDLTextChunk chunk(text, col);
+    drawChunk(g, SDLTextChunk(text, col), alpha, x, y);
+}
 
-    unsigned char chr = text[0];
+void SDLFont::drawStyledString(gcn::Graphics *graphics,
+                               const std::string &text,
+                               int x, int y,
+                               const gcn::Color &color,
+                               const gcn::Color &outlineColor,
+                               const gcn::Color &shadowColor,
+                               const unsigned char style)
+{
+    if (text.empty() || !color.a)
+        return;
+
+    Graphics *g = dynamic_cast<Graphics *>(graphics);
+
+    const float alpha = static_cast<float>(color.a) / 255.0f;
+
+    /* Outline and shadow alpha are stored relative to text alpha, so text
+     * fading with its outline does not create new cache entries.
+     */
+    gcn::Color col = color;
+    col.a = 255;
+    gcn::Color outline = outlineColor;
+    outline.a = std::min(255, outline.a * 255 / color.a);
+    gcn::Color shadow = shadowColor;
+    shadow.a = std::min(255, shadow.a * 255 / color.a);
+
+    const int pad = getStylePadding(style);
+    drawChunk(g, SDLTextChunk(text, col, outline, shadow, style),
+        alpha, x - pad, y - pad);
+}
+
+void SDLFont::drawChunk(Graphics *const g, const SDLTextChunk &chunk,
+                        const float alpha, const int x, const int y)
+{
+    unsigned char chr = chunk.text[0];
     std::list<SDLTextChunk> *cache = &mCache[chr];
 
     bool found = false;
@@ -232,7 +433,8 @@ void SDLFont::drawString(gcn::Graphics *graphics,
 #endif
     }
 #ifdef DEBUG_FONT
-    logger->log("drawString: " + text + ", iterations: " + toString(cnt));
+    logger->log("drawString: " + chunk.text + ", iterations: "
+        + toString(cnt));
 #endif
 
     // Surface not found
@@ -261,7 +463,6 @@ void SDLFont::drawString(gcn::Graphics *graphics,
         image->setAlpha(alpha);
         g->drawImage(image, x, y);
     }
-
 }
 
 void SDLFont::slowLogic()
@@ -310,7 +511,7 @@ int SDLFont::getWidth(const std::string &text) const
             // Assumption is that TTF::draw will be called next
             cache->splice(cache->begin(), *cache, i);
             if (i->img)
-                return i->img->getWidth();
+                return i->width;
             else
                 return 0;
         }
@@ -24,6 +24,7 @@
 #ifndef SDLFONT_H
 #define SDLFONT_H
 
+#include <guichan/color.hpp>
 #include <guichan/font.hpp>
 
 #ifdef __WIN32__
@@ -37,6 +38,7 @@
 
 #define CACHES_NUMBER 256
 
+class Graphics;
 class SDLTextChunk;
 
 /**
@@ -47,6 +49,15 @@ class SDLTextChunk;
 class SDLFont : public gcn::Font
 {
     public:
+        /**
+         * Text styles drawn by drawStyledString.
+         */
+        enum TextStyle
+        {
+            TEXT_OUTLINE = 1,
+            TEXT_SHADOW = 2
+        };
+
         /**
          * Constructor.
          *
@@ -78,6 +89,24 @@ class SDLFont : public gcn::Font
                         const std::string &text,
                         int x, int y);
 
+        /**
+         * Draws text with outline and/or shadow. Text and its styles are
+         * rendered to one cached image, so it is drawn with one blit.
+         */
+        void drawStyledString(gcn::Graphics *graphics,
+                              const std::string &text,
+                              int x, int y,
+                              const gcn::Color &color,
+                              const gcn::Color &outlineColor,
+                              const gcn::Color &shadowColor,
+                              const unsigned char style);
+
+        /**
+         * Returns space added at left and top of styled text image.
+         */
+        static int getStylePadding(const unsigned char style)
+        { return (style & TEXT_OUTLINE) ? 1 : 0; }
+
         void clear();
 
         void doClean();
@@ -91,6 +120,9 @@ class SDLFont : public gcn::Font
         { return mDeleteCounter; }
 
     private:
+        void drawChunk(Graphics *const g, const SDLTextChunk &chunk,
+                       const float alpha, const int x, const int y);
+
         TTF_Font *mFont;
         unsigned mCreateCounter;
         unsigned mDeleteCounter;
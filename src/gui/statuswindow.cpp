@@ -292,7 +292,7 @@ void StatusWindow::processEvent(Channels channel A_UNUSED,
 
     if (event.getName() == EVENT_UPDATEATTRIBUTE)
     {
-        switch (event.getInt("id"))
+        switch (event.attribute().id)
         {
             case HP: case MAX_HP:
                 updateHPBar(mHpBar, true);
@@ -308,13 +308,13 @@ void StatusWindow::processEvent(Channels channel A_UNUSED,
 
             case MONEY:
                 mMoneyLabel->setCaption(strprintf(_("Money: %s"),
-                    Units::formatCurrency(event.getInt("newValue")).c_str()));
+                    Units::formatCurrency(event.attribute().newValue).c_str()));
                 mMoneyLabel->adjustSize();
                 break;
 
             case CHAR_POINTS:
                 mCharacterPointsLabel->setCaption(strprintf(
-                    _("Character points: %d"), event.getInt("newValue")));
+                    _("Character points: %d"), event.attribute().newValue));
 
                 mCharacterPointsLabel->adjustSize();
                 // Update all attributes
@@ -328,7 +328,7 @@ void StatusWindow::processEvent(Channels channel A_UNUSED,
 
             case CORR_POINTS:
                 mCorrectionPointsLabel->setCaption(strprintf(
-                    _("Correction points: %d"), event.getInt("newValue")));
+                    _("Correction points: %d"), event.attribute().newValue));
                 mCorrectionPointsLabel->adjustSize();
                 // Update all attributes
                 for (Attrs::const_iterator it = mAttrs.begin();
@@ -341,7 +341,7 @@ void StatusWindow::processEvent(Channels channel A_UNUSED,
 
             case LEVEL:
                 mLvlLabel->setCaption(strprintf(_("Level: %d"),
-                                      event.getInt("newValue")));
+                                      event.attribute().newValue));
                 mLvlLabel->adjustSize();
             break;
 
@@ -351,14 +351,14 @@ void StatusWindow::processEvent(Channels channel A_UNUSED,
     }
     else if (event.getName() == EVENT_UPDATESTAT)
     {
-        int id = event.getInt("id");
+        int id = event.stat().id;
         if (id == Net::getPlayerHandler()->getJobLocation())
         {
             if (mJobLvlLabel)
             {
                 int lvl = PlayerInfo::getStatBase(id);
 
-                int oldExp = event.getInt("oldValue1");
+                int oldExp = event.stat().oldValue1;
                 std::pair<int, int> exp
                     = PlayerInfo::getStatExperience(id);
 
@@ -457,11 +457,15 @@ void StatusWindow::updateHPBar(ProgressBar *bar, bool showMax)
     if (!bar)
         return;
 
-    if (showMax)
-        bar->setText(toString(PlayerInfo::getAttribute(HP)) +
-                    "/" + toString(PlayerInfo::getAttribute(MAX_HP)));
-    else
-        bar->setText(toString(PlayerInfo::getAttribute(HP)));
+    const int hp = PlayerInfo::getAttribute(HP);
+    const int maxHp = PlayerInfo::getAttribute(MAX_HP);
+    if (bar->setTextValues(hp, showMax ? maxHp : -1))
+    {
+        if (showMax)
+            bar->setText(toString(hp) + "/" + toString(maxHp));
+        else
+            bar->setText(toString(hp));
+    }
 
     float prog = 1.0;
 
@@ -478,14 +482,14 @@ void StatusWindow::updateMPBar(ProgressBar *bar, bool showMax)
     if (!bar)
         return;
 
-    if (showMax)
+    const int mp = PlayerInfo::getAttribute(MP);
+    const int maxMp = PlayerInfo::getAttribute(MAX_MP);
+    if (bar->setTextValues(mp, showMax ? maxMp : -1))
     {
-        bar->setText(toString(PlayerInfo::getAttribute(MP)) +
-                    "/" + toString(PlayerInfo::getAttribute(MAX_MP)));
-    }
-    else
-    {
-        bar->setText(toString(PlayerInfo::getAttribute(MP)));
+        if (showMax)
+            bar->setText(toString(mp) + "/" + toString(maxMp));
+        else
+            bar->setText(toString(mp));
     }
 
     float prog = 1.0f;
@@ -517,25 +521,31 @@ void StatusWindow::updateProgressBar(ProgressBar *bar, int value, int max,
     if (!bar)
         return;
 
+    // percent and plain text differ, so keep them apart in values
+    const bool changed = bar->setTextValues(value, percent ? -max : max);
+
     if (max == 0)
     {
-        bar->setText(_("Max"));
         bar->setProgress(1);
-        bar->setText(toString(value));
+        if (changed)
+            bar->setText(toString(value));
     }
     else
     {
         float progress = static_cast<float>(value)
                          / static_cast<float>(max);
 
-        if (percent)
+        if (changed)
         {
-            bar->setText(strprintf("%2.5f%%",
-                static_cast<double>(100 * progress)));
-        }
-        else
-        {
-            bar->setText(toString(value) + "/" + toString(max));
+            if (percent)
+            {
+                bar->setText(strprintf("%2.5f%%",
+                    static_cast<double>(100 * progress)));
+            }
+            else
+            {
+                bar->setText(toString(value) + "/" + toString(max));
+            }
         }
 
         bar->setProgress(progress);
@@ -572,21 +582,27 @@ void StatusWindow::updateWeightBar(ProgressBar *bar)
     if (!bar)
         return;
 
-    if (PlayerInfo::getAttribute(MAX_WEIGHT) == 0)
+    const int totalWeight = PlayerInfo::getAttribute(TOTAL_WEIGHT);
+    const int maxWeight = PlayerInfo::getAttribute(MAX_WEIGHT);
+    const bool changed = bar->setTextValues(totalWeight, maxWeight);
+
+    if (maxWeight == 0)
     {
-        bar->setText(_("Max"));
+        if (changed)
+            bar->setText(_("Max"));
         bar->setProgress(1.0);
     }
     else
     {
-        float progress = static_cast<float>(
-            PlayerInfo::getAttribute(TOTAL_WEIGHT))
-            / static_cast<float>(PlayerInfo::getAttribute(MAX_WEIGHT));
+        float progress = static_cast<float>(totalWeight)
+            / static_cast<float>(maxWeight);
 
-        bar->setText(strprintf("%s/%s", Units::formatWeight(
-            PlayerInfo::getAttribute(TOTAL_WEIGHT)).c_str(),
-            Units::formatWeight(PlayerInfo::getAttribute(
-            MAX_WEIGHT)).c_str()));
+        if (changed)
+        {
+            bar->setText(strprintf("%s/%s",
+                Units::formatWeight(totalWeight).c_str(),
+                Units::formatWeight(maxWeight).c_str()));
+        }
 
         bar->setProgress(progress);
     }
@@ -598,7 +614,8 @@ void StatusWindow::updateMoneyBar(ProgressBar *bar)
         return;
 
     int money = PlayerInfo::getAttribute(MONEY);
-    bar->setText(Units::formatCurrency(money).c_str());
+    if (bar->setTextValues(money, 0))
+        bar->setText(Units::formatCurrency(money));
     if (money > 0)
     {
         float progress = static_cast<float>(money)
@@ -619,10 +636,9 @@ void StatusWindow::updateArrowsBar(ProgressBar *bar)
     Item *item = equipmentWindow->getEquipment(
         Equipment::EQUIP_PROJECTILE_SLOT);
 
-    if (item && item->getQuantity() > 0)
-        bar->setText(toString(item->getQuantity()));
-    else
-        bar->setText("0");
+    const int quantity = item ? std::max(0, item->getQuantity()) : 0;
+    if (bar->setTextValues(quantity, 0))
+        bar->setText(toString(quantity));
 }
 
 void StatusWindow::updateInvSlotsBar(ProgressBar *bar)
@@ -643,7 +659,8 @@ void StatusWindow::updateInvSlotsBar(ProgressBar *bar)
             / static_cast<float>(maxSlots));
     }
 
-    bar->setText(strprintf("%d", usedSlots));
+    if (bar->setTextValues(usedSlots, 0))
+        bar->setText(toString(usedSlots));
 }
 
 std::string StatusWindow::translateLetter(const char* letters)
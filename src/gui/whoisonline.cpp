@@ -24,8 +24,9 @@
 
 #include <SDL.h>
 #include <SDL_thread.h>
-#include <vector>
 #include <algorithm>
+#include <map>
+#include <vector>
 
 #include "gui/socialwindow.h"
 #include "gui/viewport.h"
@@ -84,6 +85,7 @@ WhoIsOnline::WhoIsOnline():
     mDownloadedBytes(0),
     mMemoryBuffer(nullptr),
     mCurlError(new char[CURL_ERROR_SIZE]),
+    mWebPlayers(nullptr),
     mAllowUpdate(true),
     mShowLevel(false),
     mGroupFriends(true)
@@ -143,6 +145,14 @@ WhoIsOnline::~WhoIsOnline()
     // Remove possibly leftover temporary download
     delete []mCurlError;
 
+    delete mWebPlayers;
+    mWebPlayers = nullptr;
+
+    deletePlayers();
+}
+
+void WhoIsOnline::deletePlayers()
+{
     for (std::set<OnlinePlayer*>::iterator itd = mOnlinePlayers.begin(),
          itd_end = mOnlinePlayers.end(); itd != itd_end; ++ itd)
     {
@@ -200,39 +210,24 @@ void WhoIsOnline::updateWindow(std::vector<OnlinePlayer*> &friends,
     sort(friends.begin(), friends.end(), nameCompare);
     sort(neutral.begin(), neutral.end(), nameCompare);
     sort(disregard.begin(), disregard.end(), nameCompare);
-    bool addedFromSection(false);
-    for (int i = 0; i < static_cast<int>(friends.size()); i++)
-    {
-        mBrowserBox->addRow(friends.at(i)->getText());
-        addedFromSection = true;
-    }
-    if (addedFromSection == true)
-    {
-        mBrowserBox->addRow("---");
-        addedFromSection = false;
-    }
-    for (int i = 0; i < static_cast<int>(enemy.size()); i++)
-    {
-        mBrowserBox->addRow(enemy.at(i)->getText());
-        addedFromSection = true;
-    }
-    if (addedFromSection == true)
-    {
-        mBrowserBox->addRow("---");
-        addedFromSection = false;
-    }
-    for (int i = 0; i < static_cast<int>(neutral.size()); i++)
-    {
-        mBrowserBox->addRow(neutral.at(i)->getText());
-        addedFromSection = true;
-    }
-    if (addedFromSection == true && !disregard.empty())
-    {
-        mBrowserBox->addRow("---");
-//        addedFromSection = false;
-    }
-    for (int i = 0; i < static_cast<int>(disregard.size()); i++)
-        mBrowserBox->addRow(disregard.at(i)->getText());
+    StringVect rows;
+    rows.reserve(numOnline + 3);
+    for (size_t i = 0; i < friends.size(); i++)
+        rows.push_back(friends[i]->getText());
+    if (!friends.empty())
+        rows.push_back("---");
+    for (size_t i = 0; i < enemy.size(); i++)
+        rows.push_back(enemy[i]->getText());
+    if (!enemy.empty())
+        rows.push_back("---");
+    for (size_t i = 0; i < neutral.size(); i++)
+        rows.push_back(neutral[i]->getText());
+    if (!neutral.empty() && !disregard.empty())
+        rows.push_back("---");
+    for (size_t i = 0; i < disregard.size(); i++)
+        rows.push_back(disregard[i]->getText());
+
+    setRows(rows);
 
     if (mScrollArea->getVerticalMaxScroll() <
         mScrollArea->getVerticalScrollAmount())
@@ -242,22 +237,53 @@ void WhoIsOnline::updateWindow(std::vector<OnlinePlayer*> &friends,
     }
 }
 
+void WhoIsOnline::setRows(const StringVect &rows)
+{
+    // rows are sorted inside sections, so walking both lists removes and
+    // inserts only rows of players who joined, left or changed
+    std::set<std::string> oldRows(mRows.begin(), mRows.end());
+    std::set<std::string> newRows(rows.begin(), rows.end());
+    const size_t oldSize = mRows.size();
+    const size_t newSize = rows.size();
+    size_t oldPos = 0;
+    size_t newPos = 0;
+    int row = 0;
+    while (oldPos < oldSize || newPos < newSize)
+    {
+        if (oldPos < oldSize && newPos < newSize
+            && mRows[oldPos] == rows[newPos])
+        {
+            oldPos ++;
+            newPos ++;
+            row ++;
+        }
+        else if (oldPos < oldSize && (newPos >= newSize
+                 || newRows.find(mRows[oldPos]) == newRows.end()
+                 || oldRows.find(rows[newPos]) != oldRows.end()))
+        {
+            mBrowserBox->removeRow(row);
+            oldPos ++;
+        }
+        else
+        {
+            mBrowserBox->insertRow(row, rows[newPos]);
+            newPos ++;
+            row ++;
+        }
+    }
+    mRows = rows;
+    mBrowserBox->updateHeight();
+}
+
 void WhoIsOnline::loadList(std::vector<OnlinePlayer*> &list)
 {
-    mBrowserBox->clearRows();
     int numOnline = list.size();
     std::vector<OnlinePlayer*> friends;
     std::vector<OnlinePlayer*> neutral;
     std::vector<OnlinePlayer*> disregard;
     std::vector<OnlinePlayer*> enemy;
 
-    for (std::set<OnlinePlayer*>::iterator itd = mOnlinePlayers.begin(),
-         itd_end = mOnlinePlayers.end(); itd != itd_end; ++ itd)
-    {
-        delete *itd;
-    }
-    mOnlinePlayers.clear();
-    mOnlineNicks.clear();
+    deletePlayers();
 
     mShowLevel = config.getBoolValue("showlevel");
 
@@ -316,65 +342,44 @@ void WhoIsOnline::loadList(std::vector<OnlinePlayer*> &list)
     }
 }
 
-void WhoIsOnline::loadWebList()
+void WhoIsOnline::parseWebList(const char *buffer, WebPlayers &players)
 {
-    if (!mMemoryBuffer)
-        return;
-
-    // Reallocate and include terminating 0 character
-    mMemoryBuffer = static_cast<char*>(
-        realloc(mMemoryBuffer, mDownloadedBytes + 1));
-    mMemoryBuffer[mDownloadedBytes] = '\0';
-
-    mBrowserBox->clearRows();
     bool listStarted(false);
     std::string lineStr;
-    int numOnline(0);
-    std::vector<OnlinePlayer*> friends;
-    std::vector<OnlinePlayer*> neutral;
-    std::vector<OnlinePlayer*> disregard;
-    std::vector<OnlinePlayer*> enemy;
-
-    // Tokenize and add each line separately
-    char *line = strtok(mMemoryBuffer, "\n");
     const std::string gmText = "(GM)";
 
-    for (std::set<OnlinePlayer*>::iterator itd = mOnlinePlayers.begin(),
-         itd_end = mOnlinePlayers.end(); itd != itd_end; ++ itd)
+    // Split and add each line separately. strtok is not used, because it
+    // is not thread safe.
+    const char *line = buffer;
+    while (*line)
     {
-        delete *itd;
-    }
-
-    mOnlinePlayers.clear();
-    mOnlineNicks.clear();
-
-    mShowLevel = config.getBoolValue("showlevel");
-
-    while (line)
-    {
-        std::string nick;
-        lineStr = line;
+        const char *lineEnd = strchr(line, '\n');
+        if (!lineEnd)
+            lineEnd = line + strlen(line);
+        lineStr.assign(line, lineEnd - line);
+        line = *lineEnd ? lineEnd + 1 : lineEnd;
         trim(lineStr);
+        if (lineStr.empty())
+            continue;
         if (listStarted == true)
         {
-            size_t found;
-            found = lineStr.find(" users are online.");
-            if (found == std::string::npos)
+            if (lineStr.find(" users are online.") == std::string::npos)
             {
-                int level = 0;
+                WebPlayer player;
+                player.level = 0;
 
                 size_t pos = 0;
                 if (lineStr.length() > 24)
                 {
-                    nick = lineStr.substr(0, 24);
+                    player.nick = lineStr.substr(0, 24);
                     lineStr = lineStr.substr(25);
                 }
                 else
                 {
-                    nick = lineStr;
+                    player.nick = lineStr;
                     lineStr = "";
                 }
-                trim(nick);
+                trim(player.nick);
 
                 pos = lineStr.find(gmText, 0);
                 if (pos != std::string::npos)
@@ -387,84 +392,136 @@ void WhoIsOnline::loadWebList()
                     lineStr = lineStr.substr(0, pos);
 
                 if (!lineStr.empty())
-                    level = atoi(lineStr.c_str());
+                    player.level = atoi(lineStr.c_str());
 
-                if (actorSpriteManager)
-                {
-                    Being *being = actorSpriteManager->findBeingByName(
-                        nick, Being::PLAYER);
-                    if (being)
-                    {
-                        if (level > 0)
-                        {
-                            being->setLevel(level);
-                            being->updateName();
-                        }
-                        else
-                        {
-                            if (being->getLevel() > 1)
-                                level = being->getLevel();
-                        }
-                    }
-                }
+                players.push_back(player);
+            }
+        }
+        else if (lineStr.find("------------------------------")
+                 != std::string::npos)
+        {
+            listStarted = true;
+        }
+    }
+}
+
+void WhoIsOnline::loadWebList()
+{
+    mMutex.lock();
+    WebPlayers *players = mWebPlayers;
+    mWebPlayers = nullptr;
+    mMutex.unlock();
+
+    if (!players)
+        return;
 
+    int numOnline(0);
+    std::vector<OnlinePlayer*> friends;
+    std::vector<OnlinePlayer*> neutral;
+    std::vector<OnlinePlayer*> disregard;
+    std::vector<OnlinePlayer*> enemy;
 
-                if (!mShowLevel)
-                    level = 0;
+    // players still online are reused
+    std::map<std::string, OnlinePlayer*> oldPlayers;
+    for (std::set<OnlinePlayer*>::const_iterator itd = mOnlinePlayers.begin(),
+         itd_end = mOnlinePlayers.end(); itd != itd_end; ++ itd)
+    {
+        oldPlayers[(*itd)->getNick()] = *itd;
+    }
+    mOnlinePlayers.clear();
+    mOnlineNicks.clear();
 
-                OnlinePlayer *player = new OnlinePlayer(nick, 255, level,
-                    GENDER_UNSPECIFIED, -1);
-                mOnlinePlayers.insert(player);
-                mOnlineNicks.insert(nick);
+    mShowLevel = config.getBoolValue("showlevel");
+
+    for (WebPlayers::const_iterator it = players->begin(),
+         it_end = players->end(); it != it_end; ++ it)
+    {
+        const std::string &nick = (*it).nick;
+        int level = (*it).level;
 
-                numOnline++;
-                switch (player_relations.getRelation(nick))
+        if (actorSpriteManager)
+        {
+            Being *being = actorSpriteManager->findBeingByName(
+                nick, Being::PLAYER);
+            if (being)
+            {
+                if (level > 0)
                 {
-                    case PlayerRelation::NEUTRAL:
-                    default:
-                        player->setText("0");
-                        neutral.push_back(player);
-                        break;
-
-                    case PlayerRelation::FRIEND:
-                        player->setText("2");
-                        if (mGroupFriends)
-                            friends.push_back(player);
-                        else
-                            neutral.push_back(player);
-                        break;
-
-                    case PlayerRelation::DISREGARDED:
-                    case PlayerRelation::BLACKLISTED:
-                        player->setText("8");
-                        disregard.push_back(player);
-                        break;
-
-                    case PlayerRelation::ENEMY2:
-                        player->setText("1");
-                        enemy.push_back(player);
-                        break;
-
-                    case PlayerRelation::IGNORED:
-                    case PlayerRelation::ERASED:
-                        //Ignore the ignored.
-                        break;
+                    being->setLevel(level);
+                    being->updateName();
+                }
+                else
+                {
+                    if (being->getLevel() > 1)
+                        level = being->getLevel();
                 }
             }
         }
-        else if (lineStr.find("------------------------------")
-                 != std::string::npos)
+
+        if (!mShowLevel)
+            level = 0;
+
+        OnlinePlayer *player = nullptr;
+        std::map<std::string, OnlinePlayer*>::iterator itp
+            = oldPlayers.find(nick);
+        if (itp != oldPlayers.end())
         {
-            listStarted = true;
+            player = itp->second;
+            player->setLevel(static_cast<char>(level));
+            oldPlayers.erase(itp);
+        }
+        else
+        {
+            player = new OnlinePlayer(nick, 255, static_cast<char>(level),
+                GENDER_UNSPECIFIED, -1);
+        }
+        mOnlinePlayers.insert(player);
+        mOnlineNicks.insert(nick);
+
+        numOnline++;
+        switch (player_relations.getRelation(nick))
+        {
+            case PlayerRelation::NEUTRAL:
+            default:
+                player->setText("0");
+                neutral.push_back(player);
+                break;
+
+            case PlayerRelation::FRIEND:
+                player->setText("2");
+                if (mGroupFriends)
+                    friends.push_back(player);
+                else
+                    neutral.push_back(player);
+                break;
+
+            case PlayerRelation::DISREGARDED:
+            case PlayerRelation::BLACKLISTED:
+                player->setText("8");
+                disregard.push_back(player);
+                break;
+
+            case PlayerRelation::ENEMY2:
+                player->setText("1");
+                enemy.push_back(player);
+                break;
+
+            case PlayerRelation::IGNORED:
+            case PlayerRelation::ERASED:
+                //Ignore the ignored.
+                break;
         }
-        line = strtok(nullptr, "\n");
     }
+    delete players;
 
-    updateWindow(friends, neutral, disregard, enemy, numOnline);
+    for (std::map<std::string, OnlinePlayer*>::iterator
+         itp = oldPlayers.begin(), itp_end = oldPlayers.end();
+         itp != itp_end; ++ itp)
+    {
+        delete itp->second;
+    }
 
-    // Free the memory buffer now that we don't need it anymore
-    free(mMemoryBuffer);
-    mMemoryBuffer = nullptr;
+    updateWindow(friends, neutral, disregard, enemy, numOnline);
 }
 
 size_t WhoIsOnline::memoryWrite(void *ptr, size_t size,
@@ -557,6 +614,23 @@ int WhoIsOnline::downloadThread(void *ptr)
             curl_easy_cleanup(curl);
             curl_slist_free_all(pHeaders);
 
+            // Parse here, main thread only applies changes
+            WebPlayers *players = new WebPlayers;
+            if (wio->mMemoryBuffer)
+            {
+                // Reallocate and include terminating 0 character
+                wio->mMemoryBuffer = static_cast<char*>(realloc(
+                    wio->mMemoryBuffer, wio->mDownloadedBytes + 1));
+                wio->mMemoryBuffer[wio->mDownloadedBytes] = '\0';
+                parseWebList(wio->mMemoryBuffer, *players);
+                free(wio->mMemoryBuffer);
+                wio->mMemoryBuffer = nullptr;
+            }
+            wio->mMutex.lock();
+            delete wio->mWebPlayers;
+            wio->mWebPlayers = players;
+            wio->mMutex.unlock();
+
             // It's stored in memory, we're done
             wio->mDownloadComplete = true;
         }
@@ -625,9 +699,11 @@ void WhoIsOnline::slowLogic()
     switch (mDownloadStatus)
     {
         case UPDATE_ERROR:
-            mBrowserBox->clearRows();
-            mBrowserBox->addRow("##1Failed to fetch the online list!");
-            mBrowserBox->addRow(mCurlError);
+        {
+            StringVect rows;
+            rows.push_back("##1Failed to fetch the online list!");
+            rows.push_back(mCurlError);
+            setRows(rows);
             mDownloadStatus = UPDATE_COMPLETE;
             setCaption(_("Who Is Online - error"));
             mUpdateButton->setEnabled(true);
@@ -635,6 +711,7 @@ void WhoIsOnline::slowLogic()
             mDownloadComplete = true;
             updateSize();
             break;
+        }
         case UPDATE_LIST:
             if (mDownloadComplete == true)
             {
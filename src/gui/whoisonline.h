@@ -166,6 +166,26 @@ private:
     const std::string prepareNick(std::string nick, int level,
                                   std::string color) const;
 
+    /**
+     * Nick and level from online.txt, parsed in download thread.
+     */
+    struct WebPlayer
+    {
+        std::string nick;
+        int level;
+    };
+
+    typedef std::vector<WebPlayer> WebPlayers;
+
+    static void parseWebList(const char *buffer, WebPlayers &players);
+
+    /**
+     * Changes only rows which differ from currently shown rows.
+     */
+    void setRows(const StringVect &rows);
+
+    void deletePlayers();
+
     void updateWindow(std::vector<OnlinePlayer*> &friends,
                       std::vector<OnlinePlayer*> &neutral,
                       std::vector<OnlinePlayer*> &disregard,
@@ -197,6 +217,14 @@ private:
     /** Buffer to handler human readable error provided by curl. */
     char *mCurlError;
 
+    /** Players parsed by download thread, protected by mMutex. */
+    WebPlayers *mWebPlayers;
+
+    Mutex mMutex;
+
+    /** Rows currently shown in mBrowserBox. */
+    StringVect mRows;
+
     BrowserBox *mBrowserBox;
     ScrollArea *mScrollArea;
     time_t mUpdateTimer;
@@ -137,20 +137,12 @@ void AvatarListBox::draw(gcn::Graphics *gcnGraphics)
         if (a->getDisplayBold())
             graphics->setFont(boldFont);
 
-        std::string text;
+        const bool self = a->getName() == name;
+        const std::string &text = getRowText(i, a, self,
+            graphics->getSecure());
 
         if (a->getMaxHp() > 0)
         {
-            if (mShowLevel && a->getLevel() > 1)
-            {
-                text = strprintf("%s %d/%d (%d)", a->getComplexName().c_str(),
-                                 a->getHp(), a->getMaxHp(), a->getLevel());
-            }
-            else
-            {
-                text = strprintf("%s %d/%d", a->getComplexName().c_str(),
-                                 a->getHp(), a->getMaxHp());
-            }
             if (parent && a->getMaxHp())
             {
                 gcn::Color color = Theme::getProgressColor(
@@ -164,43 +156,12 @@ void AvatarListBox::draw(gcn::Graphics *gcnGraphics)
                     fontHeight));
             }
         }
-        else if (a->getDamageHp() != 0 && a->getName() != name)
+        else if (a->getDamageHp() != 0 && !self)
         {
-            if (mShowLevel && a->getLevel() > 1)
-            {
-                text = strprintf("%s -%d (%d)", a->getComplexName().c_str(),
-                                 a->getDamageHp(), a->getLevel());
-            }
-            else
-            {
-                text = strprintf("%s -%d", a->getComplexName().c_str(),
-                                 a->getDamageHp());
-            }
-
             if (parent)
             {
-//                int diff;
-//                if (a->getDamageHp() > 1024)
-//                    diff = 0;
-//                else
-//                    diff = 1024 - a->getDamageHp();
                 gcn::Color color = Theme::getProgressColor(Theme::PROG_HP,
                         1);
-//                        0 / 1024);
-/*
-                if (a->getDamageHp() >= 400)
-                {
-                }
-                else
-                {
-//                    int intens = 1024/(400 - a->getDamageHp());
-                    int intens = a->getDamageHp() / 1024;
-                    if (intens > 1)
-                        intens = 1;
-                    color = Theme::getProgressColor(Theme::PROG_HP,
-                        intens);
-                }
-*/
 
                 color.a = 80;
                 graphics->setColor(color);
@@ -220,86 +181,115 @@ void AvatarListBox::draw(gcn::Graphics *gcnGraphics)
                 }
             }
         }
+
+        graphics->setColor(getForegroundColor());
+
+        // Draw Name
+        if (a->getType() == MapItem::SEPARATOR)
+            graphics->drawText(text, 2, y);
         else
+            graphics->drawText(text, 15, y);
+
+        if (a->getDisplayBold())
+            graphics->setFont(getFont());
+    }
+
+    setWidth(parent->getWidth() - 10);
+}
+
+const std::string &AvatarListBox::getRowText(const unsigned int index,
+                                             const Avatar *const a,
+                                             const bool self,
+                                             const bool secure)
+{
+    if (mRows.size() <= index)
+        mRows.resize(index + 1);
+
+    AvatarRow &row = mRows[index];
+
+    // text is formatted again only if avatar changed
+    if (row.version == a->getVersion() && row.self == self
+        && row.secure == secure)
+    {
+        return row.text;
+    }
+
+    row.version = a->getVersion();
+    row.self = self;
+    row.secure = secure;
+
+    std::string &text = row.text;
+
+    if (a->getMaxHp() > 0)
+    {
+        if (mShowLevel && a->getLevel() > 1)
         {
-            if (mShowLevel && a->getLevel() > 1)
-            {
-                text = strprintf("%s (%d)", a->getComplexName().c_str(),
-                                 a->getLevel());
-            }
-            else
-            {
-                text = a->getComplexName();
-            }
+            text = strprintf("%s %d/%d (%d)", a->getComplexName().c_str(),
+                             a->getHp(), a->getMaxHp(), a->getLevel());
         }
-
-        if (!a->getMap().empty())
+        else
         {
-            if (a->getX() != -1)
-            {
-                text += strprintf(" [%d,%d %s]", a->getX(), a->getY(),
-                                  a->getMap().c_str());
-            }
-            else
-            {
-                text += strprintf(" [%s]", a->getMap().c_str());
-            }
+            text = strprintf("%s %d/%d", a->getComplexName().c_str(),
+                             a->getHp(), a->getMaxHp());
         }
-
-        if (graphics->getSecure())
+    }
+    else if (a->getDamageHp() != 0 && !self)
+    {
+        if (mShowLevel && a->getLevel() > 1)
         {
-            if (mShowGender)
-            {
-                switch (a->getGender())
-                {
-                    case GENDER_FEMALE:
-                        text += strprintf(" \u2640 ");
-                        break;
-                    case GENDER_MALE:
-                        text += strprintf(" \u2642 ");
-                        break;
-                    default:
-                        break;
-                }
-            }
+            text = strprintf("%s -%d (%d)", a->getComplexName().c_str(),
+                             a->getDamageHp(), a->getLevel());
         }
         else
         {
-            if (mShowGender)
-            {
-                switch (a->getGender())
-                {
-                    case GENDER_FEMALE:
-                        text += strprintf(" \u2640 %s",
-                            a->getAdditionString().c_str());
-                        break;
-                    case GENDER_MALE:
-                        text += strprintf(" \u2642 %s",
-                            a->getAdditionString().c_str());
-                        break;
-                    default:
-                        break;
-                }
-            }
-            else
-            {
-                text += a->getAdditionString();
-            }
+            text = strprintf("%s -%d", a->getComplexName().c_str(),
+                             a->getDamageHp());
         }
+    }
+    else
+    {
+        if (mShowLevel && a->getLevel() > 1)
+        {
+            text = strprintf("%s (%d)", a->getComplexName().c_str(),
+                             a->getLevel());
+        }
+        else
+        {
+            text = a->getComplexName();
+        }
+    }
 
-        graphics->setColor(getForegroundColor());
-
-        // Draw Name
-        if (a->getType() == MapItem::SEPARATOR)
-            graphics->drawText(text, 2, y);
+    if (!a->getMap().empty())
+    {
+        if (a->getX() != -1)
+        {
+            text += strprintf(" [%d,%d %s]", a->getX(), a->getY(),
+                              a->getMap().c_str());
+        }
         else
-            graphics->drawText(text, 15, y);
+        {
+            text += strprintf(" [%s]", a->getMap().c_str());
+        }
+    }
 
-        if (a->getDisplayBold())
-            graphics->setFont(getFont());
+    if (mShowGender)
+    {
+        switch (a->getGender())
+        {
+            case GENDER_FEMALE:
+                text += " \u2640 ";
+                break;
+            case GENDER_MALE:
+                text += " \u2642 ";
+                break;
+            default:
+                break;
+        }
     }
+    if (!secure)
+        text += a->getAdditionString();
 
-    setWidth(parent->getWidth() - 10);
+    return text;
 }
 
 void AvatarListBox::mousePressed(gcn::MouseEvent &event)
@@ -414,4 +404,5 @@ void AvatarListBox::optionChanged(const std::string &value)
         mShowGender = config.getBoolValue("showgender");
     else if (value == "showlevel")
         mShowLevel = config.getBoolValue("showlevel");
+    mRows.clear();
 }
@@ -60,10 +60,34 @@ public:
     void optionChanged(const std::string &value);
 
 private:
+    /**
+     * Row text together with the avatar version it was formatted from.
+     */
+    struct AvatarRow
+    {
+        AvatarRow() :
+            version(0), self(false), secure(false)
+        { }
+
+        std::string text;
+        unsigned int version;
+        bool self;
+        bool secure;
+    };
+
+    /**
+     * Returns text for given row, formatting it only if avatar changed.
+     */
+    const std::string &getRowText(const unsigned int index,
+                                  const Avatar *const a,
+                                  const bool self, const bool secure);
+
     bool mShowGender;
     bool mShowLevel;
     gcn::Color mHighlightColor;
 
+    std::vector<AvatarRow> mRows;
+
     static int instances;
     static Image *onlineIcon;
     static Image *offlineIcon;
@@ -102,17 +102,14 @@ void BrowserBox::setHighlightMode(unsigned int highMode)
     mHighMode = highMode;
 }
 
-void BrowserBox::addRow(const std::string &row, bool atTop)
+int BrowserBox::parseRow(const std::string &row, const int rowIndex,
+                         const size_t linkPos, std::string &newRow)
 {
     std::string tmp = row;
-    std::string newRow;
     size_t idx1;
     gcn::Font *font = getFont();
     int linksCount = 0;
 
-    if (getWidth() < 0)
-        return;
-
     // Use links and user defined colors
     if (mUseLinksAndUserColors)
     {
@@ -129,7 +126,7 @@ void BrowserBox::addRow(const std::string &row, bool atTop)
                 break;
             bLink.link = tmp.substr(idx1 + 2, idx2 - (idx1 + 2));
             bLink.caption = tmp.substr(idx2 + 1, idx3 - (idx2 + 1));
-            bLink.y1 = static_cast<int>(mTextRows.size()) * font->getHeight();
+            bLink.y1 = rowIndex * font->getHeight();
             bLink.y2 = bLink.y1 + font->getHeight();
 
             newRow += tmp.substr(0, idx1);
@@ -144,7 +141,7 @@ void BrowserBox::addRow(const std::string &row, bool atTop)
             bLink.x1 = font->getWidth(tmp2) - 1;
             bLink.x2 = bLink.x1 + font->getWidth(bLink.caption) + 1;
 
-            mLinks.push_back(bLink);
+            mLinks.insert(mLinks.begin() + linkPos + linksCount, bLink);
             linksCount ++;
 
             newRow += "##<" + bLink.caption;
@@ -167,6 +164,35 @@ void BrowserBox::addRow(const std::string &row, bool atTop)
     if (mProcessVersion)
         newRow = replaceAll(newRow, "%VER%", SMALL_VERSION);
 
+    return linksCount;
+}
+
+void BrowserBox::updateRowWidth(const std::string &newRow)
+{
+    std::string plain = newRow;
+    for (size_t idx1 = plain.find("##");
+         idx1 != std::string::npos;
+         idx1 = plain.find("##"))
+    {
+        plain.erase(idx1, 3);
+    }
+
+    // Adjust the BrowserBox size
+    int w = getFont()->getWidth(plain);
+    if (w > getWidth())
+        setWidth(w);
+}
+
+void BrowserBox::addRow(const std::string &row, bool atTop)
+{
+    std::string newRow;
+
+    if (getWidth() < 0)
+        return;
+
+    const int linksCount = parseRow(row, static_cast<int>(mTextRows.size()),
+        mLinks.size(), newRow);
+
     if (atTop)
     {
         mTextRows.push_front(newRow);
@@ -179,39 +205,50 @@ void BrowserBox::addRow(const std::string &row, bool atTop)
     }
 
     //discard older rows when a row limit has been set
-    if (mMaxRows > 0 && !mTextRows.empty())
-    {
-        while (mTextRows.size() > mMaxRows)
-        {
-            mTextRows.pop_front();
-            int cnt = mTextRowLinksCount.front();
-            mTextRowLinksCount.pop_front();
-
-            while (cnt && !mLinks.empty())
-            {
-                mLinks.erase(mLinks.begin());
-                cnt --;
-            }
-        }
-    }
+    trimRows();
 
     // Auto size mode
     if (mMode == AUTO_SIZE)
+        updateRowWidth(newRow);
+
+    updateRowsHeight();
+    mUpdateTime = 0;
+    updateHeight();
+}
+
+void BrowserBox::trimRows()
+{
+    if (mMaxRows == 0 || mTextRows.size() <= mMaxRows)
+        return;
+
+    int removed = 0;
+    while (mTextRows.size() > mMaxRows)
     {
-        std::string plain = newRow;
-        for (idx1 = plain.find("##");
-             idx1 != std::string::npos;
-             idx1 = plain.find("##"))
+        mTextRows.pop_front();
+        int cnt = mTextRowLinksCount.front();
+        mTextRowLinksCount.pop_front();
+        removed ++;
+
+        while (cnt && !mLinks.empty())
         {
-            plain.erase(idx1, 3);
+            mLinks.erase(mLinks.begin());
+            cnt --;
         }
+    }
 
-        // Adjust the BrowserBox size
-        int w = font->getWidth(plain);
-        if (w > getWidth())
-            setWidth(w);
+    // links of left rows move up
+    const int offset = removed * getFont()->getHeight();
+    for (LinkIterator it = mLinks.begin(), it_end = mLinks.end();
+         it != it_end; ++ it)
+    {
+        (*it).y1 -= offset;
+        (*it).y2 -= offset;
     }
+}
 
+void BrowserBox::updateRowsHeight()
+{
+    gcn::Font *font = getFont();
     if (mMode == AUTO_WRAP)
     {
         unsigned int y = 0;
@@ -267,8 +304,79 @@ void BrowserBox::addRow(const std::string &row, bool atTop)
     {
         setHeight(font->getHeight() * static_cast<int>(mTextRows.size()));
     }
+}
+
+void BrowserBox::insertRow(const int index, const std::string &row)
+{
+    if (getWidth() < 0 || index < 0)
+        return;
+
+    TextRowIterator rowIt = mTextRows.begin();
+    std::list<int>::iterator countIt = mTextRowLinksCount.begin();
+    size_t linkPos = 0;
+    int f;
+    for (f = 0; f < index && rowIt != mTextRows.end(); f ++)
+    {
+        linkPos += *countIt;
+        ++ rowIt;
+        ++ countIt;
+    }
+
+    // links of next rows move one line down
+    const int fontHeight = getFont()->getHeight();
+    for (LinkIterator it = mLinks.begin() + linkPos, it_end = mLinks.end();
+         it != it_end; ++ it)
+    {
+        (*it).y1 += fontHeight;
+        (*it).y2 += fontHeight;
+    }
+
+    std::string newRow;
+    const int linksCount = parseRow(row, f, linkPos, newRow);
+    mTextRows.insert(rowIt, newRow);
+    mTextRowLinksCount.insert(countIt, linksCount);
+
+    trimRows();
+
+    if (mMode == AUTO_SIZE)
+        updateRowWidth(newRow);
+
+    updateRowsHeight();
+    mSelectedLink = -1;
+    mUpdateTime = 0;
+}
+
+void BrowserBox::removeRow(const int index)
+{
+    if (index < 0 || index >= static_cast<int>(mTextRows.size()))
+        return;
+
+    TextRowIterator rowIt = mTextRows.begin();
+    std::list<int>::iterator countIt = mTextRowLinksCount.begin();
+    size_t linkPos = 0;
+    for (int f = 0; f < index; f ++)
+    {
+        linkPos += *countIt;
+        ++ rowIt;
+        ++ countIt;
+    }
+
+    mLinks.erase(mLinks.begin() + linkPos,
+        mLinks.begin() + linkPos + *countIt);
+    mTextRows.erase(rowIt);
+    mTextRowLinksCount.erase(countIt);
+
+    // links of next rows move one line up
+    const int fontHeight = getFont()->getHeight();
+    for (LinkIterator it = mLinks.begin() + linkPos, it_end = mLinks.end();
+         it != it_end; ++ it)
+    {
+        (*it).y1 -= fontHeight;
+        (*it).y2 -= fontHeight;
+    }
+
+    mSelectedLink = -1;
     mUpdateTime = 0;
-    updateHeight();
 }
 
 void BrowserBox::addRow(const std::string &cmd, char *text)
@@ -125,6 +125,18 @@ class BrowserBox : public gcn::Widget,
 
         void addImage(const std::string &path);
 
+        /**
+         * Inserts a text row before row with given index. Wrapping and row
+         * limit are applied like in addRow. Call updateHeight after all
+         * changes.
+         */
+        void insertRow(const int index, const std::string &row);
+
+        /**
+         * Removes row with given index. Call updateHeight after all changes.
+         */
+        void removeRow(const int index);
+
         /**
          * Remove all rows.
          */
@@ -191,6 +203,9 @@ class BrowserBox : public gcn::Widget,
         bool hasRows() const
         { return !mTextRows.empty(); }
 
+        const std::vector<BROWSER_LINK> &getLinks() const
+        { return mLinks; }
+
         void setAlwaysUpdate(bool n)
         { mAlwaysUpdate = n; }
 
@@ -205,6 +220,25 @@ class BrowserBox : public gcn::Widget,
     private:
         int calcHeight();
 
+        /**
+         * Converts links in row and stores them at linkPos in links list.
+         * Returns number of added links.
+         */
+        int parseRow(const std::string &row, const int rowIndex,
+                     const size_t linkPos, std::string &newRow);
+
+        void updateRowWidth(const std::string &newRow);
+
+        /**
+         * Removes oldest rows if row limit is set.
+         */
+        void trimRows();
+
+        /**
+         * Sets height from rows count, with wrapped lines in AUTO_WRAP mode.
+         */
+        void updateRowsHeight();
+
         typedef TextRows::iterator TextRowIterator;
         typedef TextRows::const_iterator TextRowCIter;
         TextRows mTextRows;
@@ -26,6 +26,8 @@
 
 #include "gtest/gtest.h"
 
+#include <guichan/font.hpp>
+
 #include <physfs.h>
 
 #include <list>
@@ -107,3 +109,87 @@ TEST(browserbox, test1)
     box->addRow(row);
     row = "11|22##><##";
 }
+
+TEST(browserbox, insertRemove)
+{
+    PHYSFS_init("manaplus");
+    logger = new Logger();
+    Theme::instance();
+    BrowserBox *box = new BrowserBox(BrowserBox::AUTO_SIZE);
+    box->setWidth(100);
+    box->addRow("a");
+    box->addRow("@@c|c@@");
+    box->insertRow(1, "b");
+    box->insertRow(3, "d");
+    box->insertRow(0, "@@0|0@@");
+
+    std::list<std::string> &rows = box->getRows();
+    EXPECT_EQ(5U, rows.size());
+    std::list<std::string>::const_iterator it = rows.begin();
+    EXPECT_EQ("##<0", *it++);
+    EXPECT_EQ("a", *it++);
+    EXPECT_EQ("b", *it++);
+    EXPECT_EQ("##<c", *it++);
+    EXPECT_EQ("d", *it++);
+
+    box->removeRow(3);
+    box->removeRow(0);
+    box->removeRow(10);
+    EXPECT_EQ(3U, rows.size());
+    it = rows.begin();
+    EXPECT_EQ("a", *it++);
+    EXPECT_EQ("b", *it++);
+    EXPECT_EQ("d", *it++);
+    delete box;
+}
+
+TEST(browserbox, insertLinks)
+{
+    PHYSFS_init("manaplus");
+    logger = new Logger();
+    Theme::instance();
+    BrowserBox *box = new BrowserBox(BrowserBox::AUTO_SIZE);
+    box->setWidth(100);
+    const int height = box->getFont()->getHeight();
+    box->addRow("a");
+    box->addRow("@@c|c@@");
+    box->insertRow(0, "@@0|0@@");
+    box->insertRow(2, "b");
+
+    const std::vector<BROWSER_LINK> &links = box->getLinks();
+    EXPECT_EQ(2U, links.size());
+    EXPECT_EQ("0", links[0].link);
+    EXPECT_EQ(0, links[0].y1);
+    EXPECT_EQ(height, links[0].y2);
+    EXPECT_EQ("c", links[1].link);
+    EXPECT_EQ(3 * height, links[1].y1);
+    EXPECT_EQ(4 * height, links[1].y2);
+    EXPECT_EQ(4 * height, box->getHeight());
+
+    // row limit drops oldest rows and their links
+    box->setMaxRow(3);
+    box->insertRow(4, "@@e|e@@");
+    EXPECT_EQ(3U, box->getRows().size());
+    EXPECT_EQ(2U, links.size());
+    EXPECT_EQ("c", links[0].link);
+    EXPECT_EQ(height, links[0].y1);
+    EXPECT_EQ("e", links[1].link);
+    EXPECT_EQ(2 * height, links[1].y1);
+    EXPECT_EQ(3 * height, box->getHeight());
+    delete box;
+}
+
+TEST(browserbox, insertWrap)
+{
+    PHYSFS_init("manaplus");
+    logger = new Logger();
+    Theme::instance();
+    BrowserBox *box = new BrowserBox(BrowserBox::AUTO_WRAP);
+    box->setWidth(50);
+    const int height = box->getFont()->getHeight();
+    box->addRow("a");
+    box->insertRow(0, "long row long row long row long row long row");
+    EXPECT_EQ(2U, box->getRows().size());
+    EXPECT_LT(2 * height, box->getHeight());
+    delete box;
+}
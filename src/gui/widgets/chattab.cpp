@@ -287,9 +287,11 @@ void ChatTab::chatLog(std::string line, Own own,
 
         if (this != getTabbedArea()->getSelectedTab())
         {
+            const bool highlight = chatWindow
+                && chatWindow->findHighlight(tmp.text);
             if (getFlash() == 0)
             {
-                if (chatWindow && chatWindow->findHighlight(tmp.text))
+                if (highlight)
                 {
                     setFlash(2);
                     sound.playGuiSound(SOUND_HIGHLIGHT);
@@ -301,7 +303,7 @@ void ChatTab::chatLog(std::string line, Own own,
             }
             else if (getFlash() == 2)
             {
-                if (chatWindow && chatWindow->findHighlight(tmp.text))
+                if (highlight)
                     sound.playGuiSound(SOUND_HIGHLIGHT);
             }
         }
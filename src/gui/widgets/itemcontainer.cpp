@@ -46,6 +46,7 @@
 #include "resources/image.h"
 #include "resources/iteminfo.h"
 
+#include "utils/objectpool.h"
 #include "utils/stringutils.h"
 
 #include <guichan/mouseinput.hpp>
@@ -61,6 +62,8 @@ static const int BOX_HEIGHT = 43;
 
 class ItemIdPair
 {
+    DECLARE_POOLED_OBJECT
+
     public:
         ItemIdPair(int id, Item* item) :
             mId(id), mItem(item)
@@ -71,6 +74,8 @@ class ItemIdPair
         Item* mItem;
 };
 
+IMPLEMENT_POOLED_OBJECT(ItemIdPair, "ItemIdPair", 128)
+
 class SortItemAlphaFunctor
 {
     public:
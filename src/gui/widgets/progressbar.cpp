@@ -39,6 +39,8 @@
 
 #include <guichan/font.hpp>
 
+#include <math.h>
+
 #include "debug.h"
 
 ImageRect ProgressBar::mBorder;
@@ -52,6 +54,9 @@ ProgressBar::ProgressBar(float progress,
     mSmoothProgress(true),
     mProgressPalette(color),
     mSmoothColorChange(true),
+    mTextValue1(0),
+    mTextValue2(0),
+    mHaveTextValues(false),
     mVertexes(new GraphicsVertexes()),
     mRedraw(true)
 {
@@ -114,6 +119,13 @@ ProgressBar::~ProgressBar()
 
 void ProgressBar::logic()
 {
+    // nothing to animate for idle bars
+    if (mProgressToGo == mProgress && mColorToGo.r == mColor.r
+        && mColorToGo.g == mColor.g && mColorToGo.b == mColor.b)
+    {
+        return;
+    }
+
     if (mSmoothColorChange && mColorToGo != mColor)
     {
         // Smoothly changing the color for a nicer effect.
@@ -134,9 +146,12 @@ void ProgressBar::logic()
     if (mSmoothProgress && mProgressToGo != mProgress)
     {
         // Smoothly showing the progressbar changes.
-        if (mProgressToGo > mProgress)
+        // Last step snaps to target, so bar becomes idle.
+        if (fabs(mProgressToGo - mProgress) <= 0.005f)
+            mProgress = mProgressToGo;
+        else if (mProgressToGo > mProgress)
             mProgress = std::min(1.0f, mProgress + 0.005f);
-        if (mProgressToGo < mProgress)
+        else
             mProgress = std::max(0.0f, mProgress - 0.005f);
     }
 }
@@ -184,6 +199,17 @@ void ProgressBar::setProgress(float progress)
         mColorToGo = Theme::getProgressColor(mProgressPalette, progress);
 }
 
+bool ProgressBar::setTextValues(const int value1, const int value2)
+{
+    if (mHaveTextValues && mTextValue1 == value1 && mTextValue2 == value2)
+        return false;
+
+    mHaveTextValues = true;
+    mTextValue1 = value1;
+    mTextValue2 = value2;
+    return true;
+}
+
 void ProgressBar::setProgressPalette(int progressPalette)
 {
     int oldPalette = mProgressPalette;
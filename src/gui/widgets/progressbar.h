@@ -99,6 +99,12 @@ class ProgressBar : public gcn::Widget, public gcn::WidgetListener
         void setText(const std::string &str)
         { mText = str; }
 
+        /**
+         * Remembers values the bar text is formatted from. Returns false
+         * if they are same as last time and text need not be formatted.
+         */
+        bool setTextValues(const int value1, const int value2);
+
         /**
          * Returns the text shown on the progress bar.
          */
@@ -146,6 +152,9 @@ class ProgressBar : public gcn::Widget, public gcn::WidgetListener
         bool mSmoothColorChange;
 
         std::string mText;
+        int mTextValue1;
+        int mTextValue2;
+        bool mHaveTextValues;
         GraphicsVertexes *mVertexes;
         bool mRedraw;
 
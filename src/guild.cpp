@@ -323,6 +323,14 @@ void Guild::getNames(StringVect &names) const
 void Guild::addPos(int id, std::string name)
 {
     mPositions[id] = name;
+
+    // position names are shown in members addition string
+    for (MemberList::iterator it = mMembers.begin(),
+         it_end = mMembers.end(); it != it_end; ++ it)
+    {
+        if ((*it)->getPos() == id)
+            (*it)->changed();
+    }
 }
 
 Guild *Guild::getGuild(short id)
@@ -46,7 +46,7 @@ public:
     { return mPos; }
 
     void setPos(int pos)
-    { mPos = pos; }
+    { mPos = pos; changed(); }
 
     std::string getAdditionString() const;
 
@@ -70,6 +70,12 @@ public:
     bool updateNumber(unsigned num A_UNUSED)
     { return false; }
 
+    void *getHash()
+    { return mImage; }
+
+    Resource *getHashResource() const
+    { return mImage; }
+
 private:
     Image *mImage;
 };
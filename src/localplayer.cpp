@@ -1670,22 +1670,22 @@ void LocalPlayer::processEvent(Channels channel,
     {
         if (event.getName() == EVENT_UPDATEATTRIBUTE)
         {
-            switch (event.getInt("id"))
+            switch (event.attribute().id)
             {
                 case EXP:
                 {
-                    if (event.getInt("oldValue") > event.getInt("newValue"))
+                    if (event.attribute().oldValue > event.attribute().newValue)
                         break;
 
-                    int change = event.getInt("newValue")
-                                 - event.getInt("oldValue");
+                    int change = event.attribute().newValue
+                                 - event.attribute().oldValue;
 
                     if (change != 0)
                         addMessageToQueue(strprintf("%d %s", change, _("xp")));
                     break;
                 }
                 case LEVEL:
-                    mLevel = event.getInt("newValue");
+                    mLevel = event.attribute().newValue;
                     break;
                 default:
                     break;
@@ -1696,18 +1696,18 @@ void LocalPlayer::processEvent(Channels channel,
             if (!mShowJobExp)
                 return;
 
-            int id = event.getInt("id");
+            int id = event.stat().id;
             if (id == Net::getPlayerHandler()->getJobLocation())
             {
                 std::pair<int, int> exp
                     = PlayerInfo::getStatExperience(id);
-                if (event.getInt("oldValue1") > exp.first
-                    || !event.getInt("oldValue2"))
+                if (event.stat().oldValue1 > exp.first
+                    || !event.stat().oldValue2)
                 {
                     return;
                 }
 
-                int change = exp.first - event.getInt("oldValue1");
+                int change = exp.first - event.stat().oldValue1;
                 if (change != 0 && mMessages.size() < 20)
                 {
                     if (!mMessages.empty())
@@ -353,6 +353,9 @@ class LocalPlayer : public Being, public ActorSpriteListener,
 
         void navigateClean();
 
+        const Path &getNavigatePath() const
+        { return mNavigatePath; }
+
         void updateCoords();
 
         void imitateEmote(Being* being, unsigned char emote);
@@ -37,6 +37,8 @@
 #include <stdlib.h>
 #endif
 
+#include <SDL_thread.h>
+
 #include <sys/time.h>
 
 #include "debug.h"
@@ -44,7 +46,10 @@
 Logger::Logger():
     mLogToStandardOut(true),
     mChatWindow(nullptr),
-    mDebugLog(false)
+    mDebugLog(false),
+    mMutex(SDL_CreateMutex()),
+    mMainThread(SDL_ThreadID()),
+    mDelayedLog()
 {
 }
 
@@ -52,6 +57,7 @@ Logger::~Logger()
 {
     if (mLogFile.is_open())
         mLogFile.close();
+    SDL_DestroyMutex(mMutex);
 }
 
 void Logger::setLogFile(const std::string &logFilename)
@@ -98,14 +104,7 @@ void Logger::dlog(std::string str)
         << static_cast<int>((tv.tv_usec / 10000) % 100)
         << "] ";
 
-    if (mLogFile.is_open())
-        mLogFile << timeStr.str() << str << std::endl;
-
-    if (mLogToStandardOut)
-        std::cout << timeStr.str() << str << std::endl;
-
-    if (mChatWindow && debugChatTab)
-        debugChatTab->chatLog(str, BY_LOGGER);
+    write(timeStr.str(), str.c_str());
 }
 
 void Logger::log1(const char *buf)
@@ -130,14 +129,7 @@ void Logger::log1(const char *buf)
         << static_cast<int>((tv.tv_usec / 10000) % 100)
         << "] ";
 
-    if (mLogFile.is_open())
-        mLogFile << timeStr.str() << buf << std::endl;
-
-    if (mLogToStandardOut)
-        std::cout << timeStr.str() << buf << std::endl;
-
-    if (mChatWindow && debugChatTab)
-        debugChatTab->chatLog(buf, BY_LOGGER);
+    write(timeStr.str(), buf);
 }
 
 void Logger::log(const char *log_text, ...)
@@ -176,17 +168,46 @@ void Logger::log(const char *log_text, ...)
         << static_cast<int>((tv.tv_usec / 10000) % 100)
         << "] ";
 
+    write(timeStr.str(), buf);
+
+    // Delete temporary buffer
+    delete [] buf;
+}
+
+void Logger::write(const std::string &timeStr, const char *const buf)
+{
+    SDL_mutexP(mMutex);
     if (mLogFile.is_open())
-        mLogFile << timeStr.str() << buf << std::endl;
+        mLogFile << timeStr << buf << std::endl;
 
     if (mLogToStandardOut)
-        std::cout << timeStr.str() << buf << std::endl;
+        std::cout << timeStr << buf << std::endl;
+
+    // widgets can be used only from main thread
+    const bool mainThread = SDL_ThreadID() == mMainThread;
+    if (!mainThread && mChatWindow)
+        mDelayedLog.push_back(buf);
+    SDL_mutexV(mMutex);
 
-    if (mChatWindow && debugChatTab)
+    if (mainThread && mChatWindow && debugChatTab)
         debugChatTab->chatLog(buf, BY_LOGGER);
+}
 
-    // Delete temporary buffer
-    delete [] buf;
+void Logger::flush()
+{
+    StringVect messages;
+    SDL_mutexP(mMutex);
+    messages.swap(mDelayedLog);
+    SDL_mutexV(mMutex);
+
+    if (!mChatWindow || !debugChatTab)
+        return;
+
+    for (StringVectCIter it = messages.begin(), it_end = messages.end();
+         it != it_end; ++ it)
+    {
+        debugChatTab->chatLog(*it, BY_LOGGER);
+    }
 }
 
 // here string must be safe for any usage
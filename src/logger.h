@@ -24,10 +24,15 @@
 #define M_LOGGER_H
 
 #include "main.h"
+
+#include "utils/stringvector.h"
+
 #include <fstream>
 
 class ChatWindow;
 
+struct SDL_mutex;
+
 #ifdef ENABLEDEBUGLOG
 #define DEBUGLOG(msg) if (logger) logger->dlog(msg)
 #else
@@ -94,6 +99,12 @@ class Logger
         void setDebugLog(bool n)
         { mDebugLog = n; }
 
+        /**
+         * Shows in chat window messages logged by other threads.
+         * Must be called from main thread.
+         */
+        void flush();
+
         /**
          * Log an error and quit. The error will pop-up on Windows and Mac, and
          * will be printed to standard error everywhere else.
@@ -108,10 +119,18 @@ class Logger
             __attribute__ ((noreturn));
 
     private:
+        /**
+         * Writes timestamped message. Can be called from any thread.
+         */
+        void write(const std::string &timeStr, const char *const buf);
+
         std::ofstream mLogFile;
         bool mLogToStandardOut;
         ChatWindow *mChatWindow;
         bool mDebugLog;
+        SDL_mutex *mMutex;
+        unsigned int mMainThread;
+        StringVect mDelayedLog;
 };
 
 extern Logger *logger;
@@ -35,7 +35,9 @@
 #include "utils/stringutils.h"
 #include "utils/xml.h"
 
-#ifdef UNITTESTS
+#ifdef BENCHMARKS
+#include "test/benchmark.h"
+#elif defined(UNITTESTS)
 #include <gtest/gtest.h>
 #endif
 
@@ -214,7 +216,7 @@ static void parseOptions(int argc, char *argv[], Client::Options &options)
 extern "C" char const *_nl_locale_name_default(void);
 #endif
 
-#ifndef UNITTESTS
+#if !defined(UNITTESTS) && !defined(BENCHMARKS)
 // main for normal game usage
 int main(int argc, char *argv[])
 {
@@ -269,6 +271,14 @@ int main(int argc, char *argv[])
     }
 }
 
+#elif defined(BENCHMARKS)
+
+// main for benchmarks
+int main(int argc, char *argv[])
+{
+    return Benchmark::runAll(argc, argv);
+}
+
 #else
 
 // main for unit testing
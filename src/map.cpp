@@ -26,6 +26,7 @@
 #include "configuration.h"
 
 #include "logger.h"
+#include "mapchunkcache.h"
 #include "maplayer.h"
 #include "particle.h"
 #include "simpleanimation.h"
@@ -41,6 +42,7 @@
 
 #include "utils/dtor.h"
 #include "utils/mkdir.h"
+#include "utils/profiler.h"
 
 #include <limits.h>
 #include <physfs.h>
@@ -152,7 +154,9 @@ Map::Map(int width, int height, int tileWidth, int tileHeight):
     mDrawScrollY(-1),
     mRedrawMap(true),
     mBeingOpacity(false),
-    mCustom(false)
+    mCustom(false),
+    mUseChunkCache(config.getBoolValue("mapChunkCache")),
+    mChunkCache(nullptr)
 {
     const int size = mWidth * mHeight;
     for (int i = 0; i < NB_BLOCKTYPES; i++)
@@ -200,6 +204,8 @@ Map::~Map()
     delete mObjects;
     mObjects = nullptr;
     delete_all(mMapPortals);
+    delete mChunkCache;
+    mChunkCache = nullptr;
 }
 
 void Map::optionChanged(const std::string &value)
@@ -316,6 +322,7 @@ void Map::update(int ticks)
 
 void Map::draw(Graphics *graphics, int scrollX, int scrollY)
 {
+    PROFILER_SCOPE(ZONE_MAP_DRAW);
     if (!player_node)
         return;
 
@@ -390,10 +397,34 @@ void Map::draw(Graphics *graphics, int scrollX, int scrollY)
     else
     {
         bool overFringe = false;
+        const bool useChunks = !mOpenGL && mUseChunkCache
+            && mDebugFlags != MAP_SPECIAL && mDebugFlags != MAP_SPECIAL2;
+
+        if (useChunks)
+        {
+            if (!mChunkCache)
+            {
+                mChunkCache = new MapChunkCache(mWidth, mHeight);
+                if (!mChunkCache->init(mLayers, mTileAnimations))
+                {
+                    delete mChunkCache;
+                    mChunkCache = nullptr;
+                    mUseChunkCache = false;
+                }
+            }
+            if (mChunkCache)
+            {
+                mChunkCache->draw(graphics, startX, startY, endX, endY,
+                    scrollX, scrollY);
+            }
+        }
 
         for (LayersCIter layeri = mLayers.begin(), layeri_end = mLayers.end();
              layeri != layeri_end && !overFringe; ++ layeri)
         {
+            if (useChunks && mChunkCache && mChunkCache->isCached(*layeri))
+                continue;
+
             if ((*layeri)->isFringeLayer())
             {
                 (*layeri)->setSpecialLayer(mSpecialLayer);
@@ -1263,6 +1294,14 @@ void Map::updatePortalTile(const std::string &name, int type,
     }
 }
 
+void Map::addWarp(const std::string &map, int x, int y, int dx, int dy)
+{
+    const int width = dx / 32;
+    const int height = dy / 32;
+    mWarps.push_back(MapWarp(map, x / 32, y / 32,
+        width > 0 ? width : 1, height > 0 ? height : 1));
+}
+
 MapItem *Map::findPortalXY(int x, int y)
 {
     for (std::vector<MapItem*>::const_iterator it = mMapPortals.begin(),
@@ -33,6 +33,7 @@
 
 class Animation;
 class AmbientLayer;
+class MapChunkCache;
 class MapLayer;
 class Particle;
 class SimpleAnimation;
@@ -75,6 +76,26 @@ struct MetaTile
     unsigned char blockmask; /**< Blocking properties of this tile */
 };
 
+/**
+ * Warp area with known destination map. Coordinates are in tiles.
+ */
+struct MapWarp
+{
+    MapWarp(const std::string &map0, int x0, int y0,
+            int width0, int height0) :
+        map(map0), x(x0), y(y0), width(width0), height(height0)
+    {}
+
+    std::string map;
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+typedef std::vector<MapWarp> MapWarps;
+typedef MapWarps::const_iterator MapWarpsCIter;
+
 /**
  * Animation cycle of a tile image which changes the map accordingly.
  */
@@ -90,6 +111,9 @@ class TileAnimation
         void addAffectedTile(MapLayer *layer, int index)
         { mAffected.push_back(std::make_pair(layer, index)); }
 
+        const TilePairVector &getAffected() const
+        { return mAffected; }
+
     private:
         TilePairVector mAffected;
         SimpleAnimation *mAnimation;
@@ -339,6 +363,11 @@ class Map : public Properties, public ConfigListener
         std::vector<MapItem*> &getPortals()
         { return mMapPortals; }
 
+        void addWarp(const std::string &map, int x, int y, int dx, int dy);
+
+        const MapWarps &getWarps() const
+        { return mWarps; }
+
         /**
          * Gets the tile animation for a specific gid
          */
@@ -461,6 +490,7 @@ class Map : public Properties, public ConfigListener
         std::vector<ParticleEffectData> particleEffects;
 
         std::vector<MapItem*> mMapPortals;
+        MapWarps mWarps;
 
         std::map<int, TileAnimation*> mTileAnimations;
 
@@ -492,6 +522,8 @@ class Map : public Properties, public ConfigListener
         bool mRedrawMap;
         bool mBeingOpacity;
         bool mCustom;
+        bool mUseChunkCache;
+        MapChunkCache *mChunkCache;
 };
 
 #endif
@@ -0,0 +1,359 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mapchunkcache.h"
+
+#include "configuration.h"
+#include "graphics.h"
+#include "logger.h"
+#include "maplayer.h"
+
+#include "resources/image.h"
+#include "resources/imagehelper.h"
+
+#include <SDL.h>
+
+#include <algorithm>
+
+#include "debug.h"
+
+static const int chunk_tiles = 16;
+static const int chunk_size = chunk_tiles * 32;
+static const int chunk_bytes = chunk_size * chunk_size * 4;
+
+MapChunkCache::MapChunkCache(int width, int height) :
+    mWidth(width),
+    mHeight(height),
+    mChunksX((width + chunk_tiles - 1) / chunk_tiles),
+    mChunksY((height + chunk_tiles - 1) / chunk_tiles),
+    mMarginX(0),
+    mMarginY(0),
+    mMaxChunks(config.getIntValue("mapChunkCacheSize")
+        * 1024 * 1024 / chunk_bytes),
+    mFrame(0)
+{
+    const int size = mChunksX * mChunksY;
+    mChunks.resize(size, nullptr);
+    mChunkStates.resize(size, CHUNK_NONE);
+    mChunkUse.resize(size, 0);
+}
+
+MapChunkCache::~MapChunkCache()
+{
+    for (std::vector<int>::const_iterator it = mLoadedChunks.begin(),
+         it_end = mLoadedChunks.end(); it != it_end; ++ it)
+    {
+        delete mChunks[*it];
+    }
+    mLoadedChunks.clear();
+}
+
+bool MapChunkCache::init(const Layers &layers,
+                         const TileAnimationMap &animations)
+{
+    const int size = mWidth * mHeight;
+
+    for (LayersCIter it = layers.begin(), it_end = layers.end();
+         it != it_end; ++ it)
+    {
+        MapLayer *const layer = *it;
+        if (!layer)
+            continue;
+        if (layer->isFringeLayer())
+            break;
+        // tiles of shifted layers not match map cells
+        if (layer->mX || layer->mY || layer->mWidth != mWidth
+            || layer->mHeight != mHeight)
+        {
+            return false;
+        }
+        mLayers.push_back(layer);
+    }
+
+    if (mLayers.empty())
+        return false;
+
+    mDynamic.resize(size, false);
+    for (TileAnimationMapCIter it = animations.begin(),
+         it_end = animations.end(); it != it_end; ++ it)
+    {
+        if (!it->second)
+            continue;
+        const TilePairVector &tiles = it->second->getAffected();
+        for (TilePairVectorCIter it2 = tiles.begin(), it2_end = tiles.end();
+             it2 != it2_end; ++ it2)
+        {
+            if (isCached(it2->first) && it2->second >= 0
+                && it2->second < size)
+            {
+                mDynamic[it2->second] = true;
+            }
+        }
+    }
+
+    for (int f = 0; f < size; f ++)
+    {
+        if (mDynamic[f])
+            mDynamicTiles.push_back(f);
+    }
+
+    // big tiles can be drawn over neighbour chunks
+    for (std::vector<MapLayer*>::const_iterator it = mLayers.begin(),
+         it_end = mLayers.end(); it != it_end; ++ it)
+    {
+        Image **tiles = (*it)->mTiles;
+        for (int f = 0; f < size; f ++)
+        {
+            const Image *const img = tiles[f];
+            if (!img)
+                continue;
+            const int marginX = (img->getWidth() - 1) / 32;
+            const int marginY = (img->getHeight() - 1) / 32;
+            if (marginX > mMarginX)
+                mMarginX = marginX;
+            if (marginY > mMarginY)
+                mMarginY = marginY;
+        }
+    }
+
+    logger->log("map chunk cache: %d layers, %d animated tiles",
+        static_cast<int>(mLayers.size()),
+        static_cast<int>(mDynamicTiles.size()));
+    return true;
+}
+
+bool MapChunkCache::isCached(const MapLayer *layer) const
+{
+    return std::find(mLayers.begin(), mLayers.end(), layer) != mLayers.end();
+}
+
+void MapChunkCache::draw(Graphics *graphics, int startX, int startY,
+                         int endX, int endY, int scrollX, int scrollY)
+{
+    mFrame ++;
+
+    int chunkX1 = scrollX / chunk_size;
+    int chunkY1 = scrollY / chunk_size;
+    int chunkX2 = (scrollX + graphics->mWidth - 1) / chunk_size;
+    int chunkY2 = (scrollY + graphics->mHeight - 1) / chunk_size;
+
+    if (chunkX1 < 0)
+        chunkX1 = 0;
+    if (chunkY1 < 0)
+        chunkY1 = 0;
+    if (chunkX2 >= mChunksX)
+        chunkX2 = mChunksX - 1;
+    if (chunkY2 >= mChunksY)
+        chunkY2 = mChunksY - 1;
+
+    for (int y = chunkY1; y <= chunkY2; y ++)
+    {
+        for (int x = chunkX1; x <= chunkX2; x ++)
+        {
+            Image *const img = getChunk(x + y * mChunksX);
+            if (img)
+            {
+                graphics->drawImage(img, x * chunk_size - scrollX,
+                    y * chunk_size - scrollY);
+            }
+        }
+    }
+
+    if (mDynamicTiles.empty())
+        return;
+
+    if (startX < 0)
+        startX = 0;
+    if (startY < 0)
+        startY = 0;
+    if (endX > mWidth)
+        endX = mWidth;
+    if (endY > mHeight)
+        endY = mHeight;
+
+    // animated tiles are not in chunks
+    for (std::vector<MapLayer*>::const_iterator it = mLayers.begin(),
+         it_end = mLayers.end(); it != it_end; ++ it)
+    {
+        Image **tiles = (*it)->mTiles;
+        for (int y = startY; y < endY; y ++)
+        {
+            const int rowStart = y * mWidth;
+            const int py0 = (y + 1) * 32 - scrollY;
+            std::vector<int>::const_iterator it2 = std::lower_bound(
+                mDynamicTiles.begin(), mDynamicTiles.end(),
+                rowStart + startX);
+            const std::vector<int>::const_iterator it2_end
+                = mDynamicTiles.end();
+            for (; it2 != it2_end && *it2 < rowStart + endX; ++ it2)
+            {
+                Image *const img = tiles[*it2];
+                if (img)
+                {
+                    graphics->drawImage(img,
+                        (*it2 - rowStart) * 32 - scrollX,
+                        py0 - img->getHeight());
+                }
+            }
+        }
+    }
+}
+
+Image *MapChunkCache::getChunk(int index)
+{
+    mChunkUse[index] = mFrame;
+    switch (mChunkStates[index])
+    {
+        case CHUNK_LOADED:
+            return mChunks[index];
+        case CHUNK_EMPTY:
+            return nullptr;
+        default:
+            break;
+    }
+
+    Image *const img = renderChunk(index % mChunksX, index / mChunksX);
+    if (!img)
+    {
+        mChunkStates[index] = CHUNK_EMPTY;
+        return nullptr;
+    }
+
+    evictChunks();
+    mChunks[index] = img;
+    mChunkStates[index] = CHUNK_LOADED;
+    mLoadedChunks.push_back(index);
+    return img;
+}
+
+void MapChunkCache::evictChunks()
+{
+    while (static_cast<int>(mLoadedChunks.size()) >= mMaxChunks)
+    {
+        std::vector<int>::iterator oldest = mLoadedChunks.end();
+        for (std::vector<int>::iterator it = mLoadedChunks.begin(),
+             it_end = mLoadedChunks.end(); it != it_end; ++ it)
+        {
+            if (oldest == mLoadedChunks.end()
+                || mChunkUse[*it] < mChunkUse[*oldest])
+            {
+                oldest = it;
+            }
+        }
+
+        // never drop chunks visible in this frame
+        if (oldest == mLoadedChunks.end() || mChunkUse[*oldest] == mFrame)
+            return;
+
+        const int index = *oldest;
+        delete mChunks[index];
+        mChunks[index] = nullptr;
+        mChunkStates[index] = CHUNK_NONE;
+        mLoadedChunks.erase(oldest);
+    }
+}
+
+Image *MapChunkCache::renderChunk(int chunkX, int chunkY) const
+{
+    int startX = chunkX * chunk_tiles - mMarginX;
+    const int startY = chunkY * chunk_tiles;
+    int endX = (chunkX + 1) * chunk_tiles;
+    int endY = (chunkY + 1) * chunk_tiles + mMarginY;
+
+    if (startX < 0)
+        startX = 0;
+    if (endX > mWidth)
+        endX = mWidth;
+    if (endY > mHeight)
+        endY = mHeight;
+
+    bool found = false;
+    for (std::vector<MapLayer*>::const_iterator it = mLayers.begin(),
+         it_end = mLayers.end(); it != it_end && !found; ++ it)
+    {
+        Image **tiles = (*it)->mTiles;
+        for (int y = startY; y < endY && !found; y ++)
+        {
+            const int rowStart = y * mWidth;
+            for (int x = startX; x < endX; x ++)
+            {
+                if (tiles[rowStart + x] && !mDynamic[rowStart + x])
+                {
+                    found = true;
+                    break;
+                }
+            }
+        }
+    }
+    if (!found)
+        return nullptr;
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    const int rmask = 0xff000000;
+    const int gmask = 0x00ff0000;
+    const int bmask = 0x0000ff00;
+    const int amask = 0x000000ff;
+#else
+    const int rmask = 0x000000ff;
+    const int gmask = 0x0000ff00;
+    const int bmask = 0x00ff0000;
+    const int amask = 0xff000000;
+#endif
+
+    SDL_Surface *const surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+        chunk_size, chunk_size, 32, rmask, gmask, bmask, amask);
+    if (!surface)
+        return nullptr;
+
+    Graphics *const graphics = new Graphics();
+    graphics->setBlitMode(Graphics::BLIT_GFX);
+    graphics->setTarget(surface);
+    graphics->_beginDraw();
+
+    const int offsetX = chunkX * chunk_size;
+    const int offsetY = chunkY * chunk_size;
+
+    for (std::vector<MapLayer*>::const_iterator it = mLayers.begin(),
+         it_end = mLayers.end(); it != it_end; ++ it)
+    {
+        Image **tiles = (*it)->mTiles;
+        for (int y = startY; y < endY; y ++)
+        {
+            const int rowStart = y * mWidth;
+            const int py0 = (y + 1) * 32 - offsetY;
+            for (int x = startX; x < endX; x ++)
+            {
+                Image *const img = tiles[rowStart + x];
+                if (img && !mDynamic[rowStart + x])
+                {
+                    graphics->drawImage(img, x * 32 - offsetX,
+                        py0 - img->getHeight());
+                }
+            }
+        }
+    }
+
+    graphics->_endDraw();
+    delete graphics;
+
+    Image *const img = imageHelper->load(surface);
+    SDL_FreeSurface(surface);
+    return img;
+}
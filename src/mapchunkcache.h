@@ -0,0 +1,94 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPCHUNKCACHE_H
+#define MAPCHUNKCACHE_H
+
+#include "map.h"
+
+#include <vector>
+
+class Graphics;
+class Image;
+
+/**
+ * Software renderer cache of the static layers below the fringe layer.
+ * Tiles are composed into big chunk images on first view, animated tiles
+ * are drawn over the chunks.
+ */
+class MapChunkCache
+{
+    public:
+        /**
+         * Constructor, taking map size in tiles.
+         */
+        MapChunkCache(int width, int height);
+
+        ~MapChunkCache();
+
+        /**
+         * Collects cached layers and animated tiles. Returns false if
+         * map layers can't be cached.
+         */
+        bool init(const Layers &layers, const TileAnimationMap &animations);
+
+        /**
+         * Draws all cached layers. Tile range is same as in MapLayer::draw.
+         */
+        void draw(Graphics *graphics, int startX, int startY,
+                  int endX, int endY, int scrollX, int scrollY);
+
+        /**
+         * Returns true if layer is drawn by this cache.
+         */
+        bool isCached(const MapLayer *layer) const;
+
+    private:
+        enum ChunkState
+        {
+            CHUNK_NONE = 0,
+            CHUNK_LOADED,
+            CHUNK_EMPTY
+        };
+
+        Image *getChunk(int index);
+
+        Image *renderChunk(int chunkX, int chunkY) const;
+
+        void evictChunks();
+
+        std::vector<MapLayer*> mLayers;
+        std::vector<bool> mDynamic;
+        std::vector<int> mDynamicTiles;
+        std::vector<Image*> mChunks;
+        std::vector<char> mChunkStates;
+        std::vector<unsigned> mChunkUse;
+        std::vector<int> mLoadedChunks;
+        int mWidth;
+        int mHeight;
+        int mChunksX;
+        int mChunksY;
+        int mMarginX;
+        int mMarginY;
+        int mMaxChunks;
+        unsigned mFrame;
+};
+
+#endif
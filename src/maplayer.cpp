@@ -39,6 +39,8 @@
 
 #include "debug.h"
 
+IMPLEMENT_POOLED_OBJECT(MapRowVertexes, "MapRowVertexes", 64)
+
 MapLayer::MapLayer(int x, int y, int width, int height, bool fringeLayer):
     mX(x), mY(y),
     mWidth(width), mHeight(height),
@@ -28,6 +28,8 @@
 #include "position.h"
 #include "properties.h"
 
+#include "utils/objectpool.h"
+
 #include <string>
 #include <vector>
 
@@ -40,6 +42,8 @@ typedef std::vector<ImageVertexes*> MepRowImages;
 
 class MapRowVertexes
 {
+    DECLARE_POOLED_OBJECT
+
     public:
         MapRowVertexes()
         {
@@ -77,6 +81,7 @@ class MapLayer: public ConfigListener
 {
     public:
         friend class Map;
+        friend class MapChunkCache;
 
         /**
          * Constructor, taking layer origin, size and whether this layer is the
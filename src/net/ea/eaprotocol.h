@@ -65,6 +65,20 @@ enum
     EA_SPRITE_VECTOREND
 };
 
+// client packets with same id in tmwAthena and eAthena
+enum
+{
+    EA_CMSG_PLAYER_CHANGE_DEST = 0x0085,
+    EA_CMSG_PLAYER_CHANGE_ACT = 0x0089,
+    EA_CMSG_PLAYER_CHANGE_DIR = 0x009b,
+    EA_CMSG_ITEM_PICKUP = 0x009f,
+    EA_CMSG_SKILL_USE_BEING = 0x0113,
+    EA_CMSG_SKILL_USE_POSITION = 0x0116,
+    EA_CMSG_PLAYER_STOP_ATTACK = 0x0118,
+    EA_CMSG_SKILL_USE_MAP = 0x011b,
+    EA_CMSG_SKILL_USE_POSITION_MORE = 0x0190
+};
+
 static const int INVENTORY_OFFSET = 2;
 static const int STORAGE_OFFSET = 1;
 
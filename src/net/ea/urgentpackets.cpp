@@ -0,0 +1,49 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "net/ea/urgentpackets.h"
+
+#include "net/ea/eaprotocol.h"
+
+#include "debug.h"
+
+namespace Ea
+{
+
+bool isUrgentPacket(const int id)
+{
+    switch (id)
+    {
+        case EA_CMSG_PLAYER_CHANGE_DEST:
+        case EA_CMSG_PLAYER_CHANGE_DIR:
+        case EA_CMSG_PLAYER_CHANGE_ACT:
+        case EA_CMSG_PLAYER_STOP_ATTACK:
+        case EA_CMSG_SKILL_USE_BEING:
+        case EA_CMSG_SKILL_USE_POSITION:
+        case EA_CMSG_SKILL_USE_POSITION_MORE:
+        case EA_CMSG_SKILL_USE_MAP:
+        case EA_CMSG_ITEM_PICKUP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace Ea
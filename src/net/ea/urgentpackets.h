@@ -0,0 +1,35 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NET_EA_URGENTPACKETS_H
+#define NET_EA_URGENTPACKETS_H
+
+namespace Ea
+{
+
+/**
+ * Returns true for packets which must be sent without waiting for flush at
+ * end of frame (moving, attacks, skills, pickup).
+ */
+bool isUrgentPacket(const int id);
+
+} // namespace Ea
+
+#endif // NET_EA_URGENTPACKETS_H
@@ -46,6 +46,11 @@ class MessageOut : public Net::MessageOut
          */
         MessageOut(short id);
 
+        /**
+         * Destructor. Sends latency critical packets at once.
+         */
+        ~MessageOut();
+
         void writeInt16(int16_t value);        /**< Writes a short. */
 
         void writeInt32(int32_t value);        /**< Writes a long. */
@@ -63,6 +68,7 @@ class MessageOut : public Net::MessageOut
         void expand(size_t size);
 
         Network *mNetwork;
+        short mId;
 };
 
 }
@@ -30,11 +30,12 @@
 
 #include "net/eathena/protocol.h"
 
+#include "test/loadstats.h"
+
 #include "utils/gettext.h"
 #include "utils/stringutils.h"
 
 #include <assert.h>
-#include <sstream>
 
 #include "debug.h"
 
@@ -114,6 +115,10 @@ short packet_lengths[] =
 
 const unsigned int BUFFER_SIZE = 655360;
 
+// receive thread is woken by wakeUp, timeout is only fallback
+const uint32_t WAKE_WAIT_TIME = 10000;
+const uint32_t POLL_WAIT_TIME = 500;
+
 int networkThread(void *data)
 {
     Network *network = static_cast<Network*>(data);
@@ -130,6 +135,7 @@ Network *Network::mInstance = nullptr;
 
 Network::Network() :
     mSocket(nullptr),
+    mWakeSocket(nullptr),
     mInBuffer(new char[BUFFER_SIZE]),
     mOutBuffer(new char[BUFFER_SIZE]),
     mInSize(0),
@@ -140,6 +146,8 @@ Network::Network() :
 {
     SDLNet_Init();
 
+    mWakeSocket = new WakeSocket;
+
     mMutex = SDL_CreateMutex();
     mInstance = this;
 }
@@ -155,6 +163,9 @@ Network::~Network()
     mMutex = nullptr;
     mInstance = nullptr;
 
+    delete mWakeSocket;
+    mWakeSocket = nullptr;
+
     delete []mInBuffer;
     delete []mOutBuffer;
 
@@ -204,6 +215,7 @@ void Network::disconnect()
 
     if (mWorkerThread && SDL_GetThreadID(mWorkerThread))
     {
+        wakeUp();
         SDL_WaitThread(mWorkerThread, nullptr);
         mWorkerThread = nullptr;
     }
@@ -284,6 +296,8 @@ void Network::flush()
 
     int ret;
 
+    LoadStats::sent();
+
     SDL_mutexP(mMutex);
     ret = SDLNet_TCP_Send(mSocket, mOutBuffer, mOutSize);
     DEBUGLOG("Send " + toString(mOutSize) + " bytes");
@@ -409,11 +423,16 @@ bool Network::realConnect()
     return true;
 }
 
+void Network::wakeUp()
+{
+    mWakeSocket->wakeUp();
+}
+
 void Network::receive()
 {
     SDLNet_SocketSet set;
 
-    if (!(set = SDLNet_AllocSocketSet(1)))
+    if (!(set = SDLNet_AllocSocketSet(2)))
     {
         setError("Error in SDLNet_AllocSocketSet(): " +
             std::string(SDLNet_GetError()));
@@ -426,73 +445,77 @@ void Network::receive()
             std::string(SDLNet_GetError()));
     }
 
+    const bool canWake = mWakeSocket->addToSet(set);
+    if (canWake)
+    {
+        // drop wake data left from previous connection
+        mWakeSocket->clear();
+    }
+    else
+    {
+        logger->log("Error in SDLNet_AddSocket(): %s", SDLNet_GetError());
+    }
+    const uint32_t waitTime = canWake ? WAKE_WAIT_TIME : POLL_WAIT_TIME;
+
     while (mState == CONNECTED)
     {
-        // TODO Try to get this to block all the time while still being able
-        // to escape the loop
-        int numReady = SDLNet_CheckSockets(set, (static_cast<uint32_t>(500)));
+        const int numReady = SDLNet_CheckSockets(set, waitTime);
         int ret;
-        switch (numReady)
+        if (numReady == -1)
+            logger->log1("Error: SDLNet_CheckSockets");
+        if (numReady <= 0)
+            continue;
+
+        if (canWake && mWakeSocket->isReady())
+            mWakeSocket->clear();
+
+        if (!SDLNet_SocketReady(mSocket))
+            continue;
+
+        // Receive data from the socket
+        SDL_mutexP(mMutex);
+        ret = SDLNet_TCP_Recv(mSocket, mInBuffer + mInSize,
+                              BUFFER_SIZE - mInSize);
+
+        if (!ret)
         {
-            case -1:
-                logger->log1("Error: SDLNet_CheckSockets");
-                // FALLTHROUGH
-            case 0:
-                break;
-
-            case 1:
-                // Receive data from the socket
-                SDL_mutexP(mMutex);
-                ret = SDLNet_TCP_Recv(mSocket, mInBuffer + mInSize,
-                                      BUFFER_SIZE - mInSize);
-
-                if (!ret)
-                {
-                    // We got disconnected
-                    mState = IDLE;
-                    logger->log1("Disconnected.");
-                }
-                else if (ret < 0)
+            // We got disconnected
+            mState = IDLE;
+            logger->log1("Disconnected.");
+        }
+        else if (ret < 0)
+        {
+            setError(_("Connection to server terminated. ") +
+                     std::string(SDLNet_GetError()));
+        }
+        else
+        {
+//            DEBUGLOG("Receive " + toString(ret) + " bytes");
+            mInSize += ret;
+            if (mToSkip)
+            {
+                if (mInSize >= mToSkip)
                 {
-                    setError(_("Connection to server terminated. ") +
-                             std::string(SDLNet_GetError()));
+                    mInSize -= mToSkip;
+                    memmove(mInBuffer, mInBuffer + mToSkip, mInSize);
+                    mToSkip = 0;
                 }
                 else
                 {
-//                    DEBUGLOG("Receive " + toString(ret) + " bytes");
-                    mInSize += ret;
-                    if (mToSkip)
-                    {
-                        if (mInSize >= mToSkip)
-                        {
-                            mInSize -= mToSkip;
-                            memmove(mInBuffer, mInBuffer + mToSkip, mInSize);
-                            mToSkip = 0;
-                        }
-                        else
-                        {
-                            mToSkip -= mInSize;
-                            mInSize = 0;
-                        }
-                    }
+                    mToSkip -= mInSize;
+                    mInSize = 0;
                 }
-                SDL_mutexV(mMutex);
-                break;
-
-            default:
-                // more than one socket is ready..
-                // this should not happen since we only listen once socket.
-                std::stringstream errorStream;
-                errorStream << "Error in SDLNet_TCP_Recv(), " << numReady
-                            << " sockets are ready: " << SDLNet_GetError();
-                setError(errorStream.str());
-                break;
+            }
         }
+        SDL_mutexV(mMutex);
     }
 
     if (SDLNet_TCP_DelSocket(set, mSocket) == -1)
         logger->log("Error in SDLNet_DelSocket(): %s", SDLNet_GetError());
 
+    if (canWake)
+        mWakeSocket->delFromSet(set);
+
     SDLNet_FreeSocketSet(set);
 }
 
@@ -24,6 +24,7 @@
 #define NET_EATHENA_NETWORK_H
 
 #include "net/serverinfo.h"
+#include "net/wakesocket.h"
 
 #include "net/eathena/messagehandler.h"
 #include "net/eathena/messagein.h"
@@ -110,8 +111,16 @@ class Network
 
         void receive();
 
+        /**
+         * Wakes receive thread waiting for data.
+         */
+        void wakeUp();
+
         TCPsocket mSocket;
 
+        /** Local socket used to wake receive thread without poll timeout */
+        WakeSocket *mWakeSocket;
+
         ServerInfo mServer;
 
         char *mInBuffer, *mOutBuffer;
@@ -24,6 +24,8 @@
 
 #include "net/packetcounters.h"
 
+#include "net/ea/urgentpackets.h"
+
 #include "net/tmwa/network.h"
 
 #include "logger.h"
@@ -42,7 +44,8 @@ namespace TmwAthena
 {
 
 MessageOut::MessageOut(short id):
-    Net::MessageOut(id)
+    Net::MessageOut(id),
+    mId(id)
 {
     mNetwork = TmwAthena::Network::instance();
     mData = mNetwork->mOutBuffer + mNetwork->mOutSize;
@@ -50,6 +53,12 @@ MessageOut::MessageOut(short id):
     writeInt16(id);
 }
 
+MessageOut::~MessageOut()
+{
+    if (Ea::isUrgentPacket(mId))
+        mNetwork->flush();
+}
+
 void MessageOut::expand(size_t bytes)
 {
     mNetwork->mOutSize += static_cast<unsigned>(bytes);
@@ -28,13 +28,16 @@
 #include "net/messagehandler.h"
 #include "net/messagein.h"
 
+#include "net/tmwa/packetlengths.h"
 #include "net/tmwa/protocol.h"
 
+#include "test/loadstats.h"
+
 #include "utils/gettext.h"
+#include "utils/profiler.h"
 #include "utils/stringutils.h"
 
 #include <assert.h>
-#include <sstream>
 
 #include "debug.h"
 
@@ -43,55 +46,12 @@ namespace TmwAthena
 /** Warning: buffers and other variables are shared,
     so there can be only one connection active at a time */
 
-short packet_lengths[] =
-{
- 10,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-// #0x0040
-  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-  0,  50,   3,  -1,  55,  17,   3,  37,  46,  -1,  23,  -1,   3, 108,   3,   2,
-  3,  28,  19,  11,   3,  -1,   9,   5,  54,  53,  58,  60,  41,   2,   6,   6,
-// #0x0080
-  7,   3,   2,   2,   2,   5,  16,  12,  10,   7,  29,  23,  -1,  -1,  -1,   0,
-  7,  22,  28,   2,   6,  30,  -1,  -1,   3,  -1,  -1,   5,   9,  17,  17,   6,
- 23,   6,   6,  -1,  -1,  -1,  -1,   8,   7,   6,   7,   4,   7,   0,  -1,   6,
-  8,   8,   3,   3,  -1,   6,   6,  -1,   7,   6,   2,   5,   6,  44,   5,   3,
-// #0x00C0
-  7,   2,   6,   8,   6,   7,  -1,  -1,  -1,  -1,   3,   3,   6,   6,   2,  27,
-  3,   4,   4,   2,  -1,  -1,   3,  -1,   6,  14,   3,  -1,  28,  29,  -1,  -1,
- 30,  30,  26,   2,   6,  26,   3,   3,   8,  19,   5,   2,   3,   2,   2,   2,
-  3,   2,   6,   8,  21,   8,   8,   2,   2,  26,   3,  -1,   6,  27,  30,  10,
-// #0x0100
-  2,   6,   6,  30,  79,  31,  10,  10,  -1,  -1,   4,   6,   6,   2,  11,  -1,
- 10,  39,   4,  10,  31,  35,  10,  18,   2,  13,  15,  20,  68,   2,   3,  16,
-  6,  14,  -1,  -1,  21,   8,   8,   8,   8,   8,   2,   2,   3,   4,   2,  -1,
-  6,  86,   6,  -1,  -1,   7,  -1,   6,   3,  16,   4,   4,   4,   6,  24,  26,
-// #0x0140
- 22,  14,   6,  10,  23,  19,   6,  39,   8,   9,   6,  27,  -1,   2,   6,   6,
-110,   6,  -1,  -1,  -1,  -1,  -1,   6,  -1,  54,  66,  54,  90,  42,   6,  42,
- -1,  -1,  -1,  -1,  -1,  30,  -1,   3,  14,   3,  30,  10,  43,  14, 186, 182,
- 14,  30,  10,   3,  -1,   6, 106,  -1,   4,   5,   4,  -1,   6,   7,  -1,  -1,
-// #0x0180
-  6,   3,  106,  10,  10, 34,   0,   6,   8,   4,   4,   4,  29,  -1,  10,   6,
- 90,  86,  24,   6,  30, 102,   9,   4,   8,   4,  14,  10,   4,   6,   2,   6,
-  3,   3,  35,   5,  11,  26,  -1,   4,   4,   6,  10,  12,   6,  -1,   4,   4,
- 11,   7,  -1,  67,  12,  18, 114,   6,   3,   6,  26,  26,  26,  26,   2,   3,
-// #0x01C0
-  2,  14,  10,  -1,  22,  22,   4,   2,  13,  97,   0,   9,   9,  29,   6,  28,
-  8,  14,  10,  35,   6,   8,   4,  11,  54,  53,  60,   2,  -1,  47,  33,   6,
- 30,   8,  34,  14,   2,   6,  26,   2,  28,  81,   6,  10,  26,   2,  -1,  -1,
- -1,  -1,  20,  10,  32,   9,  34,  14,   2,   6,  48,  56,  -1,   4,   5,  10,
-// #0x0200
- 26,   0,   0,   0,  18,   0,   0,   0,   0,   0,   0,  19,  10,   0,   0,   0,
-  2,  -1,  16,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
- -1, 122,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-};
-
 const unsigned int BUFFER_SIZE = 655360;
 
+// receive thread is woken by wakeUp, timeout is only fallback
+const uint32_t WAKE_WAIT_TIME = 10000;
+const uint32_t POLL_WAIT_TIME = 500;
+
 int networkThread(void *data)
 {
     Network *network = static_cast<Network*>(data);
@@ -108,16 +68,20 @@ Network *Network::mInstance = nullptr;
 
 Network::Network() :
     mSocket(nullptr),
+    mWakeSocket(nullptr),
     mInBuffer(new char[BUFFER_SIZE]),
     mOutBuffer(new char[BUFFER_SIZE]),
     mInSize(0),
     mOutSize(0),
     mToSkip(0),
+    mInTime(0),
     mState(IDLE),
     mWorkerThread(nullptr)
 {
     SDLNet_Init();
 
+    mWakeSocket = new WakeSocket;
+
     mMutex = SDL_CreateMutex();
     mInstance = this;
 }
@@ -133,6 +97,9 @@ Network::~Network()
     mMutex = nullptr;
     mInstance = nullptr;
 
+    delete mWakeSocket;
+    mWakeSocket = nullptr;
+
     delete []mInBuffer;
     delete []mOutBuffer;
 
@@ -182,6 +149,7 @@ void Network::disconnect()
 
     if (mWorkerThread && SDL_GetThreadID(mWorkerThread))
     {
+        wakeUp();
         SDL_WaitThread(mWorkerThread, nullptr);
         mWorkerThread = nullptr;
     }
@@ -232,9 +200,25 @@ void Network::clearHandlers()
 
 void Network::dispatchMessages()
 {
+    PROFILER_SCOPE(ZONE_NETWORK);
+    const bool stats = LoadStats::isEnabled();
+    long long startTime = 0;
+    int latency = 0;
+    int packets = 0;
+
+    if (stats)
+    {
+        startTime = LoadStats::getTime();
+        SDL_mutexP(mMutex);
+        if (mInSize)
+            latency = static_cast<int>(startTime - mInTime);
+        SDL_mutexV(mMutex);
+    }
+
     while (messageReady())
     {
         MessageIn msg = getNextMessage();
+        packets ++;
 
         MessageHandlerIterator iter = mMessageHandlers.find(msg.getId());
 
@@ -253,6 +237,12 @@ void Network::dispatchMessages()
 
         skip(msg.getLength());
     }
+
+    if (stats)
+    {
+        LoadStats::dispatched(packets, latency,
+            static_cast<int>(LoadStats::getTime() - startTime));
+    }
 }
 
 void Network::flush()
@@ -262,6 +252,8 @@ void Network::flush()
 
     int ret;
 
+    LoadStats::sent();
+
     SDL_mutexP(mMutex);
     ret = SDLNet_TCP_Send(mSocket, mOutBuffer, mOutSize);
     DEBUGLOG("Send " + toString(mOutSize) + " bytes");
@@ -387,11 +379,16 @@ bool Network::realConnect()
     return true;
 }
 
+void Network::wakeUp()
+{
+    mWakeSocket->wakeUp();
+}
+
 void Network::receive()
 {
     SDLNet_SocketSet set;
 
-    if (!(set = SDLNet_AllocSocketSet(1)))
+    if (!(set = SDLNet_AllocSocketSet(2)))
     {
         setError("Error in SDLNet_AllocSocketSet(): " +
             std::string(SDLNet_GetError()));
@@ -404,73 +401,79 @@ void Network::receive()
             std::string(SDLNet_GetError()));
     }
 
+    const bool canWake = mWakeSocket->addToSet(set);
+    if (canWake)
+    {
+        // drop wake data left from previous connection
+        mWakeSocket->clear();
+    }
+    else
+    {
+        logger->log("Error in SDLNet_AddSocket(): %s", SDLNet_GetError());
+    }
+    const uint32_t waitTime = canWake ? WAKE_WAIT_TIME : POLL_WAIT_TIME;
+
     while (mState == CONNECTED)
     {
-        // TODO Try to get this to block all the time while still being able
-        // to escape the loop
-        int numReady = SDLNet_CheckSockets(set, (static_cast<uint32_t>(500)));
+        const int numReady = SDLNet_CheckSockets(set, waitTime);
         int ret;
-        switch (numReady)
+        if (numReady == -1)
+            logger->log1("Error: SDLNet_CheckSockets");
+        if (numReady <= 0)
+            continue;
+
+        if (canWake && mWakeSocket->isReady())
+            mWakeSocket->clear();
+
+        if (!SDLNet_SocketReady(mSocket))
+            continue;
+
+        // Receive data from the socket
+        SDL_mutexP(mMutex);
+        ret = SDLNet_TCP_Recv(mSocket, mInBuffer + mInSize,
+                              BUFFER_SIZE - mInSize);
+
+        if (!ret)
         {
-            case -1:
-                logger->log1("Error: SDLNet_CheckSockets");
-                // FALLTHROUGH
-            case 0:
-                break;
-
-            case 1:
-                // Receive data from the socket
-                SDL_mutexP(mMutex);
-                ret = SDLNet_TCP_Recv(mSocket, mInBuffer + mInSize,
-                                      BUFFER_SIZE - mInSize);
-
-                if (!ret)
-                {
-                    // We got disconnected
-                    mState = IDLE;
-                    logger->log1("Disconnected.");
-                }
-                else if (ret < 0)
+            // We got disconnected
+            mState = IDLE;
+            logger->log1("Disconnected.");
+        }
+        else if (ret < 0)
+        {
+            setError(_("Connection to server terminated. ") +
+                     std::string(SDLNet_GetError()));
+        }
+        else
+        {
+//            DEBUGLOG("Receive " + toString(ret) + " bytes");
+            if (!mInSize && LoadStats::isEnabled())
+                mInTime = LoadStats::getTime();
+            mInSize += ret;
+            if (mToSkip)
+            {
+                if (mInSize >= mToSkip)
                 {
-                    setError(_("Connection to server terminated. ") +
-                             std::string(SDLNet_GetError()));
+                    mInSize -= mToSkip;
+                    memmove(mInBuffer, mInBuffer + mToSkip, mInSize);
+                    mToSkip = 0;
                 }
                 else
                 {
-//                    DEBUGLOG("Receive " + toString(ret) + " bytes");
-                    mInSize += ret;
-                    if (mToSkip)
-                    {
-                        if (mInSize >= mToSkip)
-                        {
-                            mInSize -= mToSkip;
-                            memmove(mInBuffer, mInBuffer + mToSkip, mInSize);
-                            mToSkip = 0;
-                        }
-                        else
-                        {
-                            mToSkip -= mInSize;
-                            mInSize = 0;
-                        }
-                    }
+                    mToSkip -= mInSize;
+                    mInSize = 0;
                 }
-                SDL_mutexV(mMutex);
-                break;
-
-            default:
-                // more than one socket is ready..
-                // this should not happen since we only listen once socket.
-                std::stringstream errorStream;
-                errorStream << "Error in SDLNet_TCP_Recv(), " << numReady
-                            << " sockets are ready: " << SDLNet_GetError();
-                setError(errorStream.str());
-                break;
+            }
         }
+        SDL_mutexV(mMutex);
     }
 
     if (SDLNet_TCP_DelSocket(set, mSocket) == -1)
         logger->log("Error in SDLNet_DelSocket(): %s", SDLNet_GetError());
 
+    if (canWake)
+        mWakeSocket->delFromSet(set);
+
     SDLNet_FreeSocketSet(set);
 }
 
@@ -24,6 +24,7 @@
 #define NET_TA_NETWORK_H
 
 #include "net/serverinfo.h"
+#include "net/wakesocket.h"
 
 #include "net/tmwa/messagehandler.h"
 #include "net/tmwa/messagein.h"
@@ -111,8 +112,16 @@ class Network
 
         void receive();
 
+        /**
+         * Wakes receive thread waiting for data.
+         */
+        void wakeUp();
+
         TCPsocket mSocket;
 
+        /** Local socket used to wake receive thread without poll timeout */
+        WakeSocket *mWakeSocket;
+
         ServerInfo mServer;
 
         char *mInBuffer, *mOutBuffer;
@@ -120,6 +129,9 @@ class Network
 
         unsigned int mToSkip;
 
+        /** Arrival time of oldest not dispatched data (load stats only) */
+        long long mInTime;
+
         int mState;
         std::string mError;
 
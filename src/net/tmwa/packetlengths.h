@@ -0,0 +1,41 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2004-2009  The Mana World Development Team
+ *  Copyright (C) 2009-2010  The Mana Developers
+ *  Copyright (C) 2011-2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NET_TA_PACKETLENGTHS_H
+#define NET_TA_PACKETLENGTHS_H
+
+namespace TmwAthena
+{
+
+/**
+ * Packet lengths indexed by packet id. -1 means variable length packet
+ * (length stored in second word), 0 means unknown packet.
+ * Shared by client network code and the mock test server.
+ */
+extern short packet_lengths[];
+
+/** Number of entries in packet_lengths. */
+extern const unsigned int packet_lengths_size;
+
+} // namespace TmwAthena
+
+#endif // NET_TA_PACKETLENGTHS_H
@@ -0,0 +1,128 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "net/wakesocket.h"
+
+#include "logger.h"
+
+#ifdef WIN32
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include "debug.h"
+
+#ifdef WIN32
+typedef int socklen_t;
+#define closesocket_(s) closesocket(s)
+#else
+#define closesocket_(s) close(s)
+#endif
+
+WakeSocket::WakeSocket()
+{
+    mSocket.ready = 0;
+    mSocket.channel = INVALID_CHANNEL;
+
+    // winsock is initialised by SDLNet_Init
+    const Channel channel = socket(AF_INET, SOCK_DGRAM, 0);
+    if (channel == INVALID_CHANNEL)
+    {
+        logger->log1("WakeSocket: can't create socket");
+        return;
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t size = sizeof(address);
+
+    // connected to own address, so only own datagrams are received
+    if (bind(channel, reinterpret_cast<sockaddr*>(&address), size)
+        || getsockname(channel, reinterpret_cast<sockaddr*>(&address), &size)
+        || connect(channel, reinterpret_cast<sockaddr*>(&address), size))
+    {
+        logger->log1("WakeSocket: can't bind socket to loopback");
+        closesocket_(channel);
+        return;
+    }
+
+#ifdef WIN32
+    u_long mode = 1;
+    ioctlsocket(channel, FIONBIO, &mode);
+#else
+    fcntl(channel, F_SETFL, fcntl(channel, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    mSocket.channel = channel;
+}
+
+WakeSocket::~WakeSocket()
+{
+    if (isValid())
+        closesocket_(mSocket.channel);
+}
+
+bool WakeSocket::addToSet(SDLNet_SocketSet set)
+{
+    if (!isValid())
+        return false;
+    return SDLNet_AddSocket(set, reinterpret_cast<SDLNet_GenericSocket>(
+        &mSocket)) != -1;
+}
+
+void WakeSocket::delFromSet(SDLNet_SocketSet set)
+{
+    if (isValid())
+    {
+        SDLNet_DelSocket(set, reinterpret_cast<SDLNet_GenericSocket>(
+            &mSocket));
+    }
+}
+
+void WakeSocket::wakeUp()
+{
+    if (!isValid())
+        return;
+
+    const char data = 0;
+    if (send(mSocket.channel, &data, 1, 0) != 1)
+        logger->log1("WakeSocket: can't send wake data");
+}
+
+void WakeSocket::clear()
+{
+    if (!isValid())
+        return;
+
+    char buf[16];
+    while (recv(mSocket.channel, buf, sizeof(buf), 0) > 0)
+        continue;
+    mSocket.ready = 0;
+}
@@ -0,0 +1,90 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NET_WAKESOCKET_H
+#define NET_WAKESOCKET_H
+
+#include <SDL_net.h>
+
+#include <stdint.h>
+
+/**
+ * Loopback UDP socket used to wake thread waiting in SDLNet_CheckSockets.
+ * SDL_net binds UDP sockets on all interfaces, so this socket is created
+ * directly, bound to 127.0.0.1 and connected to itself. System drops
+ * datagrams from any other source.
+ */
+class WakeSocket
+{
+    public:
+        WakeSocket();
+
+        ~WakeSocket();
+
+        bool isValid() const
+        { return mSocket.channel != INVALID_CHANNEL; }
+
+        /**
+         * Adds socket to SDL_net socket set.
+         */
+        bool addToSet(SDLNet_SocketSet set);
+
+        void delFromSet(SDLNet_SocketSet set);
+
+        /**
+         * Returns true if SDLNet_CheckSockets found wake data.
+         */
+        bool isReady() const
+        { return mSocket.ready != 0; }
+
+        /**
+         * Wakes thread waiting for this socket. Can be called from any
+         * thread.
+         */
+        void wakeUp();
+
+        /**
+         * Drops received wake data.
+         */
+        void clear();
+
+    private:
+#ifdef WIN32
+        typedef uintptr_t Channel;
+        static const Channel INVALID_CHANNEL = ~static_cast<Channel>(0);
+#else
+        typedef int Channel;
+        static const Channel INVALID_CHANNEL = -1;
+#endif
+
+        /**
+         * Same layout as SDL_net sockets, SDLNet_CheckSockets uses only
+         * these fields of sockets in set.
+         */
+        struct GenericSocket
+        {
+            int ready;
+            Channel channel;
+        };
+
+        GenericSocket mSocket;
+};
+
+#endif  // NET_WAKESOCKET_H
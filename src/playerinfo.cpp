@@ -60,29 +60,31 @@ int mLevelProgress = 0;
 void triggerAttr(int id, int old)
 {
     DepricatedEvent event(EVENT_UPDATEATTRIBUTE);
-    event.setInt("id", id);
-    event.setInt("oldValue", old);
-    event.setInt("newValue", mData.mAttributes.find(id)->second);
-    DepricatedEvent::trigger(CHANNEL_ATTRIBUTES, event);
+    AttributeEventData &data = event.attribute();
+    data.id = id;
+    data.oldValue = old;
+    data.newValue = mData.mAttributes.find(id)->second;
+    DepricatedEvent::queue(CHANNEL_ATTRIBUTES, event);
 }
 
-void triggerStat(int id, const std::string &changed, int old1, int old2)
+void triggerStat(int id, const int changed, int old1, int old2)
 {
     StatMap::const_iterator it = mData.mStats.find(id);
     if (it == mData.mStats.end())
         return;
 
     DepricatedEvent event(EVENT_UPDATESTAT);
-    event.setInt("id", id);
+    StatEventData &data = event.stat();
     const Stat &stat = it->second;
-    event.setInt("base", stat.base);
-    event.setInt("mod", stat.mod);
-    event.setInt("exp", stat.exp);
-    event.setInt("expNeeded", stat.expNeed);
-    event.setString("changed", changed);
-    event.setInt("oldValue1", old1);
-    event.setInt("oldValue2", old2);
-    DepricatedEvent::trigger(CHANNEL_ATTRIBUTES, event);
+    data.id = id;
+    data.changed = changed;
+    data.base = stat.base;
+    data.mod = stat.mod;
+    data.exp = stat.exp;
+    data.expNeeded = stat.expNeed;
+    data.oldValue1 = old1;
+    data.oldValue2 = old2;
+    DepricatedEvent::queue(CHANNEL_ATTRIBUTES, event);
 }
 
 // --- Attributes -------------------------------------------------------------
@@ -120,7 +122,7 @@ void setStatBase(int id, int value, bool notify)
     int old = mData.mStats[id].base;
     mData.mStats[id].base = value;
     if (notify)
-        triggerStat(id, "base", old);
+        triggerStat(id, StatEventData::BASE, old);
 }
 
 int getStatMod(int id)
@@ -137,7 +139,7 @@ void setStatMod(int id, int value, bool notify)
     int old = mData.mStats[id].mod;
     mData.mStats[id].mod = value;
     if (notify)
-        triggerStat(id, "mod", old);
+        triggerStat(id, StatEventData::MOD, old);
 }
 
 int getStatEffective(int id)
@@ -175,7 +177,7 @@ void setStatExperience(int id, int have, int need, bool notify)
     stat.exp = have;
     stat.expNeed = need;
     if (notify)
-        triggerStat(id, "exp", oldExp, oldExpNeed);
+        triggerStat(id, StatEventData::EXP, oldExp, oldExpNeed);
 }
 
 // --- Inventory / Equipment --------------------------------------------------
@@ -284,7 +286,7 @@ void setTrading(bool trading)
     if (notify)
     {
         DepricatedEvent event(EVENT_TRADING);
-        event.setInt("trading", trading);
+        event.trading().trading = trading;
         DepricatedEvent::trigger(CHANNEL_STATUS, event);
     }
 }
@@ -321,7 +323,7 @@ public:
         {
             if (event.getName() == EVENT_STATECHANGE)
             {
-                int newState = event.getInt("newState");
+                int newState = event.state().newState;
 
                 if (newState == STATE_GAME)
                 {
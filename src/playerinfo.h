@@ -234,7 +234,7 @@ namespace PlayerInfo
 
     void triggerStat(int id);
 
-    void triggerStat(int id, const std::string &changed,
+    void triggerStat(int id, const int changed,
                      int old1, int old2 = 0);
 
     void setEquipmentBackend(Equipment::Backend *backend);
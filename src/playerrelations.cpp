@@ -32,6 +32,7 @@
 
 #include "utils/dtor.h"
 #include "utils/gettext.h"
+#include "utils/nametable.h"
 
 #include "debug.h"
 
@@ -44,8 +45,8 @@
 
 #define IGNORE_EMOTE_TIME 100
 
-typedef std::map<std::string, PlayerRelation *> PlayerRelations;
-typedef PlayerRelations::const_iterator PlayerRelationsCIter;
+typedef std::map<std::string, PlayerRelation *> PlayerRelationsMap;
+typedef PlayerRelationsMap::const_iterator PlayerRelationsMapCIter;
 typedef std::list<PlayerRelationsListener *> PlayerRelationListeners;
 typedef PlayerRelationListeners::const_iterator PlayerRelationListenersCIter;
 
@@ -134,12 +135,7 @@ PlayerRelationsManager::PlayerRelationsManager() :
 PlayerRelationsManager::~PlayerRelationsManager()
 {
     delete_all(mIgnoreStrategies);
-
-    for (PlayerRelationsCIter it = mRelations.begin(),
-         it_end = mRelations.end(); it != it_end; ++ it)
-    {
-        delete it->second;
-    }
+    delete_all(mRelations);
 }
 
 void PlayerRelationsManager::clear()
@@ -200,9 +196,20 @@ void PlayerRelationsManager::load(bool oldConfig)
                                 [ignore_strategy_index]);
     }
 
+    PlayerRelationsMap relations;
     cfg->getList<std::pair<std::string, PlayerRelation *>,
                    std::map<std::string, PlayerRelation *> *>
-        ("player",  &(mRelations), &player_conf_serialiser);
+        ("player",  &relations, &player_conf_serialiser);
+
+    for (PlayerRelationsMapCIter it = relations.begin(),
+         it_end = relations.end(); it != it_end; ++ it)
+    {
+        const int id = NameTable::intern(it->first);
+        if (id >= static_cast<int>(mRelations.size()))
+            mRelations.resize(id + 1, nullptr);
+        delete mRelations[id];
+        mRelations[id] = it->second;
+    }
 }
 
 
@@ -225,12 +232,20 @@ void PlayerRelationsManager::init()
 
 void PlayerRelationsManager::store()
 {
+    PlayerRelationsMap relations;
+    const int sz = static_cast<int>(mRelations.size());
+    for (int f = 0; f < sz; f ++)
+    {
+        if (mRelations[f])
+            relations[NameTable::getName(f)] = mRelations[f];
+    }
+
     serverConfig.setList<std::map<std::string,
         PlayerRelation *>::const_iterator,
         std::pair<std::string, PlayerRelation *>,
         std::map<std::string, PlayerRelation *> *>
         ("player",
-         mRelations.begin(), mRelations.end(),
+         relations.begin(), relations.end(),
          &player_conf_serialiser);
 
     serverConfig.setValue(DEFAULT_PERMISSIONS, mDefaultPermissions);
@@ -260,10 +275,23 @@ void PlayerRelationsManager::signalUpdate(const std::string &name)
     }
 }
 
+PlayerRelation *PlayerRelationsManager::findRelation(const int nameId) const
+{
+    if (nameId < 0 || nameId >= static_cast<int>(mRelations.size()))
+        return nullptr;
+    return mRelations[nameId];
+}
+
 unsigned int PlayerRelationsManager::checkPermissionSilently(
     const std::string &player_name, unsigned int flags)
 {
-    PlayerRelation *r = mRelations[player_name];
+    return checkPermissionSilently(NameTable::find(player_name), flags);
+}
+
+unsigned int PlayerRelationsManager::checkPermissionSilently(
+    const int nameId, unsigned int flags)
+{
+    const PlayerRelation *const r = findRelation(nameId);
     if (!r)
     {
         return mDefaultPermissions & flags;
@@ -301,9 +329,18 @@ bool PlayerRelationsManager::hasPermission(Being *being, unsigned int flags)
     if (!being)
         return false;
 
-    if (being->getType() == ActorSprite::PLAYER)
-        return hasPermission(being->getName(), flags) == flags;
-    return true;
+    if (being->getType() != ActorSprite::PLAYER)
+        return true;
+    if (!actorSpriteManager)
+        return false;
+
+    const unsigned int rejections = flags
+        & ~checkPermissionSilently(being->getNameId(), flags);
+
+    if (rejections && mIgnoreStrategy)
+        mIgnoreStrategy->ignore(being, rejections);
+
+    return rejections == 0;
 }
 
 bool PlayerRelationsManager::hasPermission(const std::string &name,
@@ -340,9 +377,13 @@ void PlayerRelationsManager::setRelation(const std::string &player_name,
         return;
     }
 
-    PlayerRelation *r = mRelations[player_name];
+    const int id = NameTable::intern(player_name);
+    if (id >= static_cast<int>(mRelations.size()))
+        mRelations.resize(id + 1, nullptr);
+
+    PlayerRelation *const r = mRelations[id];
     if (!r)
-        mRelations[player_name] = new PlayerRelation(relation);
+        mRelations[id] = new PlayerRelation(relation);
     else
         r->mRelation = relation;
 
@@ -353,11 +394,11 @@ StringVect * PlayerRelationsManager::getPlayers()
 {
     StringVect *retval = new StringVect();
 
-    for (PlayerRelationsCIter it = mRelations.begin(),
-         it_end = mRelations.end(); it != it_end; ++ it)
+    const int sz = static_cast<int>(mRelations.size());
+    for (int f = 0; f < sz; f ++)
     {
-        if (it->second)
-            retval->push_back(it->first);
+        if (mRelations[f])
+            retval->push_back(NameTable::getName(f));
     }
 
     sort(retval->begin(), retval->end(), playersSorter);
@@ -370,11 +411,11 @@ StringVect *PlayerRelationsManager::getPlayersByRelation(
 {
     StringVect *retval = new StringVect();
 
-    for (PlayerRelationsCIter it = mRelations.begin(),
-         it_end = mRelations.end(); it != it_end; ++ it)
+    const int sz = static_cast<int>(mRelations.size());
+    for (int f = 0; f < sz; f ++)
     {
-        if (it->second && it->second->mRelation == rel)
-            retval->push_back(it->first);
+        if (mRelations[f] && mRelations[f]->mRelation == rel)
+            retval->push_back(NameTable::getName(f));
     }
 
     sort(retval->begin(), retval->end(), playersSorter);
@@ -384,20 +425,29 @@ StringVect *PlayerRelationsManager::getPlayersByRelation(
 
 void PlayerRelationsManager::removePlayer(const std::string &name)
 {
-    if (mRelations[name])
-        delete mRelations[name];
-
-    mRelations.erase(name);
+    const int id = NameTable::find(name);
+    if (id >= 0 && id < static_cast<int>(mRelations.size()))
+    {
+        delete mRelations[id];
+        mRelations[id] = nullptr;
+    }
 
     signalUpdate(name);
 }
 
 
 PlayerRelation::Relation PlayerRelationsManager::getRelation(
-    const std::string &name)
+    const std::string &name) const
+{
+    return getRelation(NameTable::find(name));
+}
+
+PlayerRelation::Relation PlayerRelationsManager::getRelation(
+    const int nameId) const
 {
-    if (mRelations[name])
-        return mRelations[name]->mRelation;
+    const PlayerRelation *const r = findRelation(nameId);
+    if (r)
+        return r->mRelation;
 
     return PlayerRelation::NEUTRAL;
 }
@@ -559,7 +609,7 @@ bool PlayerRelationsManager::isGoodName(std::string name)
 
     const size_t size = name.size();
 
-    if (size < 3 || mRelations[name])
+    if (size < 3 || findRelation(NameTable::find(name)))
         return true;
 
     status = checkName(name);
@@ -579,7 +629,7 @@ bool PlayerRelationsManager::isGoodName(Being *being)
     const std::string name = being->getName();
     const size_t size = name.size();
 
-    if (size < 3 || mRelations[name])
+    if (size < 3 || findRelation(being->getNameId()))
         return true;
 
     status = checkName(name);
@@ -27,6 +27,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 class Being;
 
@@ -130,6 +131,9 @@ class PlayerRelationsManager
         unsigned int checkPermissionSilently(const std::string &player_name,
                                              unsigned int flags);
 
+        unsigned int checkPermissionSilently(const int nameId,
+                                             unsigned int flags);
+
         /**
          * Tests whether the player in question is being ignored for any of the
          * actions in the specified flags. If so, trigger appropriate side effects
@@ -148,7 +152,12 @@ class PlayerRelationsManager
         /**
          * Updates the relationship with this player.
          */
-        PlayerRelation::Relation getRelation(const std::string &name);
+        PlayerRelation::Relation getRelation(const std::string &name) const;
+
+        /**
+         * Returns relationship for interned name id (see NameTable).
+         */
+        PlayerRelation::Relation getRelation(const int nameId) const;
 
         /**
          * Deletes the information recorded for a player.
@@ -246,8 +255,11 @@ class PlayerRelationsManager
 
         bool checkName(const std::string &name) const;
 
+        PlayerRelation *findRelation(const int nameId) const;
+
         PlayerIgnoreStrategy *mIgnoreStrategy;
-        std::map<std::string, PlayerRelation *> mRelations;
+        // relations indexed by interned name id
+        std::vector<PlayerRelation *> mRelations;
         std::list<PlayerRelationsListener *> mListeners;
         std::vector<PlayerIgnoreStrategy *> mIgnoreStrategies;
 };
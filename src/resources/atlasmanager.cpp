@@ -0,0 +1,344 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "resources/atlasmanager.h"
+
+#ifdef USE_OPENGL
+
+#include "configuration.h"
+#include "logger.h"
+#include "openglgraphics.h"
+#include "opengl1graphics.h"
+
+#include "resources/image.h"
+#include "resources/imagehelper.h"
+#include "resources/openglimagehelper.h"
+#include "resources/resourcemanager.h"
+
+#include "utils/stringutils.h"
+
+#include "debug.h"
+
+std::vector<AtlasManager::AtlasPage*> AtlasManager::mPages;
+int AtlasManager::mPageSize = 0;
+int AtlasManager::mMaxImageSize = 0;
+int AtlasManager::mPageCounter = 0;
+bool AtlasManager::mEnabled = false;
+
+void AtlasManager::init()
+{
+    mEnabled = config.getBoolValue("useAtlases")
+        && OpenGLImageHelper::mUseOpenGL && OpenGLImageHelper::mTextureSize;
+    if (!mEnabled)
+        return;
+
+    mPageSize = OpenGLImageHelper::powerOfTwo(
+        config.getIntValue("atlasPageSize"));
+    mMaxImageSize = config.getIntValue("atlasImageSize");
+    if (mMaxImageSize * 2 > mPageSize)
+        mMaxImageSize = mPageSize / 2;
+    logger->log("Using atlas pages %dx%d for images up to %d pixels",
+        mPageSize, mPageSize, mMaxImageSize);
+}
+
+Image *AtlasManager::add(SDL_Surface *surface)
+{
+    if (!surface)
+        return nullptr;
+    return add(surface, surface->w, surface->h);
+}
+
+Image *AtlasManager::add(SDL_Surface *surface,
+                         const int width, const int height)
+{
+    if (!mEnabled || !surface)
+        return nullptr;
+
+    if (width <= 0 || height <= 0
+        || width > mMaxImageSize || height > mMaxImageSize)
+    {
+        return nullptr;
+    }
+
+    // one pixel gap, so filtering not mixes neighbour images
+    AtlasPage *page = nullptr;
+    int x = 0;
+    int y = 0;
+    for (std::vector<AtlasPage*>::const_iterator it = mPages.begin(),
+         it_end = mPages.end(); it != it_end; ++ it)
+    {
+        if (insert(*it, width + 1, height + 1, x, y))
+        {
+            page = *it;
+            break;
+        }
+    }
+    if (!page)
+    {
+        page = createPage();
+        if (!page || !insert(page, width + 1, height + 1, x, y))
+            return nullptr;
+    }
+
+    SDL_Surface *const rgba = OpenGLImageHelper::convertSurface(
+        surface, width, height);
+    if (!rgba)
+    {
+        logger->log1("Error, image convert failed: out of memory");
+        return nullptr;
+    }
+
+    bindPage(page);
+
+    if (SDL_MUSTLOCK(rgba))
+        SDL_LockSurface(rgba);
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rgba->pitch / 4);
+    glTexSubImage2D(OpenGLImageHelper::mTextureType, 0, x, y,
+        width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba->pixels);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    if (SDL_MUSTLOCK(rgba))
+        SDL_UnlockSurface(rgba);
+    if (rgba != surface)
+        SDL_FreeSurface(rgba);
+
+    return page->image->getSubImage(x, y, width, height);
+}
+
+void AtlasManager::bindPage(const AtlasPage *const page)
+{
+    if (OpenGLImageHelper::mUseOpenGL == 1)
+    {
+        OpenGLGraphics::bindTexture(OpenGLImageHelper::mTextureType,
+            page->image->mGLImage);
+    }
+    else if (OpenGLImageHelper::mUseOpenGL == 2)
+    {
+        OpenGL1Graphics::bindTexture(OpenGLImageHelper::mTextureType,
+            page->image->mGLImage);
+    }
+}
+
+bool AtlasManager::clearPage(AtlasPage *const page)
+{
+    // old pixels would be filtered into gaps around new images
+    void *const pixels = calloc(mPageSize * mPageSize, 4);
+    if (!pixels)
+        return false;
+    bindPage(page);
+    glTexSubImage2D(OpenGLImageHelper::mTextureType, 0, 0, 0,
+        mPageSize, mPageSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    free(pixels);
+
+    page->skyline.clear();
+    const SkylineNode node = {0, 0, mPageSize};
+    page->skyline.push_back(node);
+    return true;
+}
+
+static Resource *createPageImage(void *data)
+{
+    OpenGLImageHelper *const helper
+        = static_cast<OpenGLImageHelper*>(imageHelper);
+    const int size = *static_cast<int*>(data);
+    return helper->createTexture(size, size,
+        OpenGLImageHelper::TEXTURE_ATLAS);
+}
+
+AtlasManager::AtlasPage *AtlasManager::createPage()
+{
+    // page kept in resource cache, so it counted and released with other
+    // images. Atlas manager owns one reference.
+    Image *const image = static_cast<Image*>(
+        ResourceManager::getInstance()->get(
+        strprintf("atlas_page_%d", mPageCounter ++),
+        createPageImage, &mPageSize));
+    if (!image)
+    {
+        logger->log1("Error: cant create atlas page");
+        mEnabled = false;
+        return nullptr;
+    }
+
+    AtlasPage *const page = new AtlasPage;
+    page->image = image;
+    const SkylineNode node = {0, 0, mPageSize};
+    page->skyline.push_back(node);
+    mPages.push_back(page);
+    return page;
+}
+
+bool AtlasManager::insert(AtlasPage *const page,
+                          const int width, const int height,
+                          int &x, int &y)
+{
+    std::vector<SkylineNode> &skyline = page->skyline;
+    int bestY = mPageSize;
+    int bestWidth = mPageSize + 1;
+    int bestIndex = -1;
+
+    // bottom left rule: lowest position, then narrowest node
+    const unsigned int sz = static_cast<unsigned int>(skyline.size());
+    for (unsigned int f = 0; f < sz; f ++)
+    {
+        const int fitY = fitNode(page, f, width, height);
+        if (fitY < 0)
+            continue;
+        if (fitY < bestY || (fitY == bestY && skyline[f].width < bestWidth))
+        {
+            bestY = fitY;
+            bestWidth = skyline[f].width;
+            bestIndex = f;
+        }
+    }
+    if (bestIndex < 0)
+        return false;
+
+    x = skyline[bestIndex].x;
+    y = bestY;
+    const SkylineNode node = {x, y + height, width};
+    skyline.insert(skyline.begin() + bestIndex, node);
+
+    // cut nodes covered by new node
+    for (unsigned int f = bestIndex + 1; f < skyline.size(); )
+    {
+        SkylineNode &cur = skyline[f];
+        const SkylineNode &prev = skyline[f - 1];
+        const int prevEnd = prev.x + prev.width;
+        if (cur.x >= prevEnd)
+            break;
+        const int shrink = prevEnd - cur.x;
+        cur.x += shrink;
+        cur.width -= shrink;
+        if (cur.width > 0)
+            break;
+        skyline.erase(skyline.begin() + f);
+    }
+
+    // merge nodes with same height
+    for (unsigned int f = 0; f + 1 < skyline.size(); )
+    {
+        if (skyline[f].y == skyline[f + 1].y)
+        {
+            skyline[f].width += skyline[f + 1].width;
+            skyline.erase(skyline.begin() + f + 1);
+        }
+        else
+        {
+            f ++;
+        }
+    }
+    return true;
+}
+
+int AtlasManager::fitNode(const AtlasPage *const page,
+                          const unsigned int index,
+                          const int width, const int height)
+{
+    const std::vector<SkylineNode> &skyline = page->skyline;
+    if (skyline[index].x + width > mPageSize)
+        return -1;
+
+    int y = skyline[index].y;
+    int widthLeft = width;
+    const unsigned int sz = static_cast<unsigned int>(skyline.size());
+    for (unsigned int f = index; widthLeft > 0; f ++)
+    {
+        if (f >= sz)
+            return -1;
+        if (skyline[f].y > y)
+            y = skyline[f].y;
+        if (y + height > mPageSize)
+            return -1;
+        widthLeft -= skyline[f].width;
+    }
+    return y;
+}
+
+void AtlasManager::releaseUnused(const bool keepPage)
+{
+    bool kept = !keepPage;
+    for (std::vector<AtlasPage*>::iterator it = mPages.begin();
+         it != mPages.end(); )
+    {
+        AtlasPage *const page = *it;
+        if (page->image->getRefCount() == 1)
+        {
+            // no sub images left, so whole page is free again
+            if (!kept && clearPage(page))
+            {
+                kept = true;
+                ++ it;
+                continue;
+            }
+            page->image->decRef();
+            delete page;
+            it = mPages.erase(it);
+        }
+        else
+        {
+            ++ it;
+        }
+    }
+}
+
+void AtlasManager::clear()
+{
+    for (std::vector<AtlasPage*>::iterator it = mPages.begin(),
+         it_end = mPages.end(); it != it_end; ++ it)
+    {
+        AtlasPage *const page = *it;
+        page->image->decRef();
+        delete page;
+    }
+    mPages.clear();
+}
+
+#else
+
+#include "debug.h"
+
+void AtlasManager::init()
+{
+}
+
+Image *AtlasManager::add(SDL_Surface *surface A_UNUSED)
+{
+    return nullptr;
+}
+
+Image *AtlasManager::add(SDL_Surface *surface A_UNUSED,
+                         const int width A_UNUSED,
+                         const int height A_UNUSED)
+{
+    return nullptr;
+}
+
+void AtlasManager::releaseUnused(const bool keepPage A_UNUSED)
+{
+}
+
+void AtlasManager::clear()
+{
+}
+
+#endif
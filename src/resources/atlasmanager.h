@@ -0,0 +1,108 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATLASMANAGER_H
+#define ATLASMANAGER_H
+
+#include "localconsts.h"
+
+#include <SDL.h>
+
+#include <vector>
+
+class Image;
+
+/**
+ * Packs small images into shared atlas textures in OpenGL mode. Each
+ * packed image is sub image of atlas page, so many small images cost one
+ * texture and can be drawn without texture switches. Space of deleted
+ * images is not reused until whole page is empty. Empty page is cleared
+ * for reuse when orphans are cleaned, other empty pages are released.
+ */
+class AtlasManager
+{
+    public:
+        /**
+         * Reads settings. Must be called after OpenGL mode is set.
+         */
+        static void init();
+
+        /**
+         * Puts image into atlas and returns its sub image, or nullptr if
+         * image is too big or atlases are disabled.
+         */
+        static Image *add(SDL_Surface *surface);
+
+        /**
+         * Puts top left width x height part of surface into atlas.
+         */
+        static Image *add(SDL_Surface *surface,
+                          const int width, const int height);
+
+        /**
+         * Releases pages which are used only by atlas manager. If keepPage
+         * is set, one of them is cleared and kept for new images.
+         */
+        static void releaseUnused(const bool keepPage = false);
+
+        /**
+         * Releases all pages. Pages are deleted after their images.
+         */
+        static void clear();
+
+    private:
+        struct SkylineNode
+        {
+            int x;
+            int y;
+            int width;
+        };
+
+        struct AtlasPage
+        {
+            Image *image;
+            std::vector<SkylineNode> skyline;
+        };
+
+        static AtlasPage *createPage();
+
+        static void bindPage(const AtlasPage *const page);
+
+        /**
+         * Zeroes page texture and marks whole page free.
+         */
+        static bool clearPage(AtlasPage *const page);
+
+        static bool insert(AtlasPage *const page,
+                           const int width, const int height,
+                           int &x, int &y);
+
+        static int fitNode(const AtlasPage *const page,
+                           const unsigned int index,
+                           const int width, const int height);
+
+        static std::vector<AtlasPage*> mPages;
+        static int mPageSize;
+        static int mMaxImageSize;
+        static int mPageCounter;
+        static bool mEnabled;
+};
+
+#endif
@@ -185,9 +185,9 @@ int ColorDB::getHairSize()
     return mHairColorsSize;
 }
 
-std::map <int, ColorDB::ItemColor> *ColorDB::getColorsList(std::string name)
+std::map <int, ColorDB::ItemColor> *ColorDB::getColorsList(const std::string
+                                                            &name)
 {
-    std::map <int, ItemColor> colors;
     ColorListsIterator it = mColorLists.find(name);
 
     if (it != mColorLists.end())
@@ -72,7 +72,7 @@ namespace ColorDB
 
     int getHairSize();
 
-    std::map <int, ItemColor> *getColorsList(std::string name);
+    std::map <int, ItemColor> *getColorsList(const std::string &name);
 
     // Color DB
     typedef std::map<int, ItemColor> Colors;
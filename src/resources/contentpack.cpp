@@ -0,0 +1,565 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/contentpack.h"
+
+#include "logger.h"
+
+#include <physfs.h>
+#include <SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <vector>
+#include <zlib.h>
+
+#include <sys/stat.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "debug.h"
+
+static const char packMagic[4] = {'M', 'P', 'K', '1'};
+
+const char *ContentPack::mData = nullptr;
+unsigned int ContentPack::mSize = 0;
+const ContentPack::Entry *ContentPack::mEntries = nullptr;
+unsigned int ContentPack::mCount = 0;
+std::set<std::string> ContentPack::mArchives;
+std::vector<char> ContentPack::mShadowed;
+#ifdef WIN32
+void *ContentPack::mMapping = nullptr;
+#endif
+bool ContentPack::mMapped = false;
+
+static Uint32 hashName(const char *name, const size_t size)
+{
+    // FNV-1a
+    Uint32 hash = 2166136261U;
+    for (size_t f = 0; f < size; f ++)
+    {
+        hash ^= static_cast<unsigned char>(name[f]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static const char *skipSlashes(const std::string &fileName, size_t &size)
+{
+    size_t pos = 0;
+    while (pos < fileName.size() && fileName[pos] == '/')
+        pos ++;
+    size = fileName.size() - pos;
+    return fileName.c_str() + pos;
+}
+
+static bool isPackedFormat(const std::string &name)
+{
+    const size_t pos = name.rfind('.');
+    if (pos == std::string::npos)
+        return false;
+    const std::string ext = name.substr(pos + 1);
+    return ext == "png" || ext == "jpg" || ext == "ogg" || ext == "mp3"
+        || ext == "zip" || ext == "gz" || ext == "ttf";
+}
+
+static void collectFiles(const std::string &dir,
+                         const std::set<std::string> &archives,
+                         StringVect &files)
+{
+    char **list = PHYSFS_enumerateFiles(dir.c_str());
+    if (!list)
+        return;
+
+    for (char **i = list; *i; i++)
+    {
+        const std::string path = dir.empty() ? *i : dir + "/" + *i;
+        if (PHYSFS_isDirectory(path.c_str()))
+        {
+            collectFiles(path, archives, files);
+        }
+        else
+        {
+            const char *const realDir = PHYSFS_getRealDir(path.c_str());
+            if (realDir && archives.find(realDir) != archives.end())
+                files.push_back(path);
+        }
+    }
+    PHYSFS_freeList(list);
+}
+
+struct PackBuildEntry
+{
+    std::string name;
+    Uint32 hash;
+
+    bool operator<(const PackBuildEntry &entry) const
+    {
+        if (hash != entry.hash)
+            return hash < entry.hash;
+        return name < entry.name;
+    }
+};
+
+struct PackEntrySorter
+{
+    template<typename T>
+    bool operator() (const T &entry, const Uint32 hash) const
+    {
+        return entry.hash < hash;
+    }
+};
+
+bool ContentPack::load(const std::string &packName,
+                       const StringVect &archives,
+                       const bool compress)
+{
+    unload();
+    if (archives.empty())
+        return false;
+
+    const Uint32 signature = getSignature(archives);
+    if (map(packName))
+    {
+        const Header *const header = reinterpret_cast<const Header*>(mData);
+        if (header->signature == signature)
+        {
+            mArchives.insert(archives.begin(), archives.end());
+            updateShadows();
+            logger->log("Content pack mounted: %s (%u files)",
+                        packName.c_str(), mCount);
+            return true;
+        }
+        unload();
+    }
+
+    if (!build(packName, archives, signature, compress)
+        || !map(packName))
+    {
+        logger->log("Error: cant create content pack: %s",
+                    packName.c_str());
+        unload();
+        return false;
+    }
+    mArchives.insert(archives.begin(), archives.end());
+    updateShadows();
+    logger->log("Content pack built: %s (%u files)",
+                packName.c_str(), mCount);
+    return true;
+}
+
+void ContentPack::unload()
+{
+    if (mData)
+    {
+        if (mMapped)
+        {
+#ifdef WIN32
+            UnmapViewOfFile(mData);
+            CloseHandle(static_cast<HANDLE>(mMapping));
+            mMapping = nullptr;
+#else
+            munmap(const_cast<char*>(mData), mSize);
+#endif
+        }
+        else
+        {
+            free(const_cast<char*>(mData));
+        }
+    }
+    mData = nullptr;
+    mSize = 0;
+    mEntries = nullptr;
+    mCount = 0;
+    mArchives.clear();
+    mShadowed.clear();
+    mMapped = false;
+}
+
+Uint32 ContentPack::getSignature(const StringVect &archives)
+{
+    std::string str(packMagic, sizeof(packMagic));
+    for (StringVectCIter it = archives.begin(), it_end = archives.end();
+         it != it_end; ++ it)
+    {
+        struct stat statbuf;
+        str += *it;
+        if (!stat((*it).c_str(), &statbuf))
+        {
+            char buf[64];
+            snprintf(buf, sizeof(buf), ":%ld:%ld;",
+                static_cast<long>(statbuf.st_size),
+                static_cast<long>(statbuf.st_mtime));
+            str += buf;
+        }
+    }
+    return static_cast<Uint32>(adler32(adler32(0L, Z_NULL, 0),
+        reinterpret_cast<const Bytef*>(str.c_str()),
+        static_cast<uInt>(str.size())));
+}
+
+bool ContentPack::build(const std::string &packName,
+                        const StringVect &archives,
+                        const Uint32 signature,
+                        const bool compress)
+{
+    const std::set<std::string> archiveSet(archives.begin(), archives.end());
+    StringVect files;
+    collectFiles("", archiveSet, files);
+
+    std::vector<PackBuildEntry> names;
+    names.reserve(files.size());
+    for (StringVectCIter it = files.begin(), it_end = files.end();
+         it != it_end; ++ it)
+    {
+        PackBuildEntry entry;
+        entry.name = *it;
+        entry.hash = hashName(entry.name.c_str(), entry.name.size());
+        names.push_back(entry);
+    }
+    std::sort(names.begin(), names.end());
+
+    const unsigned int count = static_cast<unsigned int>(names.size());
+    std::vector<Entry> entries(count);
+    Uint32 offset = static_cast<Uint32>(sizeof(Header)
+        + count * sizeof(Entry));
+    for (unsigned int f = 0; f < count; f ++)
+    {
+        entries[f].hash = names[f].hash;
+        entries[f].nameOffset = offset;
+        entries[f].nameSize = static_cast<Uint32>(names[f].name.size());
+        offset += entries[f].nameSize;
+    }
+
+    const std::string tmpName = packName + ".tmp";
+    FILE *const file = fopen(tmpName.c_str(), "wb");
+    if (!file)
+        return false;
+
+    bool ok = fseek(file, offset, SEEK_SET) == 0;
+    std::vector<char> buf;
+    std::vector<char> packed;
+    for (unsigned int f = 0; ok && f < count; f ++)
+    {
+        const std::string &name = names[f].name;
+        PHYSFS_file *const src = PHYSFS_openRead(name.c_str());
+        if (!src)
+        {
+            ok = false;
+            break;
+        }
+        const int size = static_cast<int>(PHYSFS_fileLength(src));
+        if (size >= 0)
+        {
+            buf.resize(size + 1);
+            ok = PHYSFS_read(src, &buf[0], 1, size) == size;
+        }
+        else
+        {
+            ok = false;
+        }
+        PHYSFS_close(src);
+        if (!ok)
+            break;
+
+        const char *data = &buf[0];
+        Entry &entry = entries[f];
+        entry.offset = offset;
+        entry.size = static_cast<Uint32>(size);
+        entry.packedSize = 0;
+
+        if (compress && size > 0 && !isPackedFormat(name))
+        {
+            uLongf packedSize = compressBound(size);
+            packed.resize(packedSize);
+            if (compress2(reinterpret_cast<Bytef*>(&packed[0]), &packedSize,
+                reinterpret_cast<const Bytef*>(data), size, 6) == Z_OK
+                && packedSize < static_cast<uLongf>(size) / 4 * 3)
+            {
+                data = &packed[0];
+                entry.packedSize = static_cast<Uint32>(packedSize);
+            }
+        }
+
+        const Uint32 dataSize = entry.packedSize
+            ? entry.packedSize : entry.size;
+        if (dataSize)
+            ok = fwrite(data, 1, dataSize, file) == dataSize;
+        offset += dataSize;
+    }
+
+    Header header;
+    memcpy(header.magic, packMagic, sizeof(packMagic));
+    header.signature = signature;
+    header.count = count;
+    header.size = offset;
+
+    if (ok)
+    {
+        ok = fseek(file, 0, SEEK_SET) == 0
+            && fwrite(&header, sizeof(Header), 1, file) == 1
+            && (!count || fwrite(&entries[0], sizeof(Entry), count, file)
+            == count);
+    }
+    for (unsigned int f = 0; ok && f < count; f ++)
+    {
+        const std::string &name = names[f].name;
+        ok = fwrite(name.c_str(), 1, name.size(), file) == name.size();
+    }
+    if (fclose(file))
+        ok = false;
+
+    if (!ok)
+    {
+        ::remove(tmpName.c_str());
+        return false;
+    }
+    ::remove(packName.c_str());
+    return ::rename(tmpName.c_str(), packName.c_str()) == 0;
+}
+
+bool ContentPack::map(const std::string &packName)
+{
+    unload();
+
+#ifdef WIN32
+    HANDLE file = CreateFileA(packName.c_str(), GENERIC_READ,
+        FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    mSize = static_cast<unsigned int>(GetFileSize(file, nullptr));
+    HANDLE mapping = nullptr;
+    if (mSize >= sizeof(Header))
+    {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY,
+            0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+    mData = static_cast<const char*>(MapViewOfFile(mapping,
+        FILE_MAP_READ, 0, 0, 0));
+    if (!mData)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    mMapping = mapping;
+    mMapped = true;
+#else
+    const int fd = open(packName.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    struct stat statbuf;
+    if (fstat(fd, &statbuf)
+        || statbuf.st_size < static_cast<off_t>(sizeof(Header)))
+    {
+        close(fd);
+        return false;
+    }
+    mSize = static_cast<unsigned int>(statbuf.st_size);
+    void *const ptr = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED)
+    {
+        mSize = 0;
+        return false;
+    }
+    mData = static_cast<const char*>(ptr);
+    mMapped = true;
+#endif
+
+    const Header *const header = reinterpret_cast<const Header*>(mData);
+    if (memcmp(header->magic, packMagic, sizeof(packMagic))
+        || header->size != mSize
+        || header->count > (mSize - sizeof(Header)) / sizeof(Entry))
+    {
+        logger->log("Error: wrong content pack: %s", packName.c_str());
+        unload();
+        return false;
+    }
+
+    mEntries = reinterpret_cast<const Entry*>(mData + sizeof(Header));
+    mCount = header->count;
+    for (unsigned int f = 0; f < mCount; f ++)
+    {
+        const Entry &entry = mEntries[f];
+        const Uint32 dataSize = entry.packedSize
+            ? entry.packedSize : entry.size;
+        if (entry.nameOffset > mSize || entry.nameSize > mSize
+            - entry.nameOffset || entry.offset > mSize
+            || dataSize > mSize - entry.offset)
+        {
+            logger->log("Error: wrong content pack: %s", packName.c_str());
+            unload();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ContentPack::updateShadows()
+{
+    mShadowed.assign(mCount, 0);
+    unsigned int shadowed = 0;
+    for (unsigned int f = 0; f < mCount; f ++)
+    {
+        const Entry &entry = mEntries[f];
+        const std::string name(mData + entry.nameOffset, entry.nameSize);
+        // file added later to other search path entry shadows pack
+        const char *const realDir = PHYSFS_getRealDir(name.c_str());
+        if (!realDir || mArchives.find(realDir) == mArchives.end())
+        {
+            mShadowed[f] = 1;
+            shadowed ++;
+        }
+    }
+    if (shadowed)
+        logger->log("Content pack: %u files shadowed", shadowed);
+}
+
+const ContentPack::Entry *ContentPack::findEntry(const std::string &fileName)
+{
+    if (!mEntries)
+        return nullptr;
+
+    size_t size;
+    const char *const name = skipSlashes(fileName, size);
+    const Uint32 hash = hashName(name, size);
+
+    const Entry *const end = mEntries + mCount;
+    for (const Entry *entry = std::lower_bound(mEntries, end, hash,
+         PackEntrySorter()); entry != end && entry->hash == hash; ++ entry)
+    {
+        if (entry->nameSize == size
+            && !memcmp(mData + entry->nameOffset, name, size))
+        {
+            if (mShadowed[entry - mEntries])
+                return nullptr;
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ContentPack::exists(const std::string &fileName)
+{
+    return findEntry(fileName) != nullptr;
+}
+
+const char *ContentPack::getData(const std::string &fileName, int &size)
+{
+    const Entry *const entry = findEntry(fileName);
+    if (!entry || entry->packedSize)
+        return nullptr;
+
+    size = static_cast<int>(entry->size);
+    return mData + entry->offset;
+}
+
+void *ContentPack::unpack(const Entry *const entry, int &fileSize)
+{
+    void *const buffer = calloc(entry->size + 1, 1);
+    if (!buffer)
+        return nullptr;
+
+    if (entry->packedSize)
+    {
+        uLongf size = entry->size;
+        if (uncompress(static_cast<Bytef*>(buffer), &size,
+            reinterpret_cast<const Bytef*>(mData + entry->offset),
+            entry->packedSize) != Z_OK || size != entry->size)
+        {
+            free(buffer);
+            return nullptr;
+        }
+    }
+    else
+    {
+        memcpy(buffer, mData + entry->offset, entry->size);
+    }
+    fileSize = static_cast<int>(entry->size);
+    return buffer;
+}
+
+void *ContentPack::loadFile(const std::string &fileName, int &fileSize)
+{
+    const Entry *const entry = findEntry(fileName);
+    if (!entry)
+        return nullptr;
+
+    void *const buffer = unpack(entry, fileSize);
+    if (!buffer)
+    {
+        logger->log("Error: broken file in content pack: %s",
+                    fileName.c_str());
+    }
+    return buffer;
+}
+
+static int closeBuffer(SDL_RWops *rw)
+{
+    if (rw)
+    {
+        free(rw->hidden.mem.base);
+        SDL_FreeRW(rw);
+    }
+    return 0;
+}
+
+SDL_RWops *ContentPack::openRead(const std::string &fileName,
+                                  const bool copy, bool &broken)
+{
+    broken = false;
+    const Entry *const entry = findEntry(fileName);
+    if (!entry)
+        return nullptr;
+
+    if (!entry->packedSize && !copy)
+    {
+        return SDL_RWFromConstMem(mData + entry->offset,
+            static_cast<int>(entry->size));
+    }
+
+    int size = 0;
+    void *const buffer = unpack(entry, size);
+    if (!buffer)
+    {
+        broken = true;
+        return nullptr;
+    }
+    SDL_RWops *const rw = SDL_RWFromMem(buffer, size);
+    if (!rw)
+    {
+        free(buffer);
+        return nullptr;
+    }
+    // buffer is freed together with rwops
+    rw->close = closeBuffer;
+    return rw;
+}
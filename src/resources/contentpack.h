@@ -0,0 +1,138 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONTENTPACK_H
+#define CONTENTPACK_H
+
+#include "localconsts.h"
+
+#include "utils/stringvector.h"
+
+#include <SDL_types.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+struct SDL_RWops;
+
+/**
+ * Single file pack with all files which update archives provide. Pack has
+ * index sorted by name hash, and is mapped into memory, so files are found
+ * unpacking update archives and stored entries are read without copying.
+ * Pack is built locally after updates, so it uses native byte order.
+ */
+class ContentPack
+{
+    public:
+        /**
+         * Mounts pack for given update archives, building it first if
+         * archives changed since last build. Pack entry is used only while
+         * PhysFS takes file from one of these archives, so files added
+         * later to other search path entries still win. See updateShadows.
+         */
+        static bool load(const std::string &packName,
+                         const StringVect &archives,
+                         const bool compress);
+
+        static void unload();
+
+        static bool isLoaded()
+        { return mData != nullptr; }
+
+        static bool exists(const std::string &fileName);
+
+        /**
+         * Marks entries which PhysFS takes from other search path entries.
+         * Must be called after search path changes.
+         */
+        static void updateShadows();
+
+        /**
+         * Returns file data without copying, if file is stored
+         * uncompressed, otherwise nullptr.
+         */
+        static const char *getData(const std::string &fileName, int &size);
+
+        /**
+         * Returns copy of file data, which caller must free.
+         */
+        static void *loadFile(const std::string &fileName, int &fileSize);
+
+        /**
+         * Opens file from pack for reading, or returns nullptr. Stored
+         * files are read from mapping, unless copy is set. Set copy for
+         * streams kept after loading, because pack is unmapped on reload.
+         * Sets broken if entry can't be unpacked. Not logs, so can be used
+         * from image streamer thread.
+         */
+        static SDL_RWops *openRead(const std::string &fileName,
+                                   const bool copy, bool &broken);
+
+    private:
+        struct Header
+        {
+            char magic[4];
+            Uint32 signature;
+            Uint32 count;
+            Uint32 size;
+        };
+
+        struct Entry
+        {
+            Uint32 hash;
+            Uint32 nameOffset;
+            Uint32 nameSize;
+            Uint32 offset;
+            Uint32 size;
+            // zero if entry is stored
+            Uint32 packedSize;
+        };
+
+        static Uint32 getSignature(const StringVect &archives);
+
+        static bool build(const std::string &packName,
+                          const StringVect &archives,
+                          const Uint32 signature,
+                          const bool compress);
+
+        static bool map(const std::string &packName);
+
+        static const Entry *findEntry(const std::string &fileName);
+
+        /**
+         * Returns copy of entry data or nullptr if entry is broken.
+         */
+        static void *unpack(const Entry *const entry, int &fileSize);
+
+        static const char *mData;
+        static unsigned int mSize;
+        static const Entry *mEntries;
+        static unsigned int mCount;
+        static std::set<std::string> mArchives;
+        // entries shadowed by other search path entries, by entry index
+        static std::vector<char> mShadowed;
+#ifdef WIN32
+        static void *mMapping;
+#endif
+        static bool mMapped;
+};
+
+#endif
@@ -25,10 +25,12 @@
 #include "logger.h"
 
 #include <math.h>
-#include <sstream>
 
 #include "debug.h"
 
+Dye::Dyes Dye::mDyes;
+Dye::Palettes Dye::mPalettes;
+
 DyePalette::DyePalette(const std::string &description)
 {
     int size = static_cast<int>(description.length());
@@ -95,6 +97,17 @@ DyePalette::DyePalette(const std::string &description)
     logger->log("Error, invalid embedded palette: %s", description.c_str());
 }
 
+const DyePalette *DyePalette::get(const std::string &description)
+{
+    Dye::Palettes::const_iterator it = Dye::mPalettes.find(description);
+    if (it != Dye::mPalettes.end())
+        return it->second;
+
+    DyePalette *const palette = new DyePalette(description);
+    Dye::mPalettes[description] = palette;
+    return palette;
+}
+
 /*
 void DyePalette::addFirstColor(const int color[3])
 {
@@ -290,7 +303,7 @@ Dye::Dye(const std::string &description)
                 logger->log("Error, invalid dye: %s", description.c_str());
                 return;
         }
-        mDyePalettes[i] = new DyePalette(description.substr(
+        mDyePalettes[i] = DyePalette::get(description.substr(
             pos + 2, next_pos - pos - 2));
         ++next_pos;
     }
@@ -299,11 +312,34 @@ Dye::Dye(const std::string &description)
 
 Dye::~Dye()
 {
-    for (int i = 0; i < dyePalateSize; ++i)
+}
+
+const Dye *Dye::get(const std::string &description)
+{
+    Dyes::const_iterator it = mDyes.find(description);
+    if (it != mDyes.end())
+        return it->second;
+
+    Dye *const dye = new Dye(description);
+    mDyes[description] = dye;
+    return dye;
+}
+
+void Dye::unload()
+{
+    for (Dyes::iterator it = mDyes.begin(),
+         it_end = mDyes.end(); it != it_end; ++ it)
     {
-        delete mDyePalettes[i];
-        mDyePalettes[i] = nullptr;
+        delete it->second;
+    }
+    mDyes.clear();
+
+    for (Palettes::iterator it = mPalettes.begin(),
+         it_end = mPalettes.end(); it != it_end; ++ it)
+    {
+        delete it->second;
     }
+    mPalettes.clear();
 }
 
 void Dye::update(int color[3]) const
@@ -337,8 +373,9 @@ void Dye::instantiate(std::string &target, const std::string &palettes)
 
     ++next_pos;
 
-    std::ostringstream s;
-    s << target.substr(0, next_pos);
+    std::string s;
+    s.reserve(target.length() + palettes.length() + 8);
+    s.append(target, 0, next_pos);
     size_t last_pos = target.length(), pal_pos = 0;
     do
     {
@@ -351,30 +388,32 @@ void Dye::instantiate(std::string &target, const std::string &palettes)
         if (next_pos == pos + 1 && pal_pos != std::string::npos)
         {
             size_t pal_next_pos = palettes.find(';', pal_pos);
-            s << target[pos] << ':';
+            s += target[pos];
+            s += ':';
             if (pal_next_pos == std::string::npos)
             {
-                s << palettes.substr(pal_pos);
-                s << target.substr(next_pos);
+                s.append(palettes, pal_pos, std::string::npos);
+                s.append(target, next_pos, std::string::npos);
                 //pal_pos = std::string::npos;
                 break;
             }
-            s << palettes.substr(pal_pos, pal_next_pos - pal_pos);
+            s.append(palettes, pal_pos, pal_next_pos - pal_pos);
             pal_pos = pal_next_pos + 1;
         }
         else if (next_pos > pos + 2)
         {
-            s << target.substr(pos, next_pos - pos);
+            s.append(target, pos, next_pos - pos);
         }
         else
         {
             logger->log("Error, invalid dye placeholder: %s", target.c_str());
             return;
         }
-        s << target[next_pos];
+        if (next_pos < last_pos)
+            s += target[next_pos];
         ++next_pos;
     }
     while (next_pos < last_pos);
 
-    target = s.str();
+    target.swap(s);
 }
@@ -23,6 +23,7 @@
 #ifndef DYE_H
 #define DYE_H
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,12 @@ class DyePalette
          */
         DyePalette(const std::string &pallete);
 
+        /**
+         * Returns shared palette for given string. Each palette string is
+         * parsed only once, palettes live until Dye::unload.
+         */
+        static const DyePalette *get(const std::string &pallete);
+
 /*
         void addFirstColor(const int color[3]);
 
@@ -103,6 +110,16 @@ class Dye
         static void instantiate(std::string &target,
                                 const std::string &palettes);
 
+        /**
+         * Returns shared dye for given description. Dyes are parsed once.
+         */
+        static const Dye *get(const std::string &dye);
+
+        /**
+         * Deletes all shared dyes and palettes.
+         */
+        static void unload();
+
         /**
          * Check if dye is special dye (S)
          */
@@ -112,17 +129,25 @@ class Dye
         /**
          * Return special dye palete (S)
          */
-        DyePalette *getSPalete() const
+        const DyePalette *getSPalete() const
         { return mDyePalettes[dyePalateSize - 1]; }
 
     private:
+        typedef std::map<std::string, Dye*> Dyes;
+        typedef std::map<std::string, DyePalette*> Palettes;
 
         /**
          * The order of the palettes, as well as their uppercase letter, is:
          *
          * Red, Green, Yellow, Blue, Magenta, White (or rather gray), Simple.
+         * Palettes are shared, see DyePalette::get.
          */
-        DyePalette *mDyePalettes[dyePalateSize];
+        const DyePalette *mDyePalettes[dyePalateSize];
+
+        static Dyes mDyes;
+        static Palettes mPalettes;
+
+        friend class DyePalette;
 };
 
 #endif
@@ -34,6 +34,7 @@
 #include "logger.h"
 #include "main.h"
 
+#include "utils/blitkernels.h"
 #include "utils/stringutils.h"
 
 #include "resources/imagehelper.h"
@@ -56,6 +57,8 @@ Image::Image(SDL_Surface *image, bool hasAlphaChannel0, uint8_t *alphaChannel):
 {
 #ifdef USE_OPENGL
     mGLImage = 0;
+    mTextureBytes = 0;
+    mTextureCategory = 0;
 #endif
 
     mUseAlphaCache = SDLImageHelper::mEnableAlphaCache;
@@ -93,7 +96,9 @@ Image::Image(GLuint glimage, int width, int height,
     mIsAlphaCalculated(false),
     mGLImage(glimage),
     mTexWidth(texWidth),
-    mTexHeight(texHeight)
+    mTexHeight(texHeight),
+    mTextureBytes(0),
+    mTextureCategory(0)
 {
     mBounds.x = 0;
     mBounds.y = 0;
@@ -151,6 +156,7 @@ void Image::unload()
 #ifdef USE_OPENGL
     if (mGLImage)
     {
+        OpenGLImageHelper::removeTexture(this);
         glDeleteTextures(1, &mGLImage);
         mGLImage = 0;
 #ifdef DEBUG_OPENGL_LEAKS
@@ -192,6 +198,14 @@ void Image::setAlpha(float alpha)
 
     if (mSDLSurface)
     {
+        if (mHasAlphaChannel && BlitKernels::canBlend(mSDLSurface,
+            SDL_GetVideoSurface()))
+        {
+            // alpha is applied by blit kernels while drawing
+            mAlpha = alpha;
+            return;
+        }
+
         if (mUseAlphaCache)
         {
             SDL_Surface *surface = getByAlpha(mAlpha);
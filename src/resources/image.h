@@ -59,6 +59,7 @@ class Image : public Resource
     friend class OpenGLImageHelper;
     friend class SDLImageHelper;
 #ifdef USE_OPENGL
+    friend class AtlasManager;
     friend class OpenGLGraphics;
     friend class OpenGL1Graphics;
 #endif
@@ -210,6 +211,10 @@ class Image : public Resource
 
         GLuint mGLImage;
         int mTexWidth, mTexHeight;
+
+        /** Texture memory owned by this image, zero for sub images. */
+        int mTextureBytes;
+        int mTextureCategory;
 #endif
 };
 
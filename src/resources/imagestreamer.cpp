@@ -0,0 +1,291 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/imagestreamer.h"
+
+#ifdef USE_OPENGL
+
+#include "configuration.h"
+#include "logger.h"
+
+#include "resources/atlasmanager.h"
+#include "resources/contentpack.h"
+#include "resources/dye.h"
+#include "resources/image.h"
+#include "resources/openglimagehelper.h"
+#include "resources/resourcemanager.h"
+
+#include "utils/physfsrwops.h"
+
+#include <SDL_image.h>
+
+#include "debug.h"
+
+SDL_Thread *ImageStreamer::mThread = nullptr;
+SDL_sem *ImageStreamer::mSemaphore = nullptr;
+Mutex ImageStreamer::mMutex;
+std::list<ImageStreamer::Request> ImageStreamer::mRequests;
+std::list<ImageStreamer::Ready> ImageStreamer::mReady;
+std::set<std::string> ImageStreamer::mPending;
+bool ImageStreamer::mQuit = false;
+
+bool ImageStreamer::request(const std::string &idPath)
+{
+    if (!imageHelper || !imageHelper->useOpenGL())
+        return false;
+
+    if (mPending.find(idPath) != mPending.end())
+        return true;
+
+    ResourceManager *const resman = ResourceManager::getInstance();
+    Resource *const res = resman->getFromCache(idPath);
+    if (res)
+    {
+        res->decRef();
+        return true;
+    }
+
+    if (!mThread)
+    {
+        mSemaphore = SDL_CreateSemaphore(0);
+        if (mSemaphore)
+            mThread = SDL_CreateThread(ImageStreamer::workerThread, nullptr);
+        if (!mThread)
+        {
+            logger->log1("Image streamer thread creation failed");
+            if (mSemaphore)
+            {
+                SDL_DestroySemaphore(mSemaphore);
+                mSemaphore = nullptr;
+            }
+            return false;
+        }
+    }
+
+    Request req;
+    req.idPath = idPath;
+    req.path = idPath;
+    req.dye = nullptr;
+
+    // dyes are created here, because Dye::get is not thread safe
+    const size_t pos = idPath.find('|');
+    if (pos != std::string::npos)
+    {
+        req.dye = Dye::get(idPath.substr(pos + 1));
+        req.path.erase(pos);
+    }
+
+    mPending.insert(idPath);
+    {
+        MutexLocker lock(&mMutex);
+        mRequests.push_back(req);
+    }
+    SDL_SemPost(mSemaphore);
+    return true;
+}
+
+bool ImageStreamer::isPending(const std::string &idPath)
+{
+    return mPending.find(idPath) != mPending.end();
+}
+
+int ImageStreamer::workerThread(void *ptr A_UNUSED)
+{
+    OpenGLImageHelper *const helper
+        = static_cast<OpenGLImageHelper*>(imageHelper);
+
+    while (true)
+    {
+        SDL_SemWait(mSemaphore);
+
+        Request req;
+        {
+            MutexLocker lock(&mMutex);
+            if (mQuit)
+                return 0;
+            if (mRequests.empty())
+                continue;
+            req = mRequests.front();
+            mRequests.pop_front();
+        }
+
+        Ready ready;
+        ready.idPath = req.idPath;
+        ready.surface = nullptr;
+        ready.width = 0;
+        ready.height = 0;
+        ready.errors = 0;
+
+        // nothing here logs, errors are logged in logic
+        bool broken = false;
+        SDL_RWops *rw = ContentPack::openRead(req.path, false, broken);
+        if (broken)
+            ready.errors |= ERROR_PACK;
+        if (!rw)
+            rw = PHYSFSRWOPS_openRead(req.path.c_str());
+
+        SDL_Surface *tmpImage = nullptr;
+        if (rw)
+        {
+            tmpImage = req.dye ? helper->loadDyedSurface(rw, *req.dye)
+                : IMG_Load_RW(rw, 1);
+        }
+        if (tmpImage)
+        {
+            bool cropped = false;
+            ready.width = tmpImage->w;
+            ready.height = tmpImage->h;
+            ready.surface = OpenGLImageHelper::prepareSurface(
+                tmpImage, cropped);
+            if (ready.surface != tmpImage)
+                SDL_FreeSurface(tmpImage);
+            if (cropped)
+                ready.errors |= ERROR_CROPPED;
+            if (!ready.surface)
+                ready.errors |= ERROR_MEMORY;
+        }
+        else
+        {
+            ready.errors |= ERROR_LOAD;
+        }
+
+        MutexLocker lock(&mMutex);
+        mReady.push_back(ready);
+    }
+    return 0;
+}
+
+Resource *ImageStreamer::uploadImage(void *ptr)
+{
+    if (!ptr)
+        return nullptr;
+
+    const Ready *const ready = static_cast<const Ready*>(ptr);
+    // surface can be padded to texture size, only image part goes to atlas
+    if (Image *const image = AtlasManager::add(ready->surface,
+        ready->width, ready->height))
+    {
+        return image;
+    }
+    return static_cast<OpenGLImageHelper*>(imageHelper)->uploadSurface(
+        ready->surface, ready->width, ready->height);
+}
+
+void ImageStreamer::logic()
+{
+    if (!mThread)
+        return;
+
+    const int budget = config.getIntValue("textureUploadBudget") * 1024;
+    ResourceManager *const resman = ResourceManager::getInstance();
+    int uploaded = 0;
+
+    // at least one image per frame, even if it is bigger than budget
+    while (!uploaded || uploaded < budget)
+    {
+        Ready ready;
+        {
+            MutexLocker lock(&mMutex);
+            if (mReady.empty())
+                break;
+            ready = mReady.front();
+            mReady.pop_front();
+        }
+
+        mPending.erase(ready.idPath);
+        if (ready.errors & ERROR_PACK)
+        {
+            logger->log("Error: broken file in content pack: %s",
+                        ready.idPath.c_str());
+        }
+        if (ready.errors & ERROR_CROPPED)
+        {
+            logger->log("Warning: image too large, cropping to %dx%d "
+                        "texture!", ready.width, ready.height);
+        }
+        if (ready.errors & ERROR_MEMORY)
+            logger->log1("Error, image convert failed: out of memory");
+        if (!ready.surface)
+        {
+            logger->log("Error, image load failed: %s",
+                        ready.idPath.c_str());
+            continue;
+        }
+
+        // image stays in cache as orphan until someone takes it
+        Resource *const res = resman->get(ready.idPath, uploadImage, &ready);
+        if (res)
+            res->decRef();
+
+        uploaded += ready.surface->w * ready.surface->h * 4;
+        SDL_FreeSurface(ready.surface);
+    }
+}
+
+void ImageStreamer::unload()
+{
+    if (mThread)
+    {
+        {
+            MutexLocker lock(&mMutex);
+            mQuit = true;
+        }
+        SDL_SemPost(mSemaphore);
+        SDL_WaitThread(mThread, nullptr);
+        mThread = nullptr;
+        SDL_DestroySemaphore(mSemaphore);
+        mSemaphore = nullptr;
+    }
+
+    for (std::list<Ready>::iterator it = mReady.begin(),
+         it_end = mReady.end(); it != it_end; ++ it)
+    {
+        if ((*it).surface)
+            SDL_FreeSurface((*it).surface);
+    }
+    mReady.clear();
+    mRequests.clear();
+    mPending.clear();
+    mQuit = false;
+}
+
+#else
+
+#include "debug.h"
+
+bool ImageStreamer::request(const std::string &idPath A_UNUSED)
+{
+    return false;
+}
+
+bool ImageStreamer::isPending(const std::string &idPath A_UNUSED)
+{
+    return false;
+}
+
+void ImageStreamer::logic()
+{
+}
+
+void ImageStreamer::unload()
+{
+}
+
+#endif
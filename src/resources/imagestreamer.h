@@ -0,0 +1,114 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGESTREAMER_H
+#define IMAGESTREAMER_H
+
+#include "localconsts.h"
+
+#include "utils/mutex.h"
+
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#include <list>
+#include <set>
+#include <string>
+
+class Dye;
+class Resource;
+
+/**
+ * Loads images for OpenGL mode in background. Decoding, recoloring and
+ * conversion to texture format are made in worker thread, and main thread
+ * uploads ready surfaces with limited amount of bytes per frame. Uploaded
+ * images are put into resource manager cache.
+ *
+ * Only used to warm cache for prefetched maps. Direct
+ * ResourceManager::getImage calls still load synchronously, because their
+ * callers use image size and texture at once and there are no placeholder
+ * images which could be replaced after loading.
+ */
+class ImageStreamer
+{
+    public:
+        /**
+         * Queues image with given id path for loading. Returns false if
+         * images are not loaded with OpenGL.
+         */
+        static bool request(const std::string &idPath);
+
+        /**
+         * Returns true if image is still loading.
+         */
+        static bool isPending(const std::string &idPath);
+
+        /**
+         * Uploads ready images. Must be called from main thread.
+         */
+        static void logic();
+
+        /**
+         * Stops worker thread and drops not uploaded images.
+         */
+        static void unload();
+
+    private:
+        struct Request
+        {
+            std::string idPath;
+            std::string path;
+            const Dye *dye;
+        };
+
+        /**
+         * Problems found by worker thread, logged by main thread.
+         */
+        enum
+        {
+            ERROR_PACK = 1,
+            ERROR_LOAD = 2,
+            ERROR_CROPPED = 4,
+            ERROR_MEMORY = 8
+        };
+
+        struct Ready
+        {
+            std::string idPath;
+            SDL_Surface *surface;
+            int width;
+            int height;
+            int errors;
+        };
+
+        static int workerThread(void *ptr);
+
+        static Resource *uploadImage(void *ptr);
+
+        static SDL_Thread *mThread;
+        static SDL_sem *mSemaphore;
+        static Mutex mMutex;
+        static std::list<Request> mRequests;
+        static std::list<Ready> mReady;
+        static std::set<std::string> mPending;
+        static bool mQuit;
+};
+
+#endif
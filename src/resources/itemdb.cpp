@@ -34,16 +34,35 @@
 #include "utils/stringutils.h"
 #include "utils/xml.h"
 
+#include <algorithm>
+#include <set>
+
 #include "debug.h"
 
 namespace
 {
+    /**
+     * Location of not yet parsed item in items.xml text.
+     */
+    struct ItemRecord
+    {
+        int start;
+        int size;
+    };
+
+    typedef std::map<int, ItemRecord> ItemRecords;
+    typedef std::map<std::string, int> NamedItemIds;
+
     ItemDB::ItemInfos mItemInfos;
-    ItemDB::NamedItemInfos mNamedItemInfos;
+    ItemRecords mRecords;
+    NamedItemIds mNamedItemIds;
     ItemInfo *mUnknown;
     bool mLoaded = false;
     StringVect mTagNames;
     std::map<std::string, int> mTags;
+    std::set<std::string> mStrings;
+    char *mData = nullptr;
+    int mDataSize = 0;
 }
 
 // Forward declarations
@@ -144,24 +163,387 @@ static ItemType itemTypeFromString(const std::string &name)
     }
 }
 
+static int addTagName(const std::string &name)
+{
+    std::map<std::string, int>::const_iterator it = mTags.find(name);
+    if (it != mTags.end())
+        return it->second;
+
+    const int tag = static_cast<int>(mTagNames.size());
+    mTagNames.push_back(name);
+    mTags[name] = tag;
+    return tag;
+}
+
+static bool startsWith(const char *const data, const int pos, const int size,
+                       const char *const str)
+{
+    const int len = static_cast<int>(strlen(str));
+    return pos + len <= size && !memcmp(data + pos, str, len);
+}
+
+static int findString(const char *const data, const int pos, const int size,
+                      const char *const str)
+{
+    const char *const end = data + size;
+    const char *const found = std::search(data + pos, end,
+        str, str + strlen(str));
+    if (found == end)
+        return -1;
+    return static_cast<int>(found - data);
+}
+
+/**
+ * Finds byte ranges of item elements in items.xml text, in document order.
+ * Only direct children of root element are reported.
+ */
+static void findItemRecords(const char *const data, const int size,
+                            std::vector<ItemRecord> &records)
+{
+    int depth = 0;
+    int itemStart = -1;
+    int pos = 0;
+    while (pos < size)
+    {
+        const char *const ptr = static_cast<const char*>(
+            memchr(data + pos, '<', size - pos));
+        if (!ptr)
+            return;
+        pos = static_cast<int>(ptr - data);
+        if (startsWith(data, pos, size, "<!--"))
+        {
+            pos = findString(data, pos + 4, size, "-->");
+            if (pos < 0)
+                return;
+            pos += 3;
+            continue;
+        }
+        if (startsWith(data, pos, size, "<![CDATA["))
+        {
+            pos = findString(data, pos + 9, size, "]]>");
+            if (pos < 0)
+                return;
+            pos += 3;
+            continue;
+        }
+
+        // find end of tag, skipping quoted attribute values
+        char quote = 0;
+        int tagEnd = pos + 1;
+        for (; tagEnd < size; tagEnd ++)
+        {
+            const char c = data[tagEnd];
+            if (quote)
+            {
+                if (c == quote)
+                    quote = 0;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                quote = c;
+            }
+            else if (c == '>')
+            {
+                break;
+            }
+        }
+        if (tagEnd >= size)
+            return;
+
+        const char next = ptr[1];
+        if (next == '?' || next == '!')
+        {
+            // processing instruction or doctype
+        }
+        else if (next == '/')
+        {
+            depth --;
+            if (depth == 1 && itemStart >= 0)
+            {
+                ItemRecord record = { itemStart, tagEnd + 1 - itemStart };
+                records.push_back(record);
+                itemStart = -1;
+            }
+        }
+        else
+        {
+            const bool isItem = depth == 1 && pos + 5 < size
+                && startsWith(data, pos + 1, size, "item")
+                && !isalnum(static_cast<unsigned char>(ptr[5]))
+                && ptr[5] != '-' && ptr[5] != '_';
+            if (data[tagEnd - 1] == '/')
+            {
+                if (isItem)
+                {
+                    ItemRecord record = { pos, tagEnd + 1 - pos };
+                    records.push_back(record);
+                }
+            }
+            else
+            {
+                if (isItem)
+                    itemStart = pos;
+                depth ++;
+            }
+        }
+        pos = tagEnd + 1;
+    }
+}
+
+static ItemInfo *loadItem(XmlNodePtr node, const int id)
+{
+    std::string typeStr = XML::getProperty(node, "type", "other");
+    int weight = XML::getProperty(node, "weight", 0);
+    int view = XML::getProperty(node, "view", 0);
+
+    std::string name = XML::langProperty(node, "name", "");
+    std::string image = XML::getProperty(node, "image", "");
+    std::string floor = XML::getProperty(node, "floor", "");
+    std::string description = XML::langProperty(node, "description", "");
+    std::string attackAction = XML::getProperty(node, "attack-action", "");
+    std::string drawBefore = XML::getProperty(node, "drawBefore", "");
+    std::string drawAfter = XML::getProperty(node, "drawAfter", "");
+//        std::string removeSprite = XML::getProperty(node, "removeSprite", "");
+    std::string colors;
+    if (serverVersion >= 1)
+    {
+        colors = XML::getProperty(node, "colors", "");
+
+        // check for empty hair palete
+        if (colors.empty() && id <= -1 && id > -100)
+            colors = "hair";
+    }
+    else
+    {
+        if (id <= -1 && id > -100)
+            colors = "hair";
+        else
+            colors = "";
+    }
+
+    std::string tags[3];
+    tags[0] = XML::getProperty(node, "tag",
+        XML::getProperty(node, "tag1", ""));
+    tags[1] = XML::getProperty(node, "tag2", "");
+    tags[2] = XML::getProperty(node, "tag3", "");
+
+    int drawPriority = XML::getProperty(node, "drawPriority", 0);
+
+    int attackRange = XML::getProperty(node, "attack-range", 0);
+    std::string missileParticle = XML::getProperty(
+        node, "missile-particle", "");
+    int hitEffectId = XML::getProperty(node, "hit-effect-id",
+        paths.getIntValue("hitEffectId"));
+    int criticalEffectId = XML::getProperty(node, "critical-hit-effect-id",
+        paths.getIntValue("criticalHitEffectId"));
+
+    SpriteDisplay display;
+    display.image = image;
+    if (floor != "")
+        display.floor = floor;
+    else
+        display.floor = image;
+
+    ItemInfo *itemInfo = new ItemInfo;
+    itemInfo->setId(id);
+    itemInfo->setName(name.empty() ? _("unnamed") : name);
+    itemInfo->setDescription(description);
+    itemInfo->setType(itemTypeFromString(typeStr));
+    itemInfo->addTag(mTags["All"]);
+    switch (itemInfo->getType())
+    {
+        case ITEM_USABLE:
+            itemInfo->addTag(mTags["Usable"]);
+            break;
+        case ITEM_UNUSABLE:
+            itemInfo->addTag(mTags["Unusable"]);
+            break;
+        default:
+        case ITEM_EQUIPMENT_ONE_HAND_WEAPON:
+        case ITEM_EQUIPMENT_TWO_HANDS_WEAPON:
+        case ITEM_EQUIPMENT_TORSO:
+        case ITEM_EQUIPMENT_ARMS:
+        case ITEM_EQUIPMENT_HEAD:
+        case ITEM_EQUIPMENT_LEGS:
+        case ITEM_EQUIPMENT_SHIELD:
+        case ITEM_EQUIPMENT_RING:
+        case ITEM_EQUIPMENT_NECKLACE:
+        case ITEM_EQUIPMENT_FEET:
+        case ITEM_EQUIPMENT_AMMO:
+        case ITEM_EQUIPMENT_CHARM:
+        case ITEM_SPRITE_RACE:
+        case ITEM_SPRITE_HAIR:
+            itemInfo->addTag(mTags["Equipment"]);
+            break;
+    }
+    for (int f = 0; f < 3; f++)
+    {
+        if (tags[f] != "")
+            itemInfo->addTag(addTagName(tags[f]));
+    }
+
+    itemInfo->setView(view);
+    itemInfo->setWeight(weight);
+    itemInfo->setAttackAction(attackAction);
+    itemInfo->setAttackRange(attackRange);
+    itemInfo->setMissileParticleFile(missileParticle);
+    itemInfo->setHitEffectId(hitEffectId);
+    itemInfo->setCriticalHitEffectId(criticalEffectId);
+    itemInfo->setDrawBefore(-1, parseSpriteName(drawBefore));
+    itemInfo->setDrawAfter(-1, parseSpriteName(drawAfter));
+    itemInfo->setDrawPriority(-1, drawPriority);
+    itemInfo->setColorsList(colors);
+
+    std::string effect;
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); ++ i)
+    {
+        int value = XML::getProperty(node, fields[i][0], 0);
+        if (!value)
+            continue;
+        if (!effect.empty())
+            effect += " / ";
+        effect += strprintf(gettext(fields[i][1]), value);
+    }
+    for (std::vector<ItemDB::Stat>::const_iterator it = extraStats.begin(),
+         it_end = extraStats.end(); it != it_end; ++it)
+    {
+        int value = XML::getProperty(node, it->tag.c_str(), 0);
+        if (!value)
+            continue;
+        if (!effect.empty())
+            effect += " / ";
+        effect += strprintf(it->format.c_str(), value);
+    }
+    std::string temp = XML::langProperty(node, "effect", "");
+    if (!effect.empty() && !temp.empty())
+        effect += " / ";
+    effect += temp;
+    itemInfo->setEffect(effect);
+
+    for_each_xml_child_node(itemChild, node)
+    {
+        if (xmlNameEqual(itemChild, "sprite"))
+        {
+            std::string attackParticle = XML::getProperty(
+                itemChild, "particle-effect", "");
+            itemInfo->setParticleEffect(attackParticle);
+
+            loadSpriteRef(itemInfo, itemChild);
+        }
+        else if (xmlNameEqual(itemChild, "sound"))
+        {
+            loadSoundRef(itemInfo, itemChild);
+        }
+        else if (xmlNameEqual(itemChild, "floor"))
+        {
+            loadFloorSprite(&display, itemChild);
+        }
+        else if (xmlNameEqual(itemChild, "replace"))
+        {
+            loadReplaceSprite(itemInfo, itemChild);
+        }
+        else if (xmlNameEqual(itemChild, "drawAfter"))
+        {
+            loadOrderSprite(itemInfo, itemChild, true);
+        }
+        else if (xmlNameEqual(itemChild, "drawBefore"))
+        {
+            loadOrderSprite(itemInfo, itemChild, false);
+        }
+    }
+
+    itemInfo->setDisplay(display);
+
+    if (!attackAction.empty())
+    {
+        if (attackRange == 0)
+        {
+            logger->log("ItemDB: Missing attack range from weapon %i!",
+                id);
+        }
+    }
+
+#define CHECK_PARAM(param, error_value) \
+    if (param == error_value) \
+        logger->log("ItemDB: Missing " #param " attribute for item %i!", \
+                    id)
+
+    if (id >= 0 && typeStr != "other")
+    {
+        CHECK_PARAM(name, "");
+        CHECK_PARAM(description, "");
+        CHECK_PARAM(image, "");
+    }
+    // CHECK_PARAM(effect, "");
+    // CHECK_PARAM(type, 0);
+    // CHECK_PARAM(weight, 0);
+    // CHECK_PARAM(slot, 0);
+
+#undef CHECK_PARAM
+
+    return itemInfo;
+}
+
+static ItemInfo *loadItemRecord(const int id, const ItemRecord &record)
+{
+    XML::Document doc(mData + record.start, record.size);
+    XmlNodePtr node = doc.rootNode();
+    if (!node || !xmlNameEqual(node, "item")
+        || XML::getProperty(node, "id", 0) != id)
+    {
+        logger->log("ItemDB: Error while parsing item %d", id);
+        return nullptr;
+    }
+    return loadItem(node, id);
+}
+
+/**
+ * Parses whole items.xml and loads all not yet parsed items.
+ * Used if indexed item ranges don't match document.
+ */
+static void loadAllRecords()
+{
+    logger->log1("ItemDB: items.xml index is broken, loading all items");
+    XML::Document doc(mData, mDataSize);
+    XmlNodePtr rootNode = doc.rootNode();
+    if (rootNode)
+    {
+        for_each_xml_child_node(node, rootNode)
+        {
+            if (!xmlNameEqual(node, "item"))
+                continue;
+
+            const int id = XML::getProperty(node, "id", 0);
+            if (mRecords.find(id) == mRecords.end())
+                continue;
+
+            // redefined items replace previous definition
+            ItemDB::ItemInfos::iterator it = mItemInfos.find(id);
+            if (it != mItemInfos.end())
+                delete it->second;
+            mItemInfos[id] = loadItem(node, id);
+        }
+    }
+
+    mRecords.clear();
+    free(mData);
+    mData = nullptr;
+    mDataSize = 0;
+}
+
 void ItemDB::load()
 {
     if (mLoaded)
         unload();
 
-    int tagNum = 0;
     logger->log1("Initializing item database...");
 
     mTags.clear();
     mTagNames.clear();
-    mTagNames.push_back("All");
-    mTagNames.push_back("Usable");
-    mTagNames.push_back("Unusable");
-    mTagNames.push_back("Equipment");
-    mTags["All"] = tagNum ++;
-    mTags["Usable"] = tagNum ++;
-    mTags["Unusable"] = tagNum ++;
-    mTags["Equipment"] = tagNum ++;
+    addTagName("All");
+    addTagName("Usable");
+    addTagName("Unusable");
+    addTagName("Equipment");
 
     mUnknown = new ItemInfo;
     mUnknown->setName(_("Unknown item"));
@@ -172,7 +554,9 @@ void ItemDB::load()
     mUnknown->setSprite(errFile, GENDER_OTHER, 0);
     mUnknown->addTag(mTags["All"]);
 
-    XML::Document doc("items.xml");
+    mData = static_cast<char*>(ResourceManager::loadFile(
+        "items.xml", mDataSize));
+    XML::Document doc(mData, mDataSize);
     XmlNodePtr rootNode = doc.rootNode();
 
     if (!rootNode || !xmlNameEqual(rootNode, "items"))
@@ -182,11 +566,27 @@ void ItemDB::load()
         return;
     }
 
+    // items are parsed on first use, here only ids, names and tags are read
+    std::vector<ItemRecord> records;
+    findItemRecords(mData, mDataSize, records);
+    const size_t recordsSize = records.size();
+    size_t itemNum = 0;
+    for_each_xml_child_node(node, rootNode)
+    {
+        if (xmlNameEqual(node, "item"))
+            itemNum ++;
+    }
+    const bool lazy = recordsSize == itemNum;
+    if (!lazy)
+        logger->log1("ItemDB: can't index items.xml, loading all items");
+
+    itemNum = 0;
     for_each_xml_child_node(node, rootNode)
     {
         if (!xmlNameEqual(node, "item"))
             continue;
 
+        const size_t recordNum = itemNum ++;
         int id = XML::getProperty(node, "id", 0);
 
         if (id == 0)
@@ -194,38 +594,16 @@ void ItemDB::load()
             logger->log1("ItemDB: Invalid or missing item ID in items.xml!");
             continue;
         }
-        else if (mItemInfos.find(id) != mItemInfos.end())
+        else if (mRecords.find(id) != mRecords.end()
+                 || mItemInfos.find(id) != mItemInfos.end())
         {
             logger->log("ItemDB: Redefinition of item ID %d", id);
-        }
-
-        std::string typeStr = XML::getProperty(node, "type", "other");
-        int weight = XML::getProperty(node, "weight", 0);
-        int view = XML::getProperty(node, "view", 0);
-
-        std::string name = XML::langProperty(node, "name", "");
-        std::string image = XML::getProperty(node, "image", "");
-        std::string floor = XML::getProperty(node, "floor", "");
-        std::string description = XML::langProperty(node, "description", "");
-        std::string attackAction = XML::getProperty(node, "attack-action", "");
-        std::string drawBefore = XML::getProperty(node, "drawBefore", "");
-        std::string drawAfter = XML::getProperty(node, "drawAfter", "");
-//        std::string removeSprite = XML::getProperty(node, "removeSprite", "");
-        std::string colors;
-        if (serverVersion >= 1)
-        {
-            colors = XML::getProperty(node, "colors", "");
-
-            // check for empty hair palete
-            if (colors.empty() && id <= -1 && id > -100)
-                colors = "hair";
-        }
-        else
-        {
-            if (id <= -1 && id > -100)
-                colors = "hair";
-            else
-                colors = "";
+            ItemInfos::iterator it = mItemInfos.find(id);
+            if (it != mItemInfos.end())
+            {
+                delete it->second;
+                mItemInfos.erase(it);
+            }
         }
 
         std::string tags[3];
@@ -233,150 +611,26 @@ void ItemDB::load()
             XML::getProperty(node, "tag1", ""));
         tags[1] = XML::getProperty(node, "tag2", "");
         tags[2] = XML::getProperty(node, "tag3", "");
-
-        int drawPriority = XML::getProperty(node, "drawPriority", 0);
-
-        int attackRange = XML::getProperty(node, "attack-range", 0);
-        std::string missileParticle = XML::getProperty(
-            node, "missile-particle", "");
-        int hitEffectId = XML::getProperty(node, "hit-effect-id",
-            paths.getIntValue("hitEffectId"));
-        int criticalEffectId = XML::getProperty(node, "critical-hit-effect-id",
-            paths.getIntValue("criticalHitEffectId"));
-
-        SpriteDisplay display;
-        display.image = image;
-        if (floor != "")
-            display.floor = floor;
-        else
-            display.floor = image;
-
-        ItemInfo *itemInfo = new ItemInfo;
-        itemInfo->setId(id);
-        itemInfo->setName(name.empty() ? _("unnamed") : name);
-        itemInfo->setDescription(description);
-        itemInfo->setType(itemTypeFromString(typeStr));
-        itemInfo->addTag(mTags["All"]);
-        switch (itemInfo->getType())
-        {
-            case ITEM_USABLE:
-                itemInfo->addTag(mTags["Usable"]);
-                break;
-            case ITEM_UNUSABLE:
-                itemInfo->addTag(mTags["Unusable"]);
-                break;
-            default:
-            case ITEM_EQUIPMENT_ONE_HAND_WEAPON:
-            case ITEM_EQUIPMENT_TWO_HANDS_WEAPON:
-            case ITEM_EQUIPMENT_TORSO:
-            case ITEM_EQUIPMENT_ARMS:
-            case ITEM_EQUIPMENT_HEAD:
-            case ITEM_EQUIPMENT_LEGS:
-            case ITEM_EQUIPMENT_SHIELD:
-            case ITEM_EQUIPMENT_RING:
-            case ITEM_EQUIPMENT_NECKLACE:
-            case ITEM_EQUIPMENT_FEET:
-            case ITEM_EQUIPMENT_AMMO:
-            case ITEM_EQUIPMENT_CHARM:
-            case ITEM_SPRITE_RACE:
-            case ITEM_SPRITE_HAIR:
-                itemInfo->addTag(mTags["Equipment"]);
-                break;
-        }
         for (int f = 0; f < 3; f++)
         {
-            if (tags[f] != "")
-            {
-                if (mTags.find(tags[f]) == mTags.end())
-                {
-                    mTagNames.push_back(tags[f]);
-                    mTags[tags[f]] = tagNum ++;
-                }
-                itemInfo->addTag(mTags[tags[f]]);
-            }
-        }
-
-        itemInfo->setView(view);
-        itemInfo->setWeight(weight);
-        itemInfo->setAttackAction(attackAction);
-        itemInfo->setAttackRange(attackRange);
-        itemInfo->setMissileParticleFile(missileParticle);
-        itemInfo->setHitEffectId(hitEffectId);
-        itemInfo->setCriticalHitEffectId(criticalEffectId);
-        itemInfo->setDrawBefore(-1, parseSpriteName(drawBefore));
-        itemInfo->setDrawAfter(-1, parseSpriteName(drawAfter));
-        itemInfo->setDrawPriority(-1, drawPriority);
-        itemInfo->setColorsList(colors);
-
-        std::string effect;
-        for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); ++ i)
-        {
-            int value = XML::getProperty(node, fields[i][0], 0);
-            if (!value)
-                continue;
-            if (!effect.empty())
-                effect += " / ";
-            effect += strprintf(gettext(fields[i][1]), value);
-        }
-        for (std::vector<Stat>::const_iterator it = extraStats.begin(),
-             it_end = extraStats.end(); it != it_end; ++it)
-        {
-            int value = XML::getProperty(node, it->tag.c_str(), 0);
-            if (!value)
-                continue;
-            if (!effect.empty())
-                effect += " / ";
-            effect += strprintf(it->format.c_str(), value);
+            if (!tags[f].empty())
+                addTagName(tags[f]);
         }
-        std::string temp = XML::langProperty(node, "effect", "");
-        if (!effect.empty() && !temp.empty())
-            effect += " / ";
-        effect += temp;
-        itemInfo->setEffect(effect);
-
-        for_each_xml_child_node(itemChild, node)
-        {
-            if (xmlNameEqual(itemChild, "sprite"))
-            {
-                std::string attackParticle = XML::getProperty(
-                    itemChild, "particle-effect", "");
-                itemInfo->setParticleEffect(attackParticle);
 
-                loadSpriteRef(itemInfo, itemChild);
-            }
-            else if (xmlNameEqual(itemChild, "sound"))
-            {
-                loadSoundRef(itemInfo, itemChild);
-            }
-            else if (xmlNameEqual(itemChild, "floor"))
-            {
-                loadFloorSprite(&display, itemChild);
-            }
-            else if (xmlNameEqual(itemChild, "replace"))
-            {
-                loadReplaceSprite(itemInfo, itemChild);
-            }
-            else if (xmlNameEqual(itemChild, "drawAfter"))
-            {
-                loadOrderSprite(itemInfo, itemChild, true);
-            }
-            else if (xmlNameEqual(itemChild, "drawBefore"))
-            {
-                loadOrderSprite(itemInfo, itemChild, false);
-            }
-        }
-
-        itemInfo->setDisplay(display);
+        if (lazy)
+            mRecords[id] = records[recordNum];
+        else
+            mItemInfos[id] = loadItem(node, id);
 
-        mItemInfos[id] = itemInfo;
+        std::string name = XML::langProperty(node, "name", "");
         if (!name.empty())
         {
-            temp = normalize(name);
+            name = normalize(name);
 
-            NamedItemInfos::const_iterator itr = mNamedItemInfos.find(temp);
-            if (itr == mNamedItemInfos.end())
+            NamedItemIds::const_iterator itr = mNamedItemIds.find(name);
+            if (itr == mNamedItemIds.end())
             {
-                mNamedItemInfos[temp] = itemInfo;
+                mNamedItemIds[name] = id;
             }
             else
             {
@@ -384,33 +638,13 @@ void ItemDB::load()
                     id);
             }
         }
+    }
 
-        if (!attackAction.empty())
-        {
-            if (attackRange == 0)
-            {
-                logger->log("ItemDB: Missing attack range from weapon %i!",
-                    id);
-            }
-        }
-
-#define CHECK_PARAM(param, error_value) \
-        if (param == error_value) \
-            logger->log("ItemDB: Missing " #param " attribute for item %i!", \
-                        id)
-
-        if (id >= 0 && typeStr != "other")
-        {
-            CHECK_PARAM(name, "");
-            CHECK_PARAM(description, "");
-            CHECK_PARAM(image, "");
-        }
-        // CHECK_PARAM(effect, "");
-        // CHECK_PARAM(type, 0);
-        // CHECK_PARAM(weight, 0);
-        // CHECK_PARAM(slot, 0);
-
-#undef CHECK_PARAM
+    if (!lazy)
+    {
+        free(mData);
+        mData = nullptr;
+        mDataSize = 0;
     }
 
     mLoaded = true;
@@ -435,9 +669,14 @@ void ItemDB::unload()
 
     delete_all(mItemInfos);
     mItemInfos.clear();
-    mNamedItemInfos.clear();
+    mRecords.clear();
+    mNamedItemIds.clear();
     mTags.clear();
     mTagNames.clear();
+    mStrings.clear();
+    free(mData);
+    mData = nullptr;
+    mDataSize = 0;
     mLoaded = false;
 }
 
@@ -446,9 +685,8 @@ bool ItemDB::exists(int id)
     if (!mLoaded)
         return false;
 
-    ItemInfos::const_iterator i = mItemInfos.find(id);
-
-    return i != mItemInfos.end();
+    return mItemInfos.find(id) != mItemInfos.end()
+        || mRecords.find(id) != mRecords.end();
 }
 
 const ItemInfo &ItemDB::get(int id)
@@ -457,14 +695,28 @@ const ItemInfo &ItemDB::get(int id)
         load();
 
     ItemInfos::const_iterator i = mItemInfos.find(id);
+    if (i != mItemInfos.end())
+        return *(i->second);
 
-    if (i == mItemInfos.end())
+    ItemRecords::iterator it = mRecords.find(id);
+    if (it != mRecords.end())
     {
-        logger->log("ItemDB: Warning, unknown item ID# %d", id);
-        return *mUnknown;
+        ItemInfo *const info = loadItemRecord(id, it->second);
+        if (info)
+        {
+            mRecords.erase(it);
+            mItemInfos[id] = info;
+            return *info;
+        }
+
+        loadAllRecords();
+        i = mItemInfos.find(id);
+        if (i != mItemInfos.end() && i->second)
+            return *(i->second);
     }
 
-    return *(i->second);
+    logger->log("ItemDB: Warning, unknown item ID# %d", id);
+    return *mUnknown;
 }
 
 const ItemInfo &ItemDB::get(const std::string &name)
@@ -472,9 +724,9 @@ const ItemInfo &ItemDB::get(const std::string &name)
     if (!mLoaded)
         load();
 
-    NamedItemInfos::const_iterator i = mNamedItemInfos.find(normalize(name));
+    NamedItemIds::const_iterator i = mNamedItemIds.find(normalize(name));
 
-    if (i == mNamedItemInfos.end())
+    if (i == mNamedItemIds.end())
     {
         if (!name.empty())
         {
@@ -484,14 +736,33 @@ const ItemInfo &ItemDB::get(const std::string &name)
         return *mUnknown;
     }
 
-    return *(i->second);
+    return get(i->second);
 }
 
 const std::map<int, ItemInfo*> &ItemDB::getItemInfos()
 {
+    // callers need all items, so parse everything not used yet
+    while (!mRecords.empty())
+    {
+        ItemRecords::iterator it = mRecords.begin();
+        const int id = it->first;
+        ItemInfo *const info = loadItemRecord(id, it->second);
+        if (!info)
+        {
+            loadAllRecords();
+            break;
+        }
+        mRecords.erase(it);
+        mItemInfos[id] = info;
+    }
     return mItemInfos;
 }
 
+const std::string &ItemDB::poolString(const std::string &str)
+{
+    return *mStrings.insert(str).first;
+}
+
 int parseSpriteName(std::string name)
 {
     int id = -1;
@@ -56,8 +56,16 @@ namespace ItemDB
     typedef std::map<int, ItemInfo*> ItemInfos;
     typedef std::map<std::string, ItemInfo*> NamedItemInfos;
 
+    /**
+     * Returns all items. Parses items not used yet, so it is slow.
+     */
     const std::map<int, ItemInfo*> &getItemInfos();
 
+    /**
+     * Returns shared copy of string, valid until unload.
+     */
+    const std::string &poolString(const std::string &str);
+
     int getTagId(std::string tagName);
 
     struct Stat
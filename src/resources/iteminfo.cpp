@@ -111,16 +111,16 @@ const std::string &ItemInfo::getSprite(Gender gender, int race) const
     else
     {
         static const std::string empty("");
-        std::map<int, std::string>::const_iterator i =
+        std::map<int, const std::string*>::const_iterator i =
             mAnimationFiles.find(static_cast<int>(gender) + race * 4);
 
         if (i != mAnimationFiles.end())
-            return i->second;
+            return *i->second;
         if (serverVersion > 0)
         {
             i = mAnimationFiles.find(static_cast<int>(gender));
             if (i != mAnimationFiles.end())
-                return i->second;
+                return *i->second;
         }
         return empty;
     }
@@ -136,19 +136,22 @@ void ItemInfo::setAttackAction(std::string attackAction)
 
 void ItemInfo::addSound(EquipmentSoundEvent event, const std::string &filename)
 {
-    mSounds[event].push_back(paths.getStringValue("sfx") + filename);
+    mSounds[event].push_back(&ItemDB::poolString(
+        paths.getStringValue("sfx") + filename));
 }
 
 const std::string &ItemInfo::getSound(EquipmentSoundEvent event) const
 {
     static const std::string empty;
-    std::map<EquipmentSoundEvent, StringVect>::const_iterator i;
+    std::map<EquipmentSoundEvent,
+        std::vector<const std::string*> >::const_iterator i;
 
     i = mSounds.find(event);
 
     if (i == mSounds.end())
         return empty;
-    return (!i->second.empty()) ? i->second[rand() % i->second.size()] : empty;
+    return (!i->second.empty())
+        ? *i->second[rand() % i->second.size()] : empty;
 }
 
 std::map<int, int> *ItemInfo::addReplaceSprite(int sprite, int direction)
@@ -189,15 +192,16 @@ void ItemInfo::setColorsList(std::string name)
     }
 }
 
-std::string ItemInfo::getDyeColorsString(int color) const
+const std::string &ItemInfo::getDyeColorsString(const int color) const
 {
+    static const std::string empty;
     if (!mColors || mColorList.empty())
-        return "";
+        return empty;
 
     std::map <int, ColorDB::ItemColor>::const_iterator
         it = mColors->find(color);
     if (it == mColors->end())
-        return "";
+        return empty;
 
     return it->second.color;
 }
@@ -324,5 +328,6 @@ int ItemInfo::getDrawPriority(int direction) const
 void ItemInfo::setSprite(const std::string &animationFile,
                          Gender gender, int race)
 {
-    mAnimationFiles[static_cast<int>(gender) + race * 4] = animationFile;
+    mAnimationFiles[static_cast<int>(gender) + race * 4]
+        = &ItemDB::poolString(animationFile);
 }
@@ -246,7 +246,7 @@ class ItemInfo
 
 //        std::string getDyeString(int color) const;
 
-        std::string getDyeColorsString(int color) const;
+        const std::string &getDyeColorsString(const int color) const;
 
         void setColorsList(std::string name);
 
@@ -287,11 +287,12 @@ class ItemInfo
         // Particle to be shown when weapon attacks
         std::string mMissileParticle;
 
-        /** Maps gender to sprite filenames. */
-        std::map <int, std::string> mAnimationFiles;
+        /** Maps gender to sprite filenames, from ItemDB string pool. */
+        std::map <int, const std::string*> mAnimationFiles;
 
         /** Stores the names of sounds to be played at certain event. */
-        std::map <EquipmentSoundEvent, StringVect> mSounds;
+        std::map <EquipmentSoundEvent,
+            std::vector<const std::string*> > mSounds;
         std::map <int, int> mTags;
         std::map <int, ColorDB::ItemColor> *mColors;
         std::string mColorList;
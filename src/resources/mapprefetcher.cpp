@@ -0,0 +1,316 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/mapprefetcher.h"
+
+#include "client.h"
+#include "configuration.h"
+#include "localplayer.h"
+#include "logger.h"
+#include "map.h"
+
+#include "resources/image.h"
+#include "resources/imagestreamer.h"
+#include "resources/mapdb.h"
+#include "resources/music.h"
+#include "resources/resourcemanager.h"
+
+#include <SDL_thread.h>
+
+#include "debug.h"
+
+SDL_Thread *MapPrefetcher::mThread = nullptr;
+Mutex MapPrefetcher::mMutex;
+std::string MapPrefetcher::mMapName;
+std::string MapPrefetcher::mFileName;
+std::string MapPrefetcher::mPendingMap;
+XML::Document *MapPrefetcher::mDoc = nullptr;
+LayerTilesMap MapPrefetcher::mLayers;
+bool MapPrefetcher::mLoaded = false;
+bool MapPrefetcher::mStale = false;
+bool MapPrefetcher::mWarmStarted = false;
+StringVect MapPrefetcher::mWarmImages;
+std::string MapPrefetcher::mWarmMusic;
+std::vector<Resource*> MapPrefetcher::mResources;
+int MapPrefetcher::mNextCheck = 0;
+
+static int warpDistance(const MapWarp &warp, const int x, const int y)
+{
+    int dx = 0;
+    int dy = 0;
+    if (x < warp.x)
+        dx = warp.x - x;
+    else if (x >= warp.x + warp.width)
+        dx = x - (warp.x + warp.width - 1);
+    if (y < warp.y)
+        dy = warp.y - y;
+    else if (y >= warp.y + warp.height)
+        dy = y - (warp.y + warp.height - 1);
+    return dx > dy ? dx : dy;
+}
+
+void MapPrefetcher::logic(const Map *const map)
+{
+    if (!map || !player_node)
+        return;
+
+    warm();
+
+    // start map requested while previous one was loading
+    if (!mPendingMap.empty() && isLoaded())
+    {
+        const std::string mapName = mPendingMap;
+        mPendingMap.clear();
+        prefetch(mapName);
+    }
+
+    // drop map which was not ready at map change
+    if (mStale && isLoaded())
+        clear();
+
+    if (get_elapsed_time1(mNextCheck) < 50)
+        return;
+    mNextCheck = tick_time;
+
+    if (!config.getBoolValue("prefetchMaps"))
+        return;
+
+    const MapWarps &warps = map->getWarps();
+    if (warps.empty())
+        return;
+
+    const int distance = config.getIntValue("prefetchWarpDistance");
+    const int x = player_node->getTileX();
+    const int y = player_node->getTileY();
+    const Path &path = player_node->getNavigatePath();
+
+    for (MapWarpsCIter it = warps.begin(), it_end = warps.end();
+         it != it_end; ++ it)
+    {
+        const MapWarp &warp = *it;
+        if (warpDistance(warp, x, y) <= distance)
+        {
+            prefetch(warp.map);
+            return;
+        }
+
+        for (Path::const_iterator it2 = path.begin(), it2_end = path.end();
+             it2 != it2_end; ++ it2)
+        {
+            if (!warpDistance(warp, (*it2).x, (*it2).y))
+            {
+                prefetch(warp.map);
+                return;
+            }
+        }
+    }
+}
+
+std::string MapPrefetcher::getRealFileName(const std::string &mapName)
+{
+    std::string realFullMap = paths.getValue("maps", "maps/")
+                              + MapDB::getMapName(mapName) + ".tmx";
+
+    ResourceManager *resman = ResourceManager::getInstance();
+    if (!resman->exists(realFullMap))
+        realFullMap += ".gz";
+    return realFullMap;
+}
+
+void MapPrefetcher::prefetch(const std::string &mapName)
+{
+    if (mapName == mMapName && !mStale)
+    {
+        mPendingMap.clear();
+        return;
+    }
+
+    // not wait for running thread, switch after it finished
+    if (mThread && !isLoaded())
+    {
+        mPendingMap = mapName;
+        return;
+    }
+
+    clear();
+
+    mMapName = mapName;
+    mFileName = getRealFileName(mapName);
+    logger->log("Prefetching map %s", mFileName.c_str());
+
+    mThread = SDL_CreateThread(MapPrefetcher::prefetchThread, nullptr);
+    if (!mThread)
+    {
+        logger->log1("Map prefetch thread creation failed");
+        mMapName.clear();
+        mFileName.clear();
+    }
+}
+
+int MapPrefetcher::prefetchThread(void *ptr A_UNUSED)
+{
+    bool found = false;
+    XML::Document *doc = MapReader::loadDocument(mFileName, found);
+    LayerTilesMap layers;
+    if (doc)
+        MapReader::decodeLayers(doc->rootNode(), layers);
+
+    MutexLocker lock(&mMutex);
+    mDoc = doc;
+    mLayers.swap(layers);
+    mLoaded = true;
+    return 0;
+}
+
+bool MapPrefetcher::isLoaded()
+{
+    MutexLocker lock(&mMutex);
+    return mLoaded;
+}
+
+void MapPrefetcher::warm()
+{
+    if (!mThread || mStale)
+        return;
+
+    if (!mWarmStarted)
+    {
+        MutexLocker lock(&mMutex);
+        if (!mLoaded)
+            return;
+
+        mWarmStarted = true;
+        if (!mDoc)
+            return;
+
+        MapReader::getMapResources(mDoc->rootNode(), mFileName,
+            mWarmImages, mWarmMusic);
+
+        const size_t lastSlash = mFileName.rfind("/") + 1;
+        const size_t lastDot = mFileName.rfind(".");
+        const std::string minimap = paths.getStringValue("minimaps")
+            + "graphics/minimaps/"
+            + mFileName.substr(lastSlash, lastDot - lastSlash) + ".png";
+        if (ResourceManager::getInstance()->exists(minimap))
+            mWarmImages.push_back(minimap);
+
+        // images are taken from back, so request them in same order
+        for (StringVect::reverse_iterator it = mWarmImages.rbegin(),
+             it_end = mWarmImages.rend(); it != it_end; ++ it)
+        {
+            ImageStreamer::request(*it);
+        }
+        return;
+    }
+
+    // load one resource per tick to not stall game
+    ResourceManager *resman = ResourceManager::getInstance();
+    if (!mWarmImages.empty())
+    {
+        // wait while image is decoded in background
+        if (ImageStreamer::isPending(mWarmImages.back()))
+            return;
+        Resource *res = resman->getImage(mWarmImages.back());
+        mWarmImages.pop_back();
+        if (res)
+            mResources.push_back(res);
+    }
+    else if (!mWarmMusic.empty())
+    {
+        if (config.getBoolValue("sound"))
+        {
+            Resource *res = resman->getMusic(
+                paths.getStringValue("music") + mWarmMusic);
+            if (res)
+                mResources.push_back(res);
+        }
+        mWarmMusic.clear();
+    }
+}
+
+XML::Document *MapPrefetcher::take(const std::string &realFilename,
+                                   LayerTilesMap &layers)
+{
+    if (!mThread || mStale || realFilename != mFileName)
+        return nullptr;
+
+    if (!isLoaded())
+    {
+        logger->log("Prefetched map %s not ready", realFilename.c_str());
+        mStale = true;
+        return nullptr;
+    }
+
+    // thread already finished
+    SDL_WaitThread(mThread, nullptr);
+    mThread = nullptr;
+
+    XML::Document *doc = mDoc;
+    mDoc = nullptr;
+    layers.swap(mLayers);
+    return doc;
+}
+
+void MapPrefetcher::release()
+{
+    if (mThread && !isLoaded())
+    {
+        releaseResources();
+        mWarmImages.clear();
+        mWarmMusic.clear();
+        mStale = true;
+    }
+    else
+    {
+        clear();
+    }
+}
+
+void MapPrefetcher::releaseResources()
+{
+    for (std::vector<Resource*>::const_iterator it = mResources.begin(),
+         it_end = mResources.end(); it != it_end; ++ it)
+    {
+        (*it)->decRef();
+    }
+    mResources.clear();
+}
+
+void MapPrefetcher::clear()
+{
+    if (mThread)
+    {
+        SDL_WaitThread(mThread, nullptr);
+        mThread = nullptr;
+    }
+
+    delete mDoc;
+    mDoc = nullptr;
+    MapReader::freeLayers(mLayers);
+    mLoaded = false;
+    mStale = false;
+    mWarmStarted = false;
+    mMapName.clear();
+    mFileName.clear();
+    mPendingMap.clear();
+    mWarmImages.clear();
+    mWarmMusic.clear();
+    releaseResources();
+}
@@ -0,0 +1,105 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPREFETCHER_H
+#define MAPPREFETCHER_H
+
+#include "resources/mapreader.h"
+
+#include "utils/mutex.h"
+#include "utils/stringvector.h"
+#include "utils/xml.h"
+
+#include <string>
+#include <vector>
+
+class Map;
+class Resource;
+
+struct SDL_Thread;
+
+/**
+ * Loads and parses map behind near warp in background thread, decodes its
+ * layers there and warms its tilesets, music and minimap, so map change
+ * only builds map objects from ready data.
+ */
+class MapPrefetcher
+{
+    public:
+        /**
+         * Checks player position and navigation path against warps of
+         * current map and warms prefetched map resources.
+         */
+        static void logic(const Map *const map);
+
+        /**
+         * Starts loading of given map in background. If other map is still
+         * loading, new map is started after it.
+         */
+        static void prefetch(const std::string &mapName);
+
+        /**
+         * Returns prefetched document and decoded layers for map file or
+         * nullptr. Not waits for prefetch thread: if map still loading,
+         * returns nullptr and prefetched data is dropped later. Caller owns
+         * document and layers.
+         */
+        static XML::Document *take(const std::string &realFilename,
+                                   LayerTilesMap &layers);
+
+        /**
+         * Releases warmed resources after map change. Running prefetch is
+         * not waited for, its result is dropped when it finished.
+         */
+        static void release();
+
+        /**
+         * Stops prefetching and releases warmed resources.
+         */
+        static void clear();
+
+        static std::string getRealFileName(const std::string &mapName);
+
+    private:
+        static int prefetchThread(void *ptr);
+
+        static void warm();
+
+        static void releaseResources();
+
+        static bool isLoaded();
+
+        static SDL_Thread *mThread;
+        static Mutex mMutex;
+        static std::string mMapName;
+        static std::string mFileName;
+        static std::string mPendingMap;
+        static XML::Document *mDoc;
+        static LayerTilesMap mLayers;
+        static bool mLoaded;
+        static bool mStale;
+        static bool mWarmStarted;
+        static StringVect mWarmImages;
+        static std::string mWarmMusic;
+        static std::vector<Resource*> mResources;
+        static int mNextCheck;
+};
+
+#endif
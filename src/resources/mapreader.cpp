@@ -32,6 +32,7 @@
 #include "resources/animation.h"
 #include "resources/image.h"
 #include "resources/mapdb.h"
+#include "resources/mapprefetcher.h"
 #include "resources/resourcemanager.h"
 
 #include "utils/base64.h"
@@ -185,14 +186,62 @@ Map *MapReader::readMap(const std::string &filename,
                         const std::string &realFilename)
 {
     logger->log("Attempting to read map %s", realFilename.c_str());
+
+    LayerTilesMap layers;
+    XML::Document *doc = MapPrefetcher::take(realFilename, layers);
+    if (doc)
+    {
+        logger->log("Using prefetched map %s", realFilename.c_str());
+    }
+    else
+    {
+        bool found = false;
+        doc = loadDocument(realFilename, found);
+        if (!found)
+            return createEmptyMap(filename, realFilename);
+        if (!doc)
+            return nullptr;
+    }
+
+    Map *map = nullptr;
+    XmlNodePtr node = doc->rootNode();
+
+    // Parse the inflated map data
+    if (node)
+    {
+        if (!xmlNameEqual(node, "map"))
+            logger->log("Error: Not a map file (%s)!", realFilename.c_str());
+        else
+            map = readMap(node, realFilename, &layers);
+    }
+    else
+    {
+        logger->log("Error while parsing map file (%s)!",
+                    realFilename.c_str());
+    }
+    delete doc;
+    freeLayers(layers);
+
+    if (map)
+    {
+        map->setProperty("_filename", realFilename);
+        map->setProperty("_realfilename", filename);
+    }
+
+    return map;
+}
+
+XML::Document *MapReader::loadDocument(const std::string &realFilename,
+                                       bool &found)
+{
     // Load the file through resource manager
     ResourceManager *resman = ResourceManager::getInstance();
     int fileSize;
     void *buffer = resman->loadFile(realFilename, fileSize);
-    Map *map = nullptr;
 
+    found = buffer != nullptr;
     if (!buffer)
-        return createEmptyMap(filename, realFilename);
+        return nullptr;
 
     unsigned char *inflated;
     unsigned int inflatedSize;
@@ -218,35 +267,53 @@ Map *MapReader::readMap(const std::string &filename,
         inflatedSize = fileSize;
     }
 
-    XML::Document doc(reinterpret_cast<char*>(inflated), inflatedSize);
+    XML::Document *doc = new XML::Document(
+        reinterpret_cast<char*>(inflated), inflatedSize);
     free(inflated);
+    return doc;
+}
 
-    XmlNodePtr node = doc.rootNode();
+void MapReader::getMapResources(XmlNodePtr node, const std::string &path,
+                                StringVect &images, std::string &music)
+{
+    if (!node)
+        return;
 
-    // Parse the inflated map data
-    if (node)
-    {
-        if (!xmlNameEqual(node, "map"))
-            logger->log("Error: Not a map file (%s)!", realFilename.c_str());
-        else
-            map = readMap(node, realFilename);
-    }
-    else
-    {
-        logger->log("Error while parsing map file (%s)!",
-                    realFilename.c_str());
-    }
+    const std::string pathDir = path.substr(0, path.rfind("/") + 1);
 
-    if (map)
+    for_each_xml_child_node(childNode, node)
     {
-        map->setProperty("_filename", realFilename);
-        map->setProperty("_realfilename", filename);
-    }
+        if (xmlNameEqual(childNode, "tileset"))
+        {
+            // external tilesets loaded only with map
+            if (xmlHasProp(childNode, BAD_CAST "source"))
+                continue;
 
-    return map;
+            for_each_xml_child_node(imageNode, childNode)
+            {
+                if (!xmlNameEqual(imageNode, "image"))
+                    continue;
+
+                const std::string source = XML::getProperty(
+                    imageNode, "source", "");
+                if (!source.empty())
+                    images.push_back(resolveRelativePath(pathDir, source));
+            }
+        }
+        else if (xmlNameEqual(childNode, "properties"))
+        {
+            Properties props;
+            readProperties(childNode, &props);
+            music = props.getProperty("music");
+            const std::string minimap = props.getProperty("minimap");
+            if (!minimap.empty())
+                images.push_back(minimap);
+        }
+    }
 }
 
-Map *MapReader::readMap(XmlNodePtr node, const std::string &path)
+Map *MapReader::readMap(XmlNodePtr node, const std::string &path,
+                        const LayerTilesMap *const layers)
 {
     if (!node)
         return nullptr;
@@ -283,7 +350,7 @@ Map *MapReader::readMap(XmlNodePtr node, const std::string &path)
         }
         else if (xmlNameEqual(childNode, "layer"))
         {
-            readLayer(childNode, map);
+            readLayer(childNode, map, layers);
         }
         else if (xmlNameEqual(childNode, "properties"))
         {
@@ -351,6 +418,17 @@ Map *MapReader::readMap(XmlNodePtr node, const std::string &path)
                         }
                         map->addPortal(objName, MapItem::PORTAL,
                                        objX, objY, objW, objH);
+
+                        Properties props;
+                        for_each_xml_child_node(propsNode, objectNode)
+                        {
+                            if (xmlNameEqual(propsNode, "properties"))
+                                readProperties(propsNode, &props);
+                        }
+                        const std::string destMap
+                            = props.getProperty("dest_map");
+                        if (!destMap.empty())
+                            map->addWarp(destMap, objX, objY, objW, objH);
                     }
                     else if (objType == "SPAWN")
                     {
@@ -444,7 +522,230 @@ inline static void setTile(Map *map, MapLayer *layer, int x, int y, int gid)
     }
 }
 
-void MapReader::readLayer(XmlNodePtr node, Map *map)
+namespace
+{
+    /**
+     * Last resolved gid. Layers mostly have runs of same tile.
+     */
+    struct GidCache
+    {
+        GidCache() :
+            gid(-1),
+            image(nullptr),
+            animation(nullptr)
+        { }
+
+        int gid;
+        Image *image;
+        TileAnimation *animation;
+    };
+}
+
+inline static void setLayerTile(Map *map, MapLayer *layer, int index,
+                                int w, int gid, GidCache &cache)
+{
+    if (gid != cache.gid)
+    {
+        cache.gid = gid;
+        const Tileset * const set = map->getTilesetWithGid(gid);
+        cache.image = set ? set->get(gid - set->getFirstGid()) : nullptr;
+        cache.animation = map->getAnimationForGid(gid);
+    }
+
+    if (layer)
+        layer->setTile(index, cache.image);
+    else
+        setTile(map, nullptr, index % w, index / w, gid);
+
+    if (cache.animation)
+        cache.animation->addAffectedTile(layer, index);
+}
+
+/**
+ * Inflates zlib or gzip data into buffer of known size. Data after end of
+ * buffer is ignored. Returns inflated length or -1 on error.
+ */
+static int inflateToBuffer(unsigned char *in, unsigned int inLength,
+                           unsigned char *out, unsigned int outLength)
+{
+    z_stream strm;
+
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.next_in = in;
+    strm.avail_in = inLength;
+    strm.next_out = out;
+    strm.avail_out = outLength;
+
+    if (inflateInit2(&strm, 15 + 32) != Z_OK)
+        return -1;
+
+    const int ret = inflate(&strm, Z_FINISH);
+    const int len = static_cast<int>(outLength - strm.avail_out);
+    (void) inflateEnd(&strm);
+
+    // Z_BUF_ERROR with full buffer means layer has more data than needed
+    if (ret == Z_STREAM_END || (ret == Z_BUF_ERROR && !strm.avail_out))
+        return len;
+    return -1;
+}
+
+/**
+ * Decodes base64 or csv layer data element into array of w * h gids.
+ * Returns array allocated with malloc, or nullptr on error.
+ */
+static int *decodeLayerData(XmlNodePtr node, const int w, const int h,
+                            int &count)
+{
+    count = 0;
+    const std::string encoding = XML::getProperty(node, "encoding", "");
+    const std::string compression =
+        XML::getProperty(node, "compression", "");
+
+    if (encoding == "base64" && !compression.empty()
+        && compression != "gzip" && compression != "zlib")
+    {
+        logger->log1("Warning: only gzip layer compression supported!");
+        return nullptr;
+    }
+
+    XmlNodePtr dataChild = node->xmlChildrenNode;
+    if (!dataChild)
+        return nullptr;
+
+    xmlChar *xmlChars = xmlNodeGetContent(dataChild);
+    if (!xmlChars)
+        return nullptr;
+
+    const int size = w * h;
+    int *gids = static_cast<int*>(malloc(size * 4));
+    if (!gids)
+    {
+        xmlFree(xmlChars);
+        logger->log1("Error: Could not allocate layer!");
+        return nullptr;
+    }
+
+    if (encoding == "base64")
+    {
+        const unsigned char *charStart
+            = reinterpret_cast<const unsigned char*>(xmlChars);
+        unsigned char *binData = reinterpret_cast<unsigned char*>(gids);
+        int binLen;
+
+        if (compression == "gzip" || compression == "zlib")
+        {
+            // decode and inflate directly into layer sized buffer
+            const int len = static_cast<int>(strlen(
+                reinterpret_cast<const char*>(charStart)));
+            unsigned char *zipData = static_cast<unsigned char*>(
+                malloc(len / 4 * 3 + 3));
+            if (!zipData)
+            {
+                free(gids);
+                xmlFree(xmlChars);
+                logger->log1("Error: Could not allocate layer!");
+                return nullptr;
+            }
+            const int zipLen = php3_base64_decode_to(charStart,
+                zipData, len / 4 * 3 + 3);
+            binLen = inflateToBuffer(zipData, zipLen, binData, size * 4);
+            free(zipData);
+        }
+        else
+        {
+            binLen = php3_base64_decode_to(charStart, binData, size * 4);
+        }
+        xmlFree(xmlChars);
+
+        if (binLen < 0)
+        {
+            free(gids);
+            logger->log1("Error: Could not decompress layer!");
+            return nullptr;
+        }
+
+        // gids are little endian, convert in place
+        count = binLen / 4;
+        const unsigned char *ptr = binData;
+        for (int i = 0; i < count; i ++, ptr += 4)
+            gids[i] = ptr[0] | ptr[1] << 8 | ptr[2] << 16 | ptr[3] << 24;
+    }
+    else
+    {
+        const char *data = reinterpret_cast<const char*>(xmlChars);
+        while (count < size)
+        {
+            char *end = nullptr;
+            const int gid = static_cast<int>(strtol(data, &end, 10));
+            if (end == data)
+                break;
+
+            gids[count] = gid;
+            count ++;
+
+            data = end;
+            while (*data == ',' || *data == ' ' || *data == '\t'
+                   || *data == '\n' || *data == '\r')
+            {
+                data ++;
+            }
+        }
+        xmlFree(xmlChars);
+    }
+    return gids;
+}
+
+void MapReader::decodeLayers(XmlNodePtr node, LayerTilesMap &layers)
+{
+    if (!node)
+        return;
+
+    const int mapWidth = XML::getProperty(node, "width", 0);
+    const int mapHeight = XML::getProperty(node, "height", 0);
+
+    for_each_xml_child_node(layerNode, node)
+    {
+        if (!xmlNameEqual(layerNode, "layer"))
+            continue;
+
+        const int w = XML::getProperty(layerNode, "width", mapWidth);
+        const int h = XML::getProperty(layerNode, "height", mapHeight);
+        if (w <= 0 || h <= 0)
+            continue;
+
+        for_each_xml_child_node(dataNode, layerNode)
+        {
+            if (!xmlNameEqual(dataNode, "data"))
+                continue;
+
+            const std::string encoding =
+                XML::getProperty(dataNode, "encoding", "");
+            if (encoding == "base64" || encoding == "csv")
+            {
+                LayerTiles tiles;
+                tiles.gids = decodeLayerData(dataNode, w, h, tiles.count);
+                if (tiles.gids)
+                    layers[dataNode] = tiles;
+            }
+            break;
+        }
+    }
+}
+
+void MapReader::freeLayers(LayerTilesMap &layers)
+{
+    for (LayerTilesMap::iterator it = layers.begin(), it_end = layers.end();
+         it != it_end; ++ it)
+    {
+        free((*it).second.gids);
+    }
+    layers.clear();
+}
+
+void MapReader::readLayer(XmlNodePtr node, Map *map,
+                          const LayerTilesMap *const layers)
 {
     // Layers are not necessarily the same size as the map
     const int w = XML::getProperty(node, "width", map->getWidth());
@@ -454,6 +755,12 @@ void MapReader::readLayer(XmlNodePtr node, Map *map)
     std::string name = XML::getProperty(node, "name", "");
     name = toLower(name);
 
+    if (w <= 0 || h <= 0)
+    {
+        logger->log("Warning: empty layer \"%s\"", name.c_str());
+        return;
+    }
+
     const bool isFringeLayer = (name.substr(0, 6) == "fringe");
     const bool isCollisionLayer = (name.substr(0, 9) == "collision");
 
@@ -497,142 +804,36 @@ void MapReader::readLayer(XmlNodePtr node, Map *map)
 
         const std::string encoding =
             XML::getProperty(childNode, "encoding", "");
-        const std::string compression =
-            XML::getProperty(childNode, "compression", "");
 
-        if (encoding == "base64")
+        if (encoding == "base64" || encoding == "csv")
         {
-            if (!compression.empty() && compression != "gzip"
-                && compression != "zlib")
-            {
-                logger->log1("Warning: only gzip layer"
-                             " compression supported!");
-                return;
-            }
-
-            // Read base64 encoded map file
-            XmlNodePtr dataChild = childNode->xmlChildrenNode;
-            if (!dataChild)
-                continue;
-
-            int len = static_cast<int>(strlen(
-                reinterpret_cast<const char*>(dataChild->content)) + 1);
-            unsigned char *charData = new unsigned char[len + 1];
-            xmlChar *xmlChars = xmlNodeGetContent(dataChild);
-            const char *charStart = reinterpret_cast<const char*>(xmlChars);
-            if (!charStart)
-            {
-                delete [] charData;
-                return;
-            }
-
-            unsigned char *charIndex = charData;
-
-            while (*charStart)
-            {
-                if (*charStart != ' ' && *charStart != '\t' &&
-                    *charStart != '\n')
-                {
-                    *charIndex = *charStart;
-                    charIndex++;
-                }
-                charStart++;
-            }
-            *charIndex = '\0';
-
-            int binLen;
-            unsigned char *binData = php3_base64_decode(charData,
-                static_cast<int>(strlen(reinterpret_cast<char*>(
-                charData))), &binLen);
-
-            delete [] charData;
-            xmlFree(xmlChars);
-
-            if (binData)
+            const int *gids = nullptr;
+            int count = 0;
+            int *decoded = nullptr;
+            if (layers)
             {
-                if (compression == "gzip" || compression == "zlib")
-                {
-                    // Inflate the gzipped layer data
-                    unsigned char *inflated;
-                    unsigned int inflatedSize =
-                        inflateMemory(binData, binLen, inflated);
-
-                    free(binData);
-                    binData = inflated;
-                    binLen = inflatedSize;
-
-                    if (!inflated)
-                    {
-                        logger->log1("Error: Could not decompress layer!");
-                        return;
-                    }
-                }
-
-                for (int i = 0; i < binLen - 3; i += 4)
+                const LayerTilesMap::const_iterator it
+                    = layers->find(childNode);
+                if (it != layers->end())
                 {
-                    const int gid = binData[i] |
-                        binData[i + 1] << 8 |
-                        binData[i + 2] << 16 |
-                        binData[i + 3] << 24;
-
-                    setTile(map, layer, x, y, gid);
-
-                    TileAnimation* ani = map->getAnimationForGid(gid);
-                    if (ani)
-                        ani->addAffectedTile(layer, x + y * w);
-
-                    x++;
-                    if (x == w)
-                    {
-                        x = 0; y++;
-
-                        // When we're done, don't crash on too much data
-                        if (y == h)
-                            break;
-                    }
+                    gids = (*it).second.gids;
+                    count = (*it).second.count;
                 }
-                free(binData);
             }
-        }
-        else if (encoding == "csv")
-        {
-            XmlNodePtr dataChild = childNode->xmlChildrenNode;
-            if (!dataChild)
-                continue;
-
-            xmlChar *xmlChars = xmlNodeGetContent(dataChild);
-            const char *data = reinterpret_cast<const char*>(xmlChars);
-            if (!data)
-                return;
-
-            std::string csv(data);
-
-            size_t pos = 0;
-            size_t oldPos = 0;
-
-            while (oldPos != csv.npos)
+            if (!gids)
             {
-                pos = csv.find_first_of(",", oldPos);
-                if (pos == csv.npos)
+                decoded = decodeLayerData(childNode, w, h, count);
+                if (!decoded)
                     return;
-
-                const int gid = atoi(csv.substr(oldPos, pos - oldPos).c_str());
-
-                setTile(map, layer, x, y, gid);
-
-                x++;
-                if (x == w)
-                {
-                    x = 0; y++;
-
-                    // When we're done, don't crash on too much data
-                    if (y == h)
-                        break;
-                }
-
-                oldPos = pos + 1;
+                gids = decoded;
             }
-            xmlFree(xmlChars);
+
+            GidCache cache;
+            for (int i = 0; i < count; i ++)
+                setLayerTile(map, layer, i, w, gids[i], cache);
+            free(decoded);
+            x = count % w;
+            y = count / w;
         }
         else
         {
@@ -23,14 +23,29 @@
 #ifndef MAPREADER_H
 #define MAPREADER_H
 
+#include "localconsts.h"
+
+#include "utils/stringvector.h"
 #include "utils/xml.h"
 
+#include <map>
 #include <string>
 
 class Map;
 class Properties;
 class Tileset;
 
+/**
+ * Tile gids of layer data element, decoded before map creation.
+ */
+struct LayerTiles
+{
+    int *gids;
+    int count;
+};
+
+typedef std::map<XmlNodePtr, LayerTiles> LayerTilesMap;
+
 /**
  * Reader for XML map files (*.tmx)
  */
@@ -45,13 +60,38 @@ class MapReader
 
         /**
          * Read an XML map from a parsed XML tree. The path is used to find the
-         * location of referenced tileset images.
+         * location of referenced tileset images. Layers found in layers are
+         * not decoded again.
          */
-        static Map *readMap(XmlNodePtr node, const std::string &path);
+        static Map *readMap(XmlNodePtr node, const std::string &path,
+                            const LayerTilesMap *const layers = nullptr);
 
         static Map *createEmptyMap(const std::string &filename,
                                    const std::string &realFilename);
 
+        /**
+         * Loads, inflates and parses map file. Can be called from other
+         * threads: it uses only thread safe file loading and logger, and not
+         * touches resource cache. Returns nullptr and sets found to false if
+         * file not exists.
+         */
+        static XML::Document *loadDocument(const std::string &realFilename,
+                                           bool &found);
+
+        /**
+         * Collects tileset images, music and minimap used by parsed map.
+         */
+        static void getMapResources(XmlNodePtr node, const std::string &path,
+                                    StringVect &images, std::string &music);
+
+        /**
+         * Decodes base64 and csv layers of parsed map. Can be called from
+         * other threads.
+         */
+        static void decodeLayers(XmlNodePtr node, LayerTilesMap &layers);
+
+        static void freeLayers(LayerTilesMap &layers);
+
     private:
         /**
          * Reads the properties element.
@@ -65,7 +105,8 @@ class MapReader
         /**
          * Reads a map layer and adds it to the given map.
          */
-        static void readLayer(XmlNodePtr node, Map *map);
+        static void readLayer(XmlNodePtr node, Map *map,
+                              const LayerTilesMap *const layers);
 
         /**
          * Reads a tile set.
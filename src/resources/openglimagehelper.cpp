@@ -24,6 +24,7 @@
 
 #ifdef USE_OPENGL
 
+#include "resources/atlasmanager.h"
 #include "resources/dye.h"
 #include "resources/resourcemanager.h"
 
@@ -47,22 +48,40 @@ int OpenGLImageHelper::mInternalTextureType = GL_RGBA8;
 int OpenGLImageHelper::mTextureSize = 0;
 bool OpenGLImageHelper::mBlur = true;
 int OpenGLImageHelper::mUseOpenGL = 0;
+bool OpenGLImageHelper::mNpotTextures = false;
+int OpenGLImageHelper::mTextureBytes[TEXTURE_CATEGORIES] = {0, 0, 0};
+int OpenGLImageHelper::mPaddingBytes = 0;
 
 Resource *OpenGLImageHelper::load(SDL_RWops *rw, Dye const &dye)
 {
-    SDL_Surface *tmpImage = IMG_Load_RW(rw, 1);
+    SDL_Surface *surf = loadDyedSurface(rw, dye);
 
-    if (!tmpImage)
+    if (!surf)
     {
         logger->log("Error, image load failed: %s", IMG_GetError());
         return nullptr;
     }
 
+    Image *image = load(surf);
+    SDL_FreeSurface(surf);
+    return image;
+}
+
+SDL_Surface *OpenGLImageHelper::loadDyedSurface(SDL_RWops *rw,
+                                                Dye const &dye)
+{
+    SDL_Surface *tmpImage = IMG_Load_RW(rw, 1);
+
+    if (!tmpImage)
+        return nullptr;
+
     SDL_Surface *surf = convertTo32Bit(tmpImage);
     SDL_FreeSurface(tmpImage);
+    if (!surf)
+        return nullptr;
 
     uint32_t *pixels = static_cast<uint32_t *>(surf->pixels);
-    DyePalette *pal = dye.getSPalete();
+    const DyePalette *const pal = dye.getSPalete();
 
     if (pal)
     {
@@ -94,13 +113,14 @@ Resource *OpenGLImageHelper::load(SDL_RWops *rw, Dye const &dye)
         }
     }
 
-    Image *image = load(surf);
-    SDL_FreeSurface(surf);
-    return image;
+    return surf;
 }
 
 Image *OpenGLImageHelper::load(SDL_Surface *tmpImage)
 {
+    // small images share atlas textures
+    if (Image *const image = AtlasManager::add(tmpImage))
+        return image;
     return _GLload(tmpImage);
 }
 
@@ -109,7 +129,7 @@ Image *OpenGLImageHelper::createTextSurface(SDL_Surface *tmpImage, float alpha)
     if (!tmpImage)
         return nullptr;
 
-    Image *img = _GLload(tmpImage);
+    Image *img = _GLload(tmpImage, TEXTURE_TEXT);
     if (img)
         img->setAlpha(alpha);
     return img;
@@ -118,7 +138,7 @@ Image *OpenGLImageHelper::createTextSurface(SDL_Surface *tmpImage, float alpha)
 int OpenGLImageHelper::powerOfTwo(int input)
 {
     int value;
-    if (mTextureType == GL_TEXTURE_2D)
+    if (mTextureType == GL_TEXTURE_2D && !mNpotTextures)
     {
         value = 1;
         while (value < input && value < mTextureSize)
@@ -131,24 +151,53 @@ int OpenGLImageHelper::powerOfTwo(int input)
     return value >= mTextureSize ? mTextureSize : value;
 }
 
-Image *OpenGLImageHelper::_GLload(SDL_Surface *tmpImage)
+Image *OpenGLImageHelper::_GLload(SDL_Surface *tmpImage, const int category)
 {
     if (!tmpImage)
         return nullptr;
 
-    // Flush current error flag.
-    glGetError();
+    bool cropped = false;
+    SDL_Surface *const surface = prepareSurface(tmpImage, cropped);
+    if (cropped)
+    {
+        logger->log("Warning: image too large, cropping to %dx%d texture!",
+                    tmpImage->w, tmpImage->h);
+    }
+    if (!surface)
+    {
+        logger->log1("Error, image convert failed: out of memory");
+        return nullptr;
+    }
+
+    Image *const image = uploadSurface(surface, tmpImage->w, tmpImage->h,
+        category);
+    if (surface != tmpImage)
+        SDL_FreeSurface(surface);
+    return image;
+}
+
+SDL_Surface *OpenGLImageHelper::prepareSurface(SDL_Surface *tmpImage,
+                                               bool &cropped)
+{
+    if (!tmpImage)
+        return nullptr;
 
     int width = tmpImage->w;
     int height = tmpImage->h;
     int realWidth = powerOfTwo(width);
     int realHeight = powerOfTwo(height);
 
-    if (realWidth < width || realHeight < height)
-    {
-        logger->log("Warning: image too large, cropping to %dx%d texture!",
-                    tmpImage->w, tmpImage->h);
-    }
+    cropped = realWidth < width || realHeight < height;
+
+    return convertSurface(tmpImage, realWidth, realHeight);
+}
+
+SDL_Surface *OpenGLImageHelper::convertSurface(SDL_Surface *tmpImage,
+                                               const int realWidth,
+                                               const int realHeight)
+{
+    if (!tmpImage)
+        return nullptr;
 
     // Make sure the alpha channel is not used, but copied to destination
     SDL_SetAlpha(tmpImage, 0, SDL_ALPHA_OPAQUE);
@@ -167,47 +216,38 @@ Image *OpenGLImageHelper::_GLload(SDL_Surface *tmpImage)
     amask = 0xff000000;
 #endif
 
-    SDL_Surface *oldImage = nullptr;
     if (tmpImage->format->BitsPerPixel != 32
-        || realWidth != width || realHeight != height
+        || realWidth != tmpImage->w || realHeight != tmpImage->h
         || rmask != tmpImage->format->Rmask
         || gmask != tmpImage->format->Gmask
         || amask != tmpImage->format->Amask)
     {
-        oldImage = tmpImage;
+        SDL_Surface *const oldImage = tmpImage;
         tmpImage = SDL_CreateRGBSurface(SDL_SWSURFACE, realWidth, realHeight,
             32, rmask, gmask, bmask, amask);
 
         if (!tmpImage)
-        {
-            logger->log("Error, image convert failed: out of memory");
             return nullptr;
-        }
         SDL_BlitSurface(oldImage, nullptr, tmpImage, nullptr);
     }
+    return tmpImage;
+}
 
-    GLuint texture;
-    glGenTextures(1, &texture);
-    if (mUseOpenGL == 1)
-        OpenGLGraphics::bindTexture(mTextureType, texture);
-    else if (mUseOpenGL == 2)
-        OpenGL1Graphics::bindTexture(mTextureType, texture);
+Image *OpenGLImageHelper::uploadSurface(SDL_Surface *tmpImage,
+                                        const int width, const int height,
+                                        const int category)
+{
+    if (!tmpImage)
+        return nullptr;
+
+    // Flush current error flag.
+    glGetError();
+
+    const GLuint texture = createTextureId();
 
     if (SDL_MUSTLOCK(tmpImage))
         SDL_LockSurface(tmpImage);
 
-    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-    if (mBlur)
-    {
-        glTexParameteri(mTextureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(mTextureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-    else
-    {
-        glTexParameteri(mTextureType, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(mTextureType, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    }
-
     glTexImage2D(mTextureType, 0, mInternalTextureType,
         tmpImage->w, tmpImage->h,
         0, GL_RGBA, GL_UNSIGNED_BYTE, tmpImage->pixels);
@@ -229,9 +269,71 @@ Image *OpenGLImageHelper::_GLload(SDL_Surface *tmpImage)
     if (SDL_MUSTLOCK(tmpImage))
         SDL_UnlockSurface(tmpImage);
 
-    if (oldImage)
-        SDL_FreeSurface(tmpImage);
+    if (!checkError())
+        return nullptr;
+
+    Image *const image = new Image(texture, width, height,
+        tmpImage->w, tmpImage->h);
+    addTexture(image, getTextureSize(tmpImage->w, tmpImage->h), category);
+    return image;
+}
+
+Image *OpenGLImageHelper::createTexture(const int width, const int height,
+                                        const int category)
+{
+    // Flush current error flag.
+    glGetError();
+
+    const GLuint texture = createTextureId();
+
+    // cleared, so filtering not picks garbage around images
+    void *const pixels = calloc(width * height, 4);
+    if (!pixels)
+    {
+        glDeleteTextures(1, &texture);
+        return nullptr;
+    }
+    glTexImage2D(mTextureType, 0, mInternalTextureType, width, height,
+        0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    free(pixels);
+
+#ifdef DEBUG_OPENGL_LEAKS
+    textures_count ++;
+#endif
+
+    if (!checkError())
+        return nullptr;
+
+    Image *const image = new Image(texture, width, height, width, height);
+    addTexture(image, getTextureSize(width, height), category);
+    return image;
+}
+
+GLuint OpenGLImageHelper::createTextureId()
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    if (mUseOpenGL == 1)
+        OpenGLGraphics::bindTexture(mTextureType, texture);
+    else if (mUseOpenGL == 2)
+        OpenGL1Graphics::bindTexture(mTextureType, texture);
+
+    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    if (mBlur)
+    {
+        glTexParameteri(mTextureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(mTextureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    else
+    {
+        glTexParameteri(mTextureType, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(mTextureType, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    return texture;
+}
 
+bool OpenGLImageHelper::checkError()
+{
     GLenum error = glGetError();
     if (error)
     {
@@ -260,10 +362,69 @@ Image *OpenGLImageHelper::_GLload(SDL_Surface *tmpImage)
                 break;
         }
         logger->log("Error: Image GL import failed: %s", errmsg.c_str());
-        return nullptr;
+        return false;
+    }
+    return true;
+}
+
+int OpenGLImageHelper::getTextureSize(const int width, const int height)
+{
+    if (mInternalTextureType == GL_RGBA8 || mInternalTextureType == GL_RGBA
+        || mInternalTextureType == 4)
+    {
+        return width * height * 4;
     }
 
-    return new Image(texture, width, height, realWidth, realHeight);
+    // compressed formats, ask driver about bound texture
+    GLint compressed = 0;
+    glGetTexLevelParameteriv(mTextureType, 0,
+        GL_TEXTURE_COMPRESSED_ARB, &compressed);
+    if (!compressed)
+        return width * height * 4;
+    GLint size = 0;
+    glGetTexLevelParameteriv(mTextureType, 0,
+        GL_TEXTURE_COMPRESSED_IMAGE_SIZE_ARB, &size);
+    return size;
+}
+
+void OpenGLImageHelper::addTexture(Image *const image, const int bytes,
+                                   const int category)
+{
+    image->mTextureBytes = bytes;
+    image->mTextureCategory = category;
+    mTextureBytes[category] += bytes;
+    mPaddingBytes += getPaddingBytes(image, bytes);
+}
+
+void OpenGLImageHelper::removeTexture(const Image *const image)
+{
+    if (!image || !image->mTextureBytes)
+        return;
+
+    mTextureBytes[image->mTextureCategory] -= image->mTextureBytes;
+    mPaddingBytes -= getPaddingBytes(image, image->mTextureBytes);
+}
+
+int OpenGLImageHelper::getTotalTextureBytes()
+{
+    int bytes = 0;
+    for (int f = 0; f < TEXTURE_CATEGORIES; f ++)
+        bytes += mTextureBytes[f];
+    return bytes;
+}
+
+int OpenGLImageHelper::getPaddingBytes(const Image *const image,
+                                       const int bytes)
+{
+    // free space in atlas pages is not padding
+    if (image->mTextureCategory == TEXTURE_ATLAS)
+        return 0;
+
+    const long long texArea = image->mTexWidth * image->mTexHeight;
+    if (!texArea)
+        return 0;
+    const long long area = image->mBounds.w * image->mBounds.h;
+    return bytes - static_cast<int>(bytes * area / texArea);
 }
 
 void OpenGLImageHelper::setLoadAsOpenGL(int useOpenGL)
@@ -50,11 +50,20 @@ class Image;
  */
 class OpenGLImageHelper : public ImageHelper
 {
+    friend class AtlasManager;
     friend class CompoundSprite;
     friend class Graphics;
     friend class Image;
 
     public:
+        enum TextureCategory
+        {
+            TEXTURE_IMAGE = 0,
+            TEXTURE_TEXT,
+            TEXTURE_ATLAS,
+            TEXTURE_CATEGORIES
+        };
+
         virtual ~OpenGLImageHelper()
         { }
 
@@ -78,6 +87,64 @@ class OpenGLImageHelper : public ImageHelper
 
         // OpenGL only public functions
 
+        /**
+         * Loads and recolors image into 32 bit surface. Not uses OpenGL
+         * and not logs, so can be used from image streamer thread.
+         */
+        SDL_Surface *loadDyedSurface(SDL_RWops *rw, Dye const &dye);
+
+        /**
+         * Converts surface into RGBA surface with texture size. Returns
+         * same surface if it already fits. Sets cropped if image is bigger
+         * than max texture size. Not uses OpenGL and not logs, so can be
+         * used from image streamer thread.
+         */
+        static SDL_Surface *prepareSurface(SDL_Surface *tmpImage,
+                                           bool &cropped);
+
+        /**
+         * Creates texture from surface returned by prepareSurface.
+         */
+        Image *uploadSurface(SDL_Surface *surface,
+                             const int width, const int height,
+                             const int category = TEXTURE_IMAGE);
+
+        /**
+         * Converts surface into RGBA surface with given size. Returns
+         * nullptr if out of memory. Not logs.
+         */
+        static SDL_Surface *convertSurface(SDL_Surface *tmpImage,
+                                           const int width,
+                                           const int height);
+
+        /**
+         * Creates empty texture for atlas page.
+         */
+        Image *createTexture(const int width, const int height,
+                             const int category);
+
+        /**
+         * Allows textures with any size, if driver supports them.
+         */
+        static void setNpotTextures(const bool n)
+        { mNpotTextures = n; }
+
+        /**
+         * Returns texture memory in bytes, used by given category.
+         */
+        static int getTextureBytes(const int category)
+        { return mTextureBytes[category]; }
+
+        static int getTotalTextureBytes();
+
+        /**
+         * Returns texture memory spent on padding images to texture size.
+         */
+        static int getPaddingBytes()
+        { return mPaddingBytes; }
+
+        static void removeTexture(const Image *const image);
+
         /**
          * Sets the target image format. Use <code>false</code> for SDL and
          * <code>true</code> for OpenGL.
@@ -110,13 +177,31 @@ class OpenGLImageHelper : public ImageHelper
         /**
          * Returns the first power of two equal or bigger than the input.
          */
-        int powerOfTwo(int input);
+        static int powerOfTwo(int input);
+
+        Image *_GLload(SDL_Surface *tmpImage,
+                       const int category = TEXTURE_IMAGE);
+
+#ifdef USE_OPENGL
+        static GLuint createTextureId();
+#endif
+
+        static bool checkError();
+
+        static int getTextureSize(const int width, const int height);
+
+        static void addTexture(Image *const image, const int bytes,
+                               const int category);
 
-        Image *_GLload(SDL_Surface *tmpImage);
+        static int getPaddingBytes(const Image *const image,
+                                   const int bytes);
 
         static int mUseOpenGL;
         static int mTextureSize;
         static bool mBlur;
+        static bool mNpotTextures;
+        static int mTextureBytes[TEXTURE_CATEGORIES];
+        static int mPaddingBytes;
 };
 
 #endif
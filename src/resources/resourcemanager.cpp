@@ -28,23 +28,31 @@
 #include "logger.h"
 #include "main.h"
 
+#include "resources/atlasmanager.h"
+#include "resources/contentpack.h"
 #include "resources/dye.h"
 #include "resources/image.h"
 #include "resources/imagehelper.h"
 #include "resources/imageset.h"
 #include "resources/music.h"
+#include "resources/openglimagehelper.h"
 #include "resources/soundeffect.h"
 #include "resources/spritedef.h"
+#include "resources/subimage.h"
 
+#include "utils/framepacer.h"
 #include "utils/mkdir.h"
 #include "utils/physfsrwops.h"
+#include "utils/profiler.h"
 
 #include <physfs.h>
 #include <SDL_image.h>
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <vector>
 #include <zlib.h>
 
 #include <sys/stat.h>
@@ -53,7 +61,9 @@
 #include "debug.h"
 
 ResourceManager *ResourceManager::instance = nullptr;
-DelayedAnim ResourceManager::mDelayedAnimations;
+DelayedAnim ResourceManager::mDelayedAnimations[
+    AnimationDelayLoad::PRIORITY_COUNT];
+int ResourceManager::mBudgetTime = 0;
 
 ResourceManager::ResourceManager() :
     mOldestOrphan(0),
@@ -136,6 +146,31 @@ ResourceManager::~ResourceManager()
         }
     }
 
+    // Release sub images before remaining images, because atlas sub images
+    // depend on atlas pages
+    iter = mResources.begin();
+    while (iter != mResources.end())
+    {
+#ifdef DEBUG_LEAKS
+        if (iter->second && iter->second->getRefCount())
+        {
+            ++iter;
+            continue;
+        }
+#endif
+        if (dynamic_cast<SubImage*>(iter->second))
+        {
+            cleanUp(iter->second);
+            ResourceIterator toErase = iter;
+            ++iter;
+            mResources.erase(toErase);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
     // Release remaining resources, logging the number of dangling references.
     iter = mResources.begin();
     while (iter != mResources.end())
@@ -160,6 +195,7 @@ ResourceManager::~ResourceManager()
         }
     }
     clearScheduled();
+    ContentPack::unload();
 }
 
 void ResourceManager::cleanUp(Resource *res)
@@ -223,6 +259,10 @@ bool ResourceManager::cleanOrphans(bool always)
     }
 
     mOldestOrphan = oldest;
+
+    // deleted sub images may leave atlas pages empty
+    if (status)
+        AtlasManager::releaseUnused(true);
     return status;
 }
 
@@ -240,6 +280,8 @@ bool ResourceManager::addToSearchPath(const std::string &path, bool append)
         logger->log("Error: %s", PHYSFS_getLastError());
         return false;
     }
+    if (ContentPack::isLoaded())
+        ContentPack::updateShadows();
     return true;
 }
 
@@ -251,6 +293,8 @@ bool ResourceManager::removeFromSearchPath(const std::string &path)
         logger->log("Error: %s", PHYSFS_getLastError());
         return false;
     }
+    if (ContentPack::isLoaded())
+        ContentPack::updateShadows();
     return true;
 }
 
@@ -305,6 +349,28 @@ void ResourceManager::searchAndRemoveArchives(const std::string &path,
     PHYSFS_freeList(list);
 }
 
+void ResourceManager::loadContentPack(const std::string &updatesDir)
+{
+    StringVect archives;
+    char **list = PHYSFS_getSearchPath();
+
+    for (char **i = list; *i; i++)
+    {
+        const std::string path = *i;
+        struct stat statbuf;
+        if (!path.compare(0, updatesDir.size(), updatesDir)
+            && !stat(path.c_str(), &statbuf) && !S_ISDIR(statbuf.st_mode))
+        {
+            archives.push_back(path);
+        }
+    }
+
+    PHYSFS_freeList(list);
+
+    ContentPack::load(updatesDir + "/content.pack", archives,
+        config.getBoolValue("compressContentPack"));
+}
+
 bool ResourceManager::mkdir(const std::string &path)
 {
     return static_cast<bool>(PHYSFS_mkdir(path.c_str()));
@@ -312,7 +378,7 @@ bool ResourceManager::mkdir(const std::string &path)
 
 bool ResourceManager::exists(const std::string &path)
 {
-    return PHYSFS_exists(path.c_str());
+    return ContentPack::exists(path) || PHYSFS_exists(path.c_str());
 }
 
 bool ResourceManager::existsLocal(const std::string &path)
@@ -399,6 +465,7 @@ Resource *ResourceManager::getFromCache(const std::string &idPath)
 Resource *ResourceManager::get(const std::string &idPath, generator fun,
                                void *data)
 {
+    PROFILER_SCOPE(ZONE_RESOURCES);
 #ifndef DISABLE_RESOURCE_CACHING
     Resource *resource = getFromCache(idPath);
     if (resource)
@@ -430,6 +497,20 @@ Resource *ResourceManager::get(const std::string &idPath, generator fun,
     return resource;
 }
 
+SDL_RWops *ResourceManager::openRead(const std::string &path,
+                                     const bool copy)
+{
+    bool broken = false;
+    if (SDL_RWops *const rw = ContentPack::openRead(path, copy, broken))
+        return rw;
+    if (broken)
+    {
+        logger->log("Error: broken file in content pack: %s",
+                    path.c_str());
+    }
+    return PHYSFSRWOPS_openRead(path.c_str());
+}
+
 struct ResourceLoader
 {
     ResourceManager *manager;
@@ -441,7 +522,7 @@ struct ResourceLoader
         if (!v)
             return nullptr;
         ResourceLoader *rl = static_cast< ResourceLoader * >(v);
-        SDL_RWops *rw = PHYSFSRWOPS_openRead(rl->path.c_str());
+        SDL_RWops *rw = ResourceManager::openRead(rl->path);
         if (!rw)
             return nullptr;
         Resource *res = rl->fun(rw);
@@ -455,9 +536,27 @@ Resource *ResourceManager::load(const std::string &path, loader fun)
     return get(path, ResourceLoader::load, &rl);
 }
 
+struct MusicLoader
+{
+    std::string path;
+
+    static Resource *load(void *v)
+    {
+        if (!v)
+            return nullptr;
+        MusicLoader *ml = static_cast<MusicLoader*>(v);
+        // music is streamed while playing, so content pack data is copied
+        SDL_RWops *rw = ResourceManager::openRead(ml->path, true);
+        if (!rw)
+            return nullptr;
+        return Music::load(rw);
+    }
+};
+
 Music *ResourceManager::getMusic(const std::string &idPath)
 {
-    return static_cast<Music*>(load(idPath, Music::load));
+    MusicLoader ml = { idPath };
+    return static_cast<Music*>(get(idPath, MusicLoader::load, &ml));
 }
 
 SoundEffect *ResourceManager::getSoundEffect(const std::string &idPath)
@@ -479,22 +578,18 @@ struct DyedImageLoader
             return nullptr;
 
         std::string path = rl->path;
-        size_t p = path.find('|');
-        Dye *d = nullptr;
+        const size_t p = path.find('|');
+        const Dye *d = nullptr;
         if (p != std::string::npos)
         {
-            d = new Dye(path.substr(p + 1));
-            path = path.substr(0, p);
+            d = Dye::get(path.substr(p + 1));
+            path.erase(p);
         }
-        SDL_RWops *rw = PHYSFSRWOPS_openRead(path.c_str());
+        SDL_RWops *rw = ResourceManager::openRead(path);
         if (!rw)
-        {
-            delete d;
             return nullptr;
-        }
         Resource *res = d ? imageHelper->load(rw, *d)
                           : imageHelper->load(rw);
-        delete d;
         return res;
     }
 };
@@ -638,6 +733,9 @@ void ResourceManager::deleteInstance()
 
 void *ResourceManager::loadFile(const std::string &fileName, int &fileSize)
 {
+    if (void *const buffer = ContentPack::loadFile(fileName, fileSize))
+        return buffer;
+
     // Attempt to open the specified file using PhysicsFS
     PHYSFS_file *file = PHYSFS_openRead(fileName.c_str());
 
@@ -755,7 +853,7 @@ void ResourceManager::saveTextFile(std::string path, std::string name,
 SDL_Surface *ResourceManager::loadSDLSurface(const std::string &filename)
 {
     SDL_Surface *surface = nullptr;
-    if (SDL_RWops *rw = PHYSFSRWOPS_openRead(filename.c_str()))
+    if (SDL_RWops *rw = openRead(filename))
         surface = IMG_Load_RW(rw, 1);
     return surface;
 }
@@ -809,39 +907,129 @@ Image *ResourceManager::getRescaled(Image *image, int width, int height)
 
 void ResourceManager::delayedLoad()
 {
-    static int loadTime = 0;
-    if (loadTime < cur_time)
+    bool empty = true;
+    for (int p = 0; p < AnimationDelayLoad::PRIORITY_COUNT; p ++)
     {
-        loadTime = tick_time;
+        if (!mDelayedAnimations[p].empty())
+            empty = false;
+    }
+    if (empty)
+        return;
 
-        int k = 0;
-        DelayedAnimIter it = mDelayedAnimations.begin();
-        DelayedAnimIter it_end = mDelayedAnimations.end();
-        while (it != it_end && k < 1)
+    // move loads to bucket of current priority
+    for (int p = 0; p < AnimationDelayLoad::PRIORITY_COUNT; p ++)
+    {
+        DelayedAnim &anims = mDelayedAnimations[p];
+        DelayedAnimIter it = anims.begin();
+        while (it != anims.end())
         {
-            (*it)->load();
-            AnimationDelayLoad *tmp = *it;
-            it = mDelayedAnimations.erase(it);
-            delete tmp;
-            k ++;
+            AnimationDelayLoad *const load = *it;
+            load->updatePriority();
+            const int priority = load->getPriority();
+            if (priority == p)
+            {
+                ++ it;
+                continue;
+            }
+            DelayedAnimIter next = it;
+            ++ next;
+            DelayedAnim &target = mDelayedAnimations[priority];
+            target.splice(target.end(), anims, it);
+            it = next;
+        }
+    }
+
+    const long long endTime = FramePacer::getTime()
+        + config.getIntValue("delayedLoadBudget") * 1000;
+    int loaded = 0;
+
+    for (int p = 0; p < AnimationDelayLoad::PRIORITY_COUNT; p ++)
+    {
+        DelayedAnim &anims = mDelayedAnimations[p];
+        DelayedAnimIter it = anims.begin();
+        while (it != anims.end())
+        {
+            // at least one load per frame, even if budget is too small
+            if (loaded > 0 && FramePacer::getTime() >= endTime)
+                return;
+
+            AnimationDelayLoad *const load = *it;
+            // actor out of view, load it only if it comes back
+            if (!load->isVisible())
+            {
+                ++ it;
+                continue;
+            }
+
+            const std::string fileName = load->getFileName();
+            const int variant = load->getVariant();
+            it = anims.erase(it);
+            load->load();
+            delete load;
+            loaded ++;
+
+            // same sprite is in cache now, so waiting duplicates are cheap
+            for (int k = 0; k < AnimationDelayLoad::PRIORITY_COUNT; k ++)
+            {
+                DelayedAnim &dups = mDelayedAnimations[k];
+                DelayedAnimIter d = dups.begin();
+                while (d != dups.end())
+                {
+                    AnimationDelayLoad *const dup = *d;
+                    if (dup->getVariant() != variant
+                        || dup->getFileName() != fileName)
+                    {
+                        ++ d;
+                        continue;
+                    }
+                    if (k == p && d == it)
+                        ++ it;
+                    d = dups.erase(d);
+                    dup->load();
+                    delete dup;
+                }
+            }
         }
-        const int time2 = tick_time;
-        if (time2 > loadTime)
-            loadTime = time2 + (time2 - loadTime) * 2 + 10;
-        else
-            loadTime = time2 + 3;
     }
 }
 
 void ResourceManager::removeDelayLoad(AnimationDelayLoad *delayedLoad)
 {
-    for (DelayedAnimIter it = mDelayedAnimations.begin(),
-        it_end = mDelayedAnimations.end(); it != it_end; ++ it)
+    DelayedAnim &anims = mDelayedAnimations[delayedLoad->getPriority()];
+    for (DelayedAnimIter it = anims.begin(), it_end = anims.end();
+         it != it_end; ++ it)
     {
         if (*it == delayedLoad)
         {
-            mDelayedAnimations.erase(it);
+            anims.erase(it);
             return;
         }
     }
 }
+
+void ResourceManager::checkTextureBudget()
+{
+#ifdef USE_OPENGL
+    if (mBudgetTime == cur_time)
+        return;
+    mBudgetTime = cur_time;
+
+    const int budget = config.getIntValue("textureBudget");
+    if (budget <= 0 || !instance)
+        return;
+
+    const int bytes = OpenGLImageHelper::getTotalTextureBytes();
+    if (bytes / 1048576 < budget)
+        return;
+
+    // drop unused atlas pages and all unused images without waiting
+    AtlasManager::releaseUnused();
+    instance->cleanOrphans(true);
+    const int newBytes = OpenGLImageHelper::getTotalTextureBytes();
+    if (newBytes != bytes)
+    {
+        logger->log("Texture budget %d MiB exceeded, textures: %d -> %d KiB",
+            budget, bytes / 1024, newBytes / 1024);
+    }
+#endif
+}
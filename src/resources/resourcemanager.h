@@ -23,6 +23,7 @@
 #ifndef RESOURCE_MANAGER_H
 #define RESOURCE_MANAGER_H
 
+#include "animationdelayload.h"
 #include "main.h"
 
 #include "utils/stringvector.h"
@@ -32,7 +33,6 @@
 #include <map>
 #include <set>
 
-class AnimationDelayLoad;
 class Image;
 class ImageSet;
 class Music;
@@ -103,6 +103,12 @@ class ResourceManager
         void searchAndRemoveArchives(const std::string &path,
                                      const std::string &ext);
 
+        /**
+         * Mounts content pack of update archives from given directory
+         * ahead of search path, building it if updates changed.
+         */
+        void loadContentPack(const std::string &updatesDir);
+
         /**
          * Creates a directory in the write path
          */
@@ -225,6 +231,13 @@ class ResourceManager
          */
         static void *loadFile(const std::string &fileName, int &fileSize);
 
+        /**
+         * Opens file from content pack or search path for reading. Set
+         * copy if stream is kept after loading, see ContentPack::openRead.
+         */
+        static SDL_RWops *openRead(const std::string &path,
+                                   const bool copy = false);
+
         /**
          * Retrieves the contents of a text file (PhysFS).
          */
@@ -279,12 +292,23 @@ class ResourceManager
         bool cleanOrphans(bool always = false);
 
         static void addDelayedAnimation(AnimationDelayLoad *animation)
-        { mDelayedAnimations.push_back(animation); }
+        { mDelayedAnimations[animation->getPriority()].push_back(animation); }
 
+        /**
+         * Runs delayed loads by priority until frame budget is spent.
+         * Priorities are updated first. Loads for actors out of view are
+         * not run: they wait until actor is in view again, or are dropped
+         * together with actor sprites.
+         */
         static void delayedLoad();
 
         static void removeDelayLoad(AnimationDelayLoad *delayedLoad);
 
+        /**
+         * Frees unused textures if they use more memory than allowed.
+         */
+        static void checkTextureBudget();
+
     private:
         /**
          * Deletes the resource after logging a cleanup message.
@@ -299,7 +323,9 @@ class ResourceManager
         std::string mSelectedSkin;
         std::string mSkinName;
         bool mDestruction;
-        static DelayedAnim mDelayedAnimations;
+        static DelayedAnim mDelayedAnimations[
+            AnimationDelayLoad::PRIORITY_COUNT];
+        static int mBudgetTime;
 };
 
 #endif
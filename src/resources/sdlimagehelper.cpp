@@ -66,7 +66,7 @@ Resource *SDLImageHelper::load(SDL_RWops *rw, Dye const &dye)
     SDL_FreeSurface(tmpImage);
 
     uint32_t *pixels = static_cast<uint32_t *>(surf->pixels);
-    DyePalette *pal = dye.getSPalete();
+    const DyePalette *const pal = dye.getSPalete();
 
     if (pal)
     {
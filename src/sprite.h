@@ -28,6 +28,7 @@
 
 class Graphics;
 class Image;
+class Resource;
 
 class Sprite
 {
@@ -110,6 +111,13 @@ class Sprite
         virtual void *getHash()
         { return nullptr; }
 
+        /**
+         * Returns resource which owns object returned by getHash().
+         * Holding reference to it keeps hash valid.
+         */
+        virtual Resource *getHashResource() const
+        { return nullptr; }
+
         virtual void *getHash2()
         { return this; }
 
@@ -0,0 +1,218 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/benchmark.h"
+
+#include "configuration.h"
+#include "defaults.h"
+#include "graphics.h"
+#include "logger.h"
+
+#include "resources/resourcemanager.h"
+#include "resources/sdlimagehelper.h"
+
+#include "utils/mkdir.h"
+#include "utils/xml.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include <physfs.h>
+#include <SDL.h>
+
+#include <sys/time.h>
+
+#include "debug.h"
+
+#define BENCHMARK_RUNS 5
+
+unsigned int Benchmark::mAllocs = 0;
+unsigned long long Benchmark::mAllocBytes = 0;
+
+#ifndef ENABLE_MEM_DEBUG
+// count allocations made by measured code
+void *operator new(size_t size)
+{
+    Benchmark::mAllocs ++;
+    Benchmark::mAllocBytes += size;
+    void *const ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    Benchmark::mAllocs ++;
+    Benchmark::mAllocBytes += size;
+    void *const ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) throw()
+{
+    free(ptr);
+}
+#endif
+
+static long long getTime()
+{
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+    return static_cast<long long>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+Benchmark::Benchmark(const std::string &name, const int iterations) :
+    mName(name),
+    mIterations(iterations)
+{
+    getBenchmarks().push_back(this);
+}
+
+std::vector<Benchmark*> &Benchmark::getBenchmarks()
+{
+    static std::vector<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+void Benchmark::measure()
+{
+    srand(1);
+    init();
+
+    // warm up caches
+    run();
+
+    long long times[BENCHMARK_RUNS];
+    const unsigned int allocs = mAllocs;
+    const unsigned long long allocBytes = mAllocBytes;
+    for (int f = 0; f < BENCHMARK_RUNS; f ++)
+    {
+        const long long start = getTime();
+        for (int i = 0; i < mIterations; i ++)
+            run();
+        times[f] = getTime() - start;
+    }
+    const double ops = static_cast<double>(mIterations) * BENCHMARK_RUNS;
+    const double allocsPerOp = (mAllocs - allocs) / ops;
+    const double bytesPerOp = static_cast<double>(mAllocBytes - allocBytes)
+        / ops;
+
+    close();
+
+    std::sort(times, times + BENCHMARK_RUNS);
+    std::cout << mName << " " << mIterations << " "
+        << (times[0] * 1000 / mIterations) << " "
+        << (times[BENCHMARK_RUNS / 2] * 1000 / mIterations) << " "
+        << allocsPerOp << " " << bytesPerOp << std::endl;
+}
+
+bool Benchmark::initEnvironment(const char *const selfName)
+{
+    if (!PHYSFS_init(selfName))
+    {
+        std::cerr << "Error while initializing PhysFS: "
+            << PHYSFS_getLastError() << std::endl;
+        return false;
+    }
+    XML::initXML();
+
+    logger = new Logger;
+    logger->setLogToStandardOut(false);
+    logger->setLogFile(BENCHMARK_DIR ".log");
+
+    config.setDefaultValues(getConfigDefaults());
+    paths.setDefaultValues(getPathsDefaults());
+    branding.setDefaultValues(getBrandingDefaults());
+
+    mkdir_r(BENCHMARK_DIR);
+    ResourceManager *const resman = ResourceManager::getInstance();
+    resman->setWriteDir(BENCHMARK_DIR);
+    resman->addToSearchPath(PKG_DATADIR "data", false);
+    resman->addToSearchPath("data", false);
+    resman->addToSearchPath(BENCHMARK_DIR, false);
+
+    // software rendering without window
+    SDL_putenv(const_cast<char*>("SDL_VIDEODRIVER=dummy"));
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cerr << "Could not initialize SDL: "
+            << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    imageHelper = new SDLImageHelper;
+    mainGraphics = new Graphics;
+    if (!mainGraphics->setVideoMode(800, 600, 32,
+        false, false, false, false))
+    {
+        std::cerr << "Could not set video mode: "
+            << SDL_GetError() << std::endl;
+        return false;
+    }
+    mainGraphics->_beginDraw();
+    return true;
+}
+
+void Benchmark::closeEnvironment()
+{
+    mainGraphics->_endDraw();
+    delete mainGraphics;
+    mainGraphics = nullptr;
+    delete imageHelper;
+    imageHelper = nullptr;
+    ResourceManager::deleteInstance();
+    SDL_Quit();
+    XML::cleanupXML();
+    delete logger;
+    logger = nullptr;
+    PHYSFS_deinit();
+}
+
+int Benchmark::runAll(int argc, char *argv[])
+{
+    const std::string filter = argc > 1 ? argv[1] : "";
+
+    if (!initEnvironment(argv[0]))
+        return 1;
+
+    std::cout << "# name iterations ns_per_op_min ns_per_op_median "
+        "allocs_per_op bytes_per_op" << std::endl;
+
+    std::vector<Benchmark*> &benchmarks = getBenchmarks();
+    for (std::vector<Benchmark*>::const_iterator it = benchmarks.begin(),
+         it_end = benchmarks.end(); it != it_end; ++ it)
+    {
+        if ((*it)->getName().find(filter) != std::string::npos)
+            (*it)->measure();
+    }
+
+    closeEnvironment();
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Benchmarks write dir, also used as data dir for generated files.
+ */
+#define BENCHMARK_DIR "manaplusbench"
+
+/**
+ * Benchmark case. Runs run() fixed number of times on fixed synthetic
+ * input, so numbers from different builds can be compared.
+ * Cases registered by constructing static instance.
+ */
+class Benchmark
+{
+    public:
+        Benchmark(const std::string &name, const int iterations);
+
+        virtual ~Benchmark()
+        { }
+
+        /**
+         * Prepares input data. Not measured.
+         */
+        virtual void init()
+        { }
+
+        /**
+         * Executes one operation.
+         */
+        virtual void run() = 0;
+
+        /**
+         * Frees input data. Not measured.
+         */
+        virtual void close()
+        { }
+
+        const std::string &getName() const
+        { return mName; }
+
+        /**
+         * Runs all benchmarks with names containing filter and writes
+         * results to stdout, one line per benchmark:
+         * name iterations ns_per_op_min ns_per_op_median allocs_per_op
+         * bytes_per_op
+         */
+        static int runAll(int argc, char *argv[]);
+
+        static unsigned int mAllocs;
+        static unsigned long long mAllocBytes;
+
+    private:
+        static std::vector<Benchmark*> &getBenchmarks();
+
+        static bool initEnvironment(const char *const selfName);
+
+        static void closeEnvironment();
+
+        void measure();
+
+        std::string mName;
+        int mIterations;
+};
+
+#endif  // TEST_BENCHMARK_H
@@ -0,0 +1,701 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/benchmark.h"
+
+#include "graphics.h"
+#include "graphicsvertexes.h"
+#include "listener.h"
+#include "map.h"
+#include "maplayer.h"
+#include "particle.h"
+#include "playerinfo.h"
+#include "textrenderer.h"
+
+#include "gui/sdlfont.h"
+#include "gui/theme.h"
+
+#include "gui/widgets/browserbox.h"
+
+#include "net/tmwa/messagein.h"
+
+#include "resources/dye.h"
+#include "resources/image.h"
+#include "resources/imagehelper.h"
+#include "resources/itemdb.h"
+#include "resources/mapreader.h"
+
+#include "utils/base64.h"
+#include "utils/stringutils.h"
+
+#include <fstream>
+#include <zlib.h>
+
+#include <SDL.h>
+
+#include "debug.h"
+
+// Synthetic inputs below must not change, or results from different
+// versions can't be compared.
+
+namespace
+{
+    class FindPathBenchmark : public Benchmark
+    {
+        public:
+            FindPathBenchmark() :
+                Benchmark("map.findpath", 200),
+                mMap(nullptr)
+            { }
+
+            void init()
+            {
+                mMap = new Map(200, 200, 32, 32);
+                for (int y = 0; y < 200; y ++)
+                {
+                    for (int x = 0; x < 200; x ++)
+                    {
+                        if (x == 0 || y == 0 || x == 199 || y == 199
+                            || (rand() % 4 == 0 && x > 3 && y > 3
+                            && x < 196 && y < 196))
+                        {
+                            mMap->blockTile(x, y, Map::BLOCKTYPE_WALL);
+                        }
+                    }
+                }
+            }
+
+            void run()
+            {
+                mMap->findPath(2, 2, 197, 197, Map::BLOCKMASK_WALL, 0);
+            }
+
+            void close()
+            {
+                delete mMap;
+                mMap = nullptr;
+            }
+
+        private:
+            Map *mMap;
+    } findPathBenchmark;
+
+    class MapLayerBenchmark : public Benchmark
+    {
+        public:
+            MapLayerBenchmark() :
+                Benchmark("maplayer.updatesdl", 2000),
+                mLayer(nullptr)
+            { }
+
+            void init()
+            {
+                for (int f = 0; f < TILES; f ++)
+                {
+                    SDL_Surface *const surface = SDL_CreateRGBSurface(
+                        SDL_SWSURFACE, 32, 32, 32,
+                        0xff0000, 0xff00, 0xff, 0xff000000);
+                    SDL_FillRect(surface, nullptr, 0x80000000 + f * 0x101010);
+                    mTiles[f] = imageHelper->load(surface);
+                    SDL_FreeSurface(surface);
+                }
+
+                mLayer = new MapLayer(0, 0, 100, 100, false);
+                for (int y = 0; y < 100; y ++)
+                {
+                    for (int x = 0; x < 100; x ++)
+                    {
+                        const int tile = (x * 7 + y * 3) % (TILES + 1);
+                        mLayer->setTile(x, y,
+                            tile < TILES ? mTiles[tile] : nullptr);
+                    }
+                }
+            }
+
+            void run()
+            {
+                mLayer->updateSDL(mainGraphics, 10, 10, 36, 30,
+                    320, 320, Map::MAP_NORMAL);
+            }
+
+            void close()
+            {
+                delete mLayer;
+                mLayer = nullptr;
+                for (int f = 0; f < TILES; f ++)
+                {
+                    delete mTiles[f];
+                    mTiles[f] = nullptr;
+                }
+            }
+
+        private:
+            enum
+            {
+                TILES = 8
+            };
+
+            MapLayer *mLayer;
+            Image *mTiles[TILES];
+    } mapLayerBenchmark;
+
+    class MapReadBenchmark : public Benchmark
+    {
+        public:
+            MapReadBenchmark() :
+                Benchmark("mapreader.layers", 20)
+            { }
+
+            void init()
+            {
+                const int size = MAP_SIZE * MAP_SIZE;
+                unsigned char *data = new unsigned char[size * 4];
+                std::string csv;
+                for (int f = 0; f < size; f ++)
+                {
+                    // runs of same tile, like in real maps
+                    const int gid = 1 + (f / 7) % 40;
+                    data[f * 4] = static_cast<unsigned char>(gid);
+                    data[f * 4 + 1] = 0;
+                    data[f * 4 + 2] = 0;
+                    data[f * 4 + 3] = 0;
+                    if (f)
+                        csv.append(",");
+                    if (f % MAP_SIZE == 0)
+                        csv.append("\n");
+                    csv.append(toString(gid));
+                }
+
+                uLongf zipSize = compressBound(size * 4);
+                unsigned char *zipData = new unsigned char[zipSize];
+                compress(zipData, &zipSize, data, size * 4);
+
+                int len = 0;
+                unsigned char *base64 = php3_base64_encode(zipData,
+                    static_cast<int>(zipSize), &len);
+                const std::string sizeStr = strprintf(
+                    "width=\"%d\" height=\"%d\"", MAP_SIZE, MAP_SIZE);
+
+                mData = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                    "<map version=\"1.0\" orientation=\"orthogonal\" "
+                    + sizeStr + " tilewidth=\"32\" tileheight=\"32\">\n"
+                    "<layer name=\"Ground\" " + sizeStr + ">\n"
+                    "<data encoding=\"base64\" compression=\"zlib\">\n"
+                    + std::string(reinterpret_cast<char*>(base64))
+                    + "\n</data>\n</layer>\n"
+                    "<layer name=\"Over\" " + sizeStr + ">\n"
+                    "<data encoding=\"csv\">" + csv
+                    + "\n</data>\n</layer>\n</map>\n";
+
+                free(base64);
+                delete [] zipData;
+                delete [] data;
+            }
+
+            void run()
+            {
+                XML::Document doc(mData.c_str(),
+                    static_cast<int>(mData.size()));
+                delete MapReader::readMap(doc.rootNode(),
+                    "maps/benchmark.tmx");
+            }
+
+            void close()
+            {
+                mData.clear();
+            }
+
+        private:
+            enum
+            {
+                MAP_SIZE = 400
+            };
+
+            std::string mData;
+    } mapReadBenchmark;
+
+    class ParticleBenchmark : public Benchmark
+    {
+        public:
+            ParticleBenchmark() :
+                Benchmark("particle.update", 2000),
+                mMap(nullptr),
+                mRoot(nullptr)
+            { }
+
+            void init()
+            {
+                mMap = new Map(100, 100, 32, 32);
+                mRoot = new Particle(mMap);
+                for (int f = 0; f < 1000; f ++)
+                {
+                    Particle *const particle = mRoot->createChild();
+                    particle->moveTo(Vector(static_cast<float>(f % 100),
+                        static_cast<float>(f / 10), 100.0f + f % 50));
+                    particle->setVelocity(static_cast<float>(f % 7) - 3,
+                        static_cast<float>(f % 5) - 2, 0);
+                    particle->setGravity(0.1f);
+                    particle->setBounce(0.7f);
+                    particle->setRandomness(f % 3);
+                }
+            }
+
+            void run()
+            {
+                mRoot->update();
+            }
+
+            void close()
+            {
+                delete mRoot;
+                mRoot = nullptr;
+                delete mMap;
+                mMap = nullptr;
+            }
+
+        private:
+            Map *mMap;
+            Particle *mRoot;
+    } particleBenchmark;
+
+    class FontBenchmark : public Benchmark
+    {
+        public:
+            FontBenchmark() :
+                Benchmark("font.drawstring", 20000),
+                mFont(nullptr),
+                mIndex(0)
+            { }
+
+            void init()
+            {
+                mFont = new SDLFont("fonts/dejavusans.ttf", 11);
+                for (int f = 0; f < STRINGS; f ++)
+                    mStrings[f] = strprintf("Player %d: hello world", f);
+                mainGraphics->setColor(gcn::Color(0, 0, 0, 255));
+            }
+
+            void run()
+            {
+                mFont->drawString(mainGraphics, mStrings[mIndex], 10, 10);
+                mIndex = (mIndex + 1) % STRINGS;
+            }
+
+            void close()
+            {
+                delete mFont;
+                mFont = nullptr;
+            }
+
+        private:
+            enum
+            {
+                STRINGS = 100
+            };
+
+            SDLFont *mFont;
+            std::string mStrings[STRINGS];
+            int mIndex;
+    } fontBenchmark;
+
+    class TextRendererBenchmark : public Benchmark
+    {
+        public:
+            TextRendererBenchmark(const std::string &name,
+                                  const bool outline) :
+                Benchmark(name, 500),
+                mFont(nullptr),
+                mOutline(outline)
+            { }
+
+            void init()
+            {
+                mFont = new SDLFont("fonts/dejavusans.ttf", 11);
+                for (int f = 0; f < NAMES; f ++)
+                    mNames[f] = strprintf("Player %d", f);
+            }
+
+            // draws names of all beings on screen
+            void run()
+            {
+                const gcn::Color color(255, 255, 255, 255);
+                for (int f = 0; f < NAMES; f ++)
+                {
+                    TextRenderer::renderText(mainGraphics, mNames[f],
+                        (f % 10) * 60 + 30, (f / 10) * 40 + 10,
+                        gcn::Graphics::CENTER, color, mFont, mOutline, true);
+                }
+            }
+
+            void close()
+            {
+                delete mFont;
+                mFont = nullptr;
+            }
+
+        private:
+            enum
+            {
+                NAMES = 100
+            };
+
+            SDLFont *mFont;
+            std::string mNames[NAMES];
+            bool mOutline;
+    };
+
+    TextRendererBenchmark textNamesBenchmark("text.names", true);
+    TextRendererBenchmark textSpeechBenchmark("text.speech", false);
+
+    class ItemDBBenchmark : public Benchmark
+    {
+        public:
+            ItemDBBenchmark(const std::string &name, const int gets) :
+                Benchmark(name, 20),
+                mGets(gets)
+            { }
+
+            void init()
+            {
+                std::ofstream file(BENCHMARK_DIR "/items.xml",
+                    std::ios::out);
+                file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                    << std::endl << "<items>" << std::endl;
+                for (int f = 1; f <= 2000; f ++)
+                {
+                    file << "<item id=\"" << f << "\" image=\"item"
+                        << f % 50 << ".png\" name=\"Item " << f
+                        << "\" description=\"Synthetic item " << f
+                        << "\" effect=\"+" << f % 10 << " def\" type=\""
+                        << (f % 2 ? "equip-torso" : "usable")
+                        << "\" weight=\"" << f % 30 << "\" defense=\""
+                        << f % 9 << "\">" << std::endl
+                        << "<sprite>equipment/item" << f % 50
+                        << ".xml</sprite>" << std::endl
+                        << "<sound event=\"hit\">sfx/hit.ogg</sound>"
+                        << std::endl << "</item>" << std::endl;
+                }
+                file << "</items>" << std::endl;
+            }
+
+            void run()
+            {
+                ItemDB::load();
+                // session usually touches small part of items
+                for (int f = 1; f <= mGets; f ++)
+                    ItemDB::get(f * 10);
+            }
+
+            void close()
+            {
+                ItemDB::unload();
+            }
+
+        private:
+            int mGets;
+    };
+
+    ItemDBBenchmark itemDBBenchmark("itemdb.load", 0);
+    ItemDBBenchmark itemDBGetBenchmark("itemdb.get", 200);
+
+    class DyeParseBenchmark : public Benchmark
+    {
+        public:
+            DyeParseBenchmark() :
+                Benchmark("dye.parse", 100000)
+            { }
+
+            void run()
+            {
+                Dye dye("R:#203040,506070,a0b0c0;W:#ffffff,808080;"
+                    "G:#00ff00,00aa00,005500");
+            }
+    } dyeParseBenchmark;
+
+    class DyeGetBenchmark : public Benchmark
+    {
+        public:
+            DyeGetBenchmark() :
+                Benchmark("dye.get", 100000)
+            { }
+
+            void run()
+            {
+                Dye::get("R:#203040,506070,a0b0c0;W:#ffffff,808080;"
+                    "G:#00ff00,00aa00,005500");
+            }
+
+            void close()
+            {
+                Dye::unload();
+            }
+    } dyeGetBenchmark;
+
+    class DyeUpdateBenchmark : public Benchmark
+    {
+        public:
+            DyeUpdateBenchmark() :
+                Benchmark("dye.update", 500),
+                mDye(nullptr)
+            { }
+
+            void init()
+            {
+                mDye = new Dye("R:#203040,506070,a0b0c0;W:#ffffff,808080;"
+                    "G:#00ff00,00aa00,005500");
+                for (int f = 0; f < PIXELS; f ++)
+                {
+                    const int c = f % 256;
+                    mPixels[f][0] = (f % 3 == 0) ? c : 0;
+                    mPixels[f][1] = (f % 3 == 1) ? c : 0;
+                    mPixels[f][2] = (f % 3 == 0) ? 0 : c;
+                }
+            }
+
+            void run()
+            {
+                // same loop as image loading with dye
+                for (int f = 0; f < PIXELS; f ++)
+                {
+                    int color[3];
+                    color[0] = mPixels[f][0];
+                    color[1] = mPixels[f][1];
+                    color[2] = mPixels[f][2];
+                    mDye->update(color);
+                }
+            }
+
+            void close()
+            {
+                delete mDye;
+                mDye = nullptr;
+            }
+
+        private:
+            enum
+            {
+                PIXELS = 64 * 64
+            };
+
+            Dye *mDye;
+            int mPixels[PIXELS][3];
+    } dyeUpdateBenchmark;
+
+    class AttributeListener : public Listener
+    {
+        public:
+            AttributeListener() :
+                mSum(0)
+            {
+                listen(CHANNEL_ATTRIBUTES);
+            }
+
+            void processEvent(Channels channel A_UNUSED,
+                              const DepricatedEvent &event)
+            {
+                if (event.getName() == EVENT_UPDATEATTRIBUTE)
+                    mSum += event.attribute().newValue;
+            }
+
+            int mSum;
+    };
+
+    class AttributeEventBenchmark : public Benchmark
+    {
+        public:
+            AttributeEventBenchmark(const std::string &name,
+                                    const bool batching) :
+                Benchmark(name, 20000),
+                mListeners(nullptr),
+                mValue(0),
+                mBatching(batching)
+            { }
+
+            void init()
+            {
+                mListeners = new AttributeListener[3];
+                DepricatedEvent::setBatching(mBatching);
+            }
+
+            // stat flood from one tick of combat
+            void run()
+            {
+                for (int f = 0; f < 20; f ++)
+                    PlayerInfo::setAttribute(f % 5, mValue ++);
+                DepricatedEvent::deliverQueued();
+            }
+
+            void close()
+            {
+                DepricatedEvent::setBatching(false);
+                delete [] mListeners;
+                mListeners = nullptr;
+            }
+
+        private:
+            AttributeListener *mListeners;
+            int mValue;
+            bool mBatching;
+    };
+
+    AttributeEventBenchmark attrEventBenchmark("event.attributes", false);
+    AttributeEventBenchmark attrBatchBenchmark("event.attributes.batch",
+        true);
+
+    class PacketDecodeBenchmark : public Benchmark
+    {
+        public:
+            PacketDecodeBenchmark() :
+                Benchmark("packet.decode", 20000),
+                mSize(0)
+            { }
+
+            void init()
+            {
+                // being move and chat packets, tmwAthena layout
+                mSize = 0;
+                for (int f = 0; f < PACKETS; f ++)
+                {
+                    unsigned char *const buf = mData + mSize;
+                    if (f % 4 == 3)
+                    {
+                        const std::string text = strprintf(
+                            "Player %d : some chat text", f);
+                        const int len = 8 + static_cast<int>(text.size());
+                        buf[0] = 0x8d;
+                        buf[1] = 0x00;
+                        buf[2] = static_cast<unsigned char>(len);
+                        buf[3] = 0;
+                        for (int i = 4; i < 8; i ++)
+                            buf[i] = static_cast<unsigned char>(f + i);
+                        memcpy(buf + 8, text.c_str(), text.size());
+                        mSize += len;
+                    }
+                    else
+                    {
+                        buf[0] = 0x7b;
+                        buf[1] = 0x00;
+                        for (int i = 2; i < 60; i ++)
+                            buf[i] = static_cast<unsigned char>(f * 7 + i);
+                        mSize += 60;
+                    }
+                }
+            }
+
+            void run()
+            {
+                const char *const data = reinterpret_cast<char*>(mData);
+                int pos = 0;
+                while (pos < mSize)
+                {
+                    if (mData[pos] == 0x8d)
+                    {
+                        const int len = mData[pos + 2];
+                        TmwAthena::MessageIn msg(data + pos, len);
+                        msg.readInt16();
+                        msg.readInt32();
+                        msg.readString(len - 8);
+                        pos += len;
+                    }
+                    else
+                    {
+                        TmwAthena::MessageIn msg(data + pos, 60);
+                        uint16_t srcX, srcY, dstX, dstY;
+                        msg.readInt32();
+                        for (int f = 0; f < 7; f ++)
+                            msg.readInt16();
+                        msg.readInt16();
+                        msg.readInt32();
+                        for (int f = 0; f < 6; f ++)
+                            msg.readInt16();
+                        msg.readInt32();
+                        for (int f = 0; f < 3; f ++)
+                            msg.readInt16();
+                        msg.readInt8();
+                        msg.readInt8();
+                        msg.readCoordinatePair(srcX, srcY, dstX, dstY);
+                        msg.skip(5);
+                        pos += 60;
+                    }
+                }
+            }
+
+        private:
+            enum
+            {
+                PACKETS = 64
+            };
+
+            unsigned char mData[PACKETS * 60];
+            int mSize;
+    } packetDecodeBenchmark;
+
+    class BrowserBoxBenchmark : public Benchmark
+    {
+        public:
+            BrowserBoxBenchmark() :
+                Benchmark("browserbox.addrow", 200),
+                mFont(nullptr),
+                mBox(nullptr)
+            { }
+
+            void init()
+            {
+                Theme::instance();
+                mFont = new SDLFont("fonts/dejavusans.ttf", 11);
+                gcn::Widget::setGlobalFont(mFont);
+                mBox = new BrowserBox(BrowserBox::AUTO_WRAP);
+                mBox->setWidth(300);
+                for (int f = 0; f < ROWS; f ++)
+                {
+                    mRows[f] = strprintf("##%d[@@player%d|Player %d@@] "
+                        "has some long text to wrap, and link to "
+                        "@@http://example.com/%d|page %d@@ ##Bcolored##b",
+                        f % 9, f, f, f, f);
+                }
+            }
+
+            void run()
+            {
+                mBox->clearRows();
+                for (int f = 0; f < ROWS; f ++)
+                    mBox->addRow(mRows[f]);
+            }
+
+            void close()
+            {
+                delete mBox;
+                mBox = nullptr;
+                gcn::Widget::setGlobalFont(nullptr);
+                delete mFont;
+                mFont = nullptr;
+            }
+
+        private:
+            enum
+            {
+                ROWS = 50
+            };
+
+            SDLFont *mFont;
+            BrowserBox *mBox;
+            std::string mRows[ROWS];
+    } browserBoxBenchmark;
+}
@@ -0,0 +1,170 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/loadstats.h"
+
+#include "client.h"
+#include "configuration.h"
+#include "logger.h"
+
+#include <sys/time.h>
+
+#include "debug.h"
+
+bool LoadStats::mEnabled = false;
+std::ofstream LoadStats::mFile;
+long long LoadStats::mSecondStart = 0;
+long long LoadStats::mLastFrame = 0;
+long long LoadStats::mInputTime = 0;
+int LoadStats::mFrames = 0;
+int LoadStats::mFrameTimeSum = 0;
+int LoadStats::mFrameTimeMax = 0;
+int LoadStats::mPackets = 0;
+int LoadStats::mDispatchTime = 0;
+int LoadStats::mDispatches = 0;
+int LoadStats::mLatencySum = 0;
+int LoadStats::mLatencyMax = 0;
+int LoadStats::mSends = 0;
+int LoadStats::mSendLatencySum = 0;
+int LoadStats::mSendLatencyMax = 0;
+
+void LoadStats::init()
+{
+    mEnabled = config.getBoolValue("loadStats");
+    if (!mEnabled)
+        return;
+
+    const std::string fileName = Client::getLocalDataDirectory()
+        + "/loadstats.log";
+    mFile.open(fileName.c_str(), std::ios::out);
+    if (!mFile.is_open())
+    {
+        logger->log("Cant open load stats file: %s", fileName.c_str());
+        mEnabled = false;
+        return;
+    }
+    mFile << "# time fps frame_avg_ms frame_max_ms packets "
+        "dispatch_ms latency_avg_ms latency_max_ms send_avg_ms "
+        "send_max_ms" << std::endl;
+
+    mLastFrame = getTime();
+    mSecondStart = mLastFrame;
+    reset();
+}
+
+void LoadStats::close()
+{
+    if (mFile.is_open())
+        mFile.close();
+    mEnabled = false;
+}
+
+void LoadStats::frame()
+{
+    if (!mEnabled)
+        return;
+
+    const long long now = getTime();
+    const int frameTime = static_cast<int>(now - mLastFrame);
+    mLastFrame = now;
+
+    mFrames ++;
+    mFrameTimeSum += frameTime;
+    if (frameTime > mFrameTimeMax)
+        mFrameTimeMax = frameTime;
+
+    if (now - mSecondStart >= 1000000)
+        flush(now);
+}
+
+void LoadStats::dispatched(int packets, int latency, int time)
+{
+    if (!mEnabled || !packets)
+        return;
+
+    mPackets += packets;
+    mDispatchTime += time;
+    mDispatches ++;
+    mLatencySum += latency;
+    if (latency > mLatencyMax)
+        mLatencyMax = latency;
+}
+
+void LoadStats::input()
+{
+    if (mEnabled)
+        mInputTime = getTime();
+}
+
+void LoadStats::sent()
+{
+    if (!mEnabled || !mInputTime)
+        return;
+
+    const int latency = static_cast<int>(getTime() - mInputTime);
+    mInputTime = 0;
+    mSends ++;
+    mSendLatencySum += latency;
+    if (latency > mSendLatencyMax)
+        mSendLatencyMax = latency;
+}
+
+void LoadStats::flush(long long now)
+{
+    const int frames = mFrames ? mFrames : 1;
+    const int dispatches = mDispatches ? mDispatches : 1;
+    const int sends = mSends ? mSends : 1;
+
+    mFile << (now / 1000) << " "
+        << mFrames << " "
+        << (mFrameTimeSum / frames / 1000.0) << " "
+        << (mFrameTimeMax / 1000.0) << " "
+        << mPackets << " "
+        << (mDispatchTime / 1000.0) << " "
+        << (mLatencySum / dispatches / 1000.0) << " "
+        << (mLatencyMax / 1000.0) << " "
+        << (mSendLatencySum / sends / 1000.0) << " "
+        << (mSendLatencyMax / 1000.0) << std::endl;
+
+    mSecondStart = now;
+    reset();
+}
+
+void LoadStats::reset()
+{
+    mFrames = 0;
+    mFrameTimeSum = 0;
+    mFrameTimeMax = 0;
+    mPackets = 0;
+    mDispatchTime = 0;
+    mDispatches = 0;
+    mLatencySum = 0;
+    mLatencyMax = 0;
+    mSends = 0;
+    mSendLatencySum = 0;
+    mSendLatencyMax = 0;
+}
+
+long long LoadStats::getTime()
+{
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+    return static_cast<long long>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
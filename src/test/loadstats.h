@@ -0,0 +1,96 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_LOADSTATS_H
+#define TEST_LOADSTATS_H
+
+#include <fstream>
+
+/**
+ * Client side frame time and packet processing latency statistics.
+ * Enabled by the "loadStats" config option, mostly used together with
+ * the manaplusmockserver load test server.
+ * Once per second one line is appended to loadstats.log.
+ */
+class LoadStats
+{
+    public:
+        static void init();
+
+        static void close();
+
+        /**
+         * Called once per main loop iteration.
+         */
+        static void frame();
+
+        /**
+         * Called after network dispatch.
+         *
+         * @param packets number of dispatched packets
+         * @param latency time between first unhandled packet arrival and
+         *                dispatch start in microseconds
+         * @param time time spent in packet handlers in microseconds
+         */
+        static void dispatched(int packets, int latency, int time);
+
+        /**
+         * Called when key or mouse button press is handled.
+         */
+        static void input();
+
+        /**
+         * Called when outgoing data is sent. Counts time since last not
+         * counted input.
+         */
+        static void sent();
+
+        static bool isEnabled()
+        { return mEnabled; }
+
+        /**
+         * Returns current time in microseconds.
+         */
+        static long long getTime();
+
+    private:
+        static void flush(long long now);
+
+        static void reset();
+
+        static bool mEnabled;
+        static std::ofstream mFile;
+        static long long mSecondStart;
+        static long long mLastFrame;
+        static long long mInputTime;
+        static int mFrames;
+        static int mFrameTimeSum;
+        static int mFrameTimeMax;
+        static int mPackets;
+        static int mDispatchTime;
+        static int mDispatches;
+        static int mLatencySum;
+        static int mLatencyMax;
+        static int mSends;
+        static int mSendLatencySum;
+        static int mSendLatencyMax;
+};
+
+#endif // TEST_LOADSTATS_H
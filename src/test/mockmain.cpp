@@ -0,0 +1,107 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mockscenario.h"
+#include "test/mockserver.h"
+
+#include <SDL.h>
+#include <SDL_net.h>
+
+#include <csignal>
+#include <iostream>
+
+#include "debug.h"
+
+static MockServer *server = nullptr;
+
+static void stopServer(int sig A_UNUSED)
+{
+    if (server)
+        server->stop();
+}
+
+static void printHelp()
+{
+    std::cout << "manaplusmockserver - local tmwAthena server for load tests"
+        << std::endl << std::endl
+        << "Usage: manaplusmockserver [scenario file] [key=value]..."
+        << std::endl << std::endl
+        << "Keys: port address account character map startx starty radius"
+        << std::endl
+        << "      beings players monsterjob speed moverate chatrate droprate"
+        << std::endl
+        << "      dropitem droplifetime stats seed" << std::endl
+        << "See docs/mockserver.txt for details." << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    MockScenario scenario;
+
+    for (int f = 1; f < argc; f ++)
+    {
+        const std::string arg = argv[f];
+        if (arg == "-h" || arg == "--help")
+        {
+            printHelp();
+            return 0;
+        }
+
+        const size_t pos = arg.find('=');
+        if (pos == std::string::npos)
+        {
+            if (!scenario.load(arg))
+                return 1;
+        }
+        else if (!scenario.setValue(arg.substr(0, pos), arg.substr(pos + 1)))
+        {
+            std::cerr << "Unknown key: " << arg.substr(0, pos) << std::endl;
+            return 1;
+        }
+    }
+
+    if (SDL_Init(SDL_INIT_TIMER) == -1)
+    {
+        std::cerr << "SDL_Init: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    if (SDLNet_Init() == -1)
+    {
+        std::cerr << "SDLNet_Init: " << SDLNet_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    int ret = 0;
+    server = new MockServer(scenario);
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    if (server->start())
+        server->run();
+    else
+        ret = 1;
+
+    delete server;
+    server = nullptr;
+
+    SDLNet_Quit();
+    SDL_Quit();
+    return ret;
+}
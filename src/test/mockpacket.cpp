@@ -0,0 +1,124 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mockpacket.h"
+
+#include "net/tmwa/packetlengths.h"
+#include "net/tmwa/protocol.h"
+
+#include "debug.h"
+
+using TmwAthena::packet_lengths;
+using TmwAthena::packet_lengths_size;
+
+MockPacket::MockPacket(uint16_t id) :
+    mData(),
+    mLength(0)
+{
+    if (id == SMSG_SERVER_VERSION_RESPONSE)
+        mLength = 10;
+    else if (id == SMSG_UPDATE_HOST2)
+        mLength = -1;
+    else if (id < packet_lengths_size)
+        mLength = packet_lengths[id];
+
+    writeInt16(id);
+    if (mLength == -1)
+        writeInt16(0);
+}
+
+void MockPacket::writeInt8(int value)
+{
+    mData += static_cast<char>(value & 0xff);
+}
+
+void MockPacket::writeInt16(int value)
+{
+    mData += static_cast<char>(value & 0xff);
+    mData += static_cast<char>((value >> 8) & 0xff);
+}
+
+void MockPacket::writeInt32(int value)
+{
+    writeInt16(value & 0xffff);
+    writeInt16((value >> 16) & 0xffff);
+}
+
+void MockPacket::writeString(const std::string &str, int length)
+{
+    if (length < 0)
+    {
+        mData += str;
+        return;
+    }
+
+    std::string data = str.substr(0, static_cast<unsigned>(length));
+    data.resize(static_cast<unsigned>(length), '\0');
+    mData += data;
+}
+
+void MockPacket::writeCoordinates(int x, int y, int dir)
+{
+    writeInt8(x >> 2);
+    writeInt8((x << 6) | ((y >> 4) & 0x3f));
+    writeInt8((y << 4) | (dir & 0x0f));
+}
+
+void MockPacket::writeCoordinatePair(int srcX, int srcY, int dstX, int dstY)
+{
+    writeInt8(srcX >> 2);
+    writeInt8((srcX << 6) | ((srcY >> 4) & 0x3f));
+    writeInt8((srcY << 4) | ((dstX >> 6) & 0x0f));
+    writeInt8((dstX << 2) | ((dstY >> 8) & 0x03));
+    writeInt8(dstY);
+}
+
+const std::string &MockPacket::getData()
+{
+    if (mLength == -1)
+    {
+        const int size = static_cast<int>(mData.size());
+        mData[2] = static_cast<char>(size & 0xff);
+        mData[3] = static_cast<char>((size >> 8) & 0xff);
+    }
+    else if (mLength > 0
+             && mData.size() < static_cast<unsigned>(mLength))
+    {
+        mData.append(mLength - mData.size(), '\0');
+    }
+    return mData;
+}
+
+int MockPacket::getClientLength(uint16_t id)
+{
+    switch (id)
+    {
+        case CMSG_SERVER_VERSION_REQUEST:
+        case CMSG_CLIENT_DISCONNECT:
+            return 2;
+        case CMSG_SEND_CLIENT_INFO:
+            return 4;
+        default:
+            break;
+    }
+    if (id < packet_lengths_size)
+        return packet_lengths[id];
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_MOCKPACKET_H
+#define TEST_MOCKPACKET_H
+
+#include <SDL_types.h>
+
+#include <string>
+
+/**
+ * Builds one server to client packet for the mock tmwAthena server.
+ * Fixed size packets are padded to the length from packet_lengths,
+ * variable size packets get their length word filled by getData().
+ */
+class MockPacket
+{
+    public:
+        MockPacket(uint16_t id);
+
+        void writeInt8(int value);
+
+        void writeInt16(int value);
+
+        void writeInt32(int value);
+
+        void writeString(const std::string &str, int length = -1);
+
+        void writeCoordinates(int x, int y, int dir);
+
+        void writeCoordinatePair(int srcX, int srcY, int dstX, int dstY);
+
+        /**
+         * Returns packet bytes ready to send.
+         */
+        const std::string &getData();
+
+        /**
+         * Returns length of client packet with given id,
+         * -1 for variable length packets, 0 for unknown packets.
+         */
+        static int getClientLength(uint16_t id);
+
+    private:
+        std::string mData;
+        int mLength;
+};
+
+#endif // TEST_MOCKPACKET_H
@@ -0,0 +1,146 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mockscenario.h"
+
+#include "utils/stringutils.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "debug.h"
+
+MockScenario::MockScenario() :
+    port(6901),
+    address("127.0.0.1"),
+    account("mock"),
+    character("MockPlayer"),
+    map("001-1"),
+    startX(50),
+    startY(50),
+    radius(15),
+    beings(100),
+    playersPercent(20),
+    monsterJob(1002),
+    speed(150),
+    moveRate(0.5),
+    chatRate(5),
+    dropRate(1),
+    dropItemId(505),
+    dropLifeTime(10),
+    statsInterval(5),
+    seed(1)
+{
+}
+
+bool MockScenario::load(const std::string &fileName)
+{
+    std::ifstream file(fileName.c_str());
+    if (!file.is_open())
+    {
+        std::cerr << "Cant open scenario file: " << fileName << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    int lineNum = 0;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        lineNum ++;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line = line.substr(0, comment);
+        trim(line);
+        if (line.empty())
+            continue;
+
+        std::string key;
+        std::string value;
+        const size_t pos = line.find_first_of(" \t");
+        if (pos != std::string::npos)
+        {
+            key = line.substr(0, pos);
+            value = line.substr(pos + 1);
+            trim(value);
+        }
+        else
+        {
+            key = line;
+        }
+
+        if (!setValue(key, value))
+        {
+            std::cerr << fileName << ":" << lineNum
+                << ": unknown key: " << key << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool MockScenario::setValue(const std::string &key, const std::string &value)
+{
+    const int intValue = atoi(value.c_str());
+    const double doubleValue = atof(value.c_str());
+
+    if (key == "port")
+        port = intValue;
+    else if (key == "address")
+        address = value;
+    else if (key == "account")
+        account = value;
+    else if (key == "character")
+        character = value;
+    else if (key == "map")
+        map = value;
+    else if (key == "startx")
+        startX = intValue;
+    else if (key == "starty")
+        startY = intValue;
+    else if (key == "radius")
+        radius = intValue > 0 ? intValue : 1;
+    else if (key == "beings")
+        beings = intValue;
+    else if (key == "players")
+        playersPercent = intValue;
+    else if (key == "monsterjob")
+        monsterJob = intValue;
+    else if (key == "speed")
+        speed = intValue;
+    else if (key == "moverate")
+        moveRate = doubleValue;
+    else if (key == "chatrate")
+        chatRate = doubleValue;
+    else if (key == "droprate")
+        dropRate = doubleValue;
+    else if (key == "dropitem")
+        dropItemId = intValue;
+    else if (key == "droplifetime")
+        dropLifeTime = intValue;
+    else if (key == "stats")
+        statsInterval = intValue;
+    else if (key == "seed")
+        seed = static_cast<unsigned int>(intValue);
+    else
+        return false;
+    return true;
+}
@@ -0,0 +1,93 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_MOCKSCENARIO_H
+#define TEST_MOCKSCENARIO_H
+
+#include <string>
+
+/**
+ * Load test settings for the mock tmwAthena server.
+ * Read from simple "key value" text file, see docs/mockserver.txt.
+ */
+class MockScenario
+{
+    public:
+        MockScenario();
+
+        /**
+         * Loads settings from file. Returns false if file cant be read
+         * or contains unknown keys.
+         */
+        bool load(const std::string &fileName);
+
+        /**
+         * Sets one setting. Returns false for unknown key.
+         */
+        bool setValue(const std::string &key, const std::string &value);
+
+        /** Listen port for login, char and map connections. */
+        int port;
+
+        /** Address sent to client for char and map server. */
+        std::string address;
+
+        std::string account;
+        std::string character;
+
+        /** Map name sent to client, without .gat extension. */
+        std::string map;
+        int startX;
+        int startY;
+
+        /** Beings are spawned and walk inside this radius from start. */
+        int radius;
+
+        int beings;
+
+        /** Percent of spawned beings which are players, rest monsters. */
+        int playersPercent;
+
+        int monsterJob;
+
+        /** Walk speed in ms per tile. */
+        int speed;
+
+        /** Moves per being per second. */
+        double moveRate;
+
+        /** Chat lines per second. */
+        double chatRate;
+
+        /** Item drops per second. */
+        double dropRate;
+
+        int dropItemId;
+
+        /** Dropped items removed after this amount of seconds. */
+        int dropLifeTime;
+
+        /** Seconds between stats lines, 0 to disable. */
+        int statsInterval;
+
+        unsigned int seed;
+};
+
+#endif // TEST_MOCKSCENARIO_H
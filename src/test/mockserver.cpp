@@ -0,0 +1,663 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mockserver.h"
+
+#include "test/mockpacket.h"
+
+#include "net/tmwa/protocol.h"
+
+#include "utils/stringutils.h"
+
+#include <SDL.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "debug.h"
+
+static const int MAX_CONNECTIONS = 16;
+static const int CHECK_TIMEOUT = 5;
+
+static const char *const chatLines[] =
+{
+    "hello",
+    "anyone selling iron potions?",
+    "lets go hunt some maggots",
+    "brb",
+    "how do i get to the desert?",
+    "lol",
+    "trade?",
+    "thanks for the help!"
+};
+
+MockServer::MockServer(const MockScenario &scenario) :
+    mScenario(scenario),
+    mListenSocket(nullptr),
+    mSocketSet(nullptr),
+    mConnections(),
+    mBeings(),
+    mItems(),
+    mRunning(false),
+    mAccountId(2000000),
+    mCharId(150000),
+    mNextItemId(1),
+    mStartTime(0),
+    mLastLogic(0),
+    mLastStats(0),
+    mMoveCounter(0),
+    mChatCounter(0),
+    mDropCounter(0),
+    mOutPackets(0),
+    mOutBytes(0),
+    mInPackets(0)
+{
+}
+
+MockServer::~MockServer()
+{
+    for (ConnectionsIter it = mConnections.begin(),
+         it_end = mConnections.end(); it != it_end; ++ it)
+    {
+        SDLNet_TCP_Close((*it)->socket);
+        delete *it;
+    }
+    mConnections.clear();
+
+    if (mListenSocket)
+        SDLNet_TCP_Close(mListenSocket);
+    if (mSocketSet)
+        SDLNet_FreeSocketSet(mSocketSet);
+}
+
+bool MockServer::start()
+{
+    IPaddress ip;
+    if (SDLNet_ResolveHost(&ip, nullptr,
+        static_cast<uint16_t>(mScenario.port)) == -1)
+    {
+        std::cerr << "SDLNet_ResolveHost: " << SDLNet_GetError() << std::endl;
+        return false;
+    }
+
+    mListenSocket = SDLNet_TCP_Open(&ip);
+    if (!mListenSocket)
+    {
+        std::cerr << "SDLNet_TCP_Open: " << SDLNet_GetError() << std::endl;
+        return false;
+    }
+
+    mSocketSet = SDLNet_AllocSocketSet(MAX_CONNECTIONS + 1);
+    if (!mSocketSet)
+    {
+        std::cerr << "SDLNet_AllocSocketSet: "
+            << SDLNet_GetError() << std::endl;
+        return false;
+    }
+    SDLNet_TCP_AddSocket(mSocketSet, mListenSocket);
+
+    srand(mScenario.seed);
+    spawnBeings();
+
+    mStartTime = SDL_GetTicks();
+    mLastLogic = mStartTime;
+    mLastStats = mStartTime;
+    mRunning = true;
+
+    std::cout << "Mock server listening on port " << mScenario.port
+        << ", map " << mScenario.map << ", " << mBeings.size()
+        << " beings" << std::endl;
+    return true;
+}
+
+void MockServer::run()
+{
+    while (mRunning)
+    {
+        if (SDLNet_CheckSockets(mSocketSet, CHECK_TIMEOUT) > 0)
+        {
+            if (SDLNet_SocketReady(mListenSocket))
+                accept();
+
+            for (ConnectionsIter it = mConnections.begin(),
+                 it_end = mConnections.end(); it != it_end; ++ it)
+            {
+                if (SDLNet_SocketReady((*it)->socket))
+                    receive(*it);
+            }
+        }
+
+        logic();
+
+        ConnectionsIter it = mConnections.begin();
+        while (it != mConnections.end())
+        {
+            if ((*it)->closed)
+            {
+                Connection *const conn = *it;
+                SDLNet_TCP_DelSocket(mSocketSet, conn->socket);
+                SDLNet_TCP_Close(conn->socket);
+                delete conn;
+                it = mConnections.erase(it);
+            }
+            else
+            {
+                ++ it;
+            }
+        }
+    }
+}
+
+void MockServer::accept()
+{
+    TCPsocket sock = SDLNet_TCP_Accept(mListenSocket);
+    if (!sock)
+        return;
+
+    if (mConnections.size() >= static_cast<unsigned>(MAX_CONNECTIONS))
+    {
+        std::cerr << "Too many connections" << std::endl;
+        SDLNet_TCP_Close(sock);
+        return;
+    }
+
+    SDLNet_TCP_AddSocket(mSocketSet, sock);
+    mConnections.push_back(new Connection(sock));
+}
+
+void MockServer::receive(Connection *const conn)
+{
+    char buf[4096];
+    const int ret = SDLNet_TCP_Recv(conn->socket, buf, sizeof(buf));
+    if (ret <= 0)
+    {
+        close(conn);
+        return;
+    }
+    conn->inBuffer.append(buf, ret);
+    parse(conn);
+}
+
+void MockServer::parse(Connection *const conn)
+{
+    std::string &buf = conn->inBuffer;
+    while (!conn->closed && buf.size() >= 2)
+    {
+        const uint16_t id = static_cast<uint16_t>(
+            static_cast<unsigned char>(buf[0])
+            | (static_cast<unsigned char>(buf[1]) << 8));
+        int len = MockPacket::getClientLength(id);
+        if (len == -1)
+        {
+            if (buf.size() < 4)
+                return;
+            len = static_cast<unsigned char>(buf[2])
+                | (static_cast<unsigned char>(buf[3]) << 8);
+        }
+        if (len < 2)
+        {
+            std::cerr << strprintf("Unknown packet 0x%04x, closing "
+                "connection", id) << std::endl;
+            close(conn);
+            return;
+        }
+        if (buf.size() < static_cast<unsigned>(len))
+            return;
+
+        mInPackets ++;
+        handlePacket(conn, id, buf.data(), len);
+        buf.erase(0, len);
+    }
+}
+
+static int readInt16(const char *data, int pos)
+{
+    return static_cast<unsigned char>(data[pos])
+        | (static_cast<unsigned char>(data[pos + 1]) << 8);
+}
+
+void MockServer::handlePacket(Connection *const conn, uint16_t id,
+                              const char *data, int len)
+{
+    switch (id)
+    {
+        case CMSG_SERVER_VERSION_REQUEST:
+        {
+            // plain tmwAthena version answer (not evol)
+            MockPacket msg(SMSG_SERVER_VERSION_RESPONSE);
+            msg.writeInt8(1);
+            msg.writeInt8(0);
+            msg.writeInt8(0);
+            msg.writeInt8(0);
+            msg.writeInt32(0);
+            send(conn, msg);
+            break;
+        }
+
+        case 0x0064:  // login
+        {
+            MockPacket msg(SMSG_LOGIN_DATA);
+            msg.writeInt32(1);              // session id 1
+            msg.writeInt32(mAccountId);
+            msg.writeInt32(2);              // session id 2
+            msg.writeInt32(0);              // old ip
+            msg.writeString("", 24);        // last login
+            msg.writeInt16(0);
+            msg.writeInt8(1);               // sex
+            writeAddress(msg);
+            msg.writeInt16(mScenario.port);
+            msg.writeString("Mock", 20);
+            msg.writeInt16(static_cast<int>(mConnections.size()));
+            msg.writeInt16(0);              // maintenance
+            msg.writeInt16(0);              // new
+            send(conn, msg);
+            break;
+        }
+
+        case CMSG_CHAR_SERVER_CONNECT:
+        {
+            sendAccountId(conn);
+
+            MockPacket msg(SMSG_CHAR_LOGIN);
+            msg.writeInt16(9);              // slots
+            msg.writeInt8(0);               // version
+            msg.writeString("", 17);
+
+            // character, old format (106 bytes)
+            msg.writeInt32(mCharId);
+            msg.writeInt32(0);              // exp
+            msg.writeInt32(1000);           // money
+            msg.writeInt32(0);              // job exp
+            msg.writeInt32(1);              // job level
+            for (int f = 0; f < 4; f ++)
+                msg.writeInt16(0);          // shoes, gloves, cape, misc1
+            msg.writeInt32(0);              // option
+            msg.writeInt32(0);              // karma
+            msg.writeInt32(0);              // manner
+            msg.writeInt16(0);              // status points
+            msg.writeInt16(100);            // hp
+            msg.writeInt16(100);            // max hp
+            msg.writeInt16(10);             // mp
+            msg.writeInt16(10);             // max mp
+            msg.writeInt16(mScenario.speed);
+            msg.writeInt16(0);              // class
+            msg.writeInt16(1);              // hair style
+            msg.writeInt16(0);              // weapon
+            msg.writeInt16(10);             // level
+            msg.writeInt16(0);              // skill points
+            msg.writeInt16(0);              // bottom clothes
+            msg.writeInt16(0);              // shield
+            msg.writeInt16(0);              // hat
+            msg.writeInt16(0);              // top clothes
+            msg.writeInt16(1);              // hair color
+            msg.writeInt16(0);              // misc2
+            msg.writeString(mScenario.character, 24);
+            for (int f = 0; f < 6; f ++)
+                msg.writeInt8(5);           // stats
+            msg.writeInt8(0);               // slot
+            msg.writeInt8(0);
+            send(conn, msg);
+            break;
+        }
+
+        case CMSG_CHAR_SELECT:
+        {
+            MockPacket msg(SMSG_CHAR_MAP_INFO);
+            msg.writeInt32(mCharId);
+            msg.writeString(mScenario.map + ".gat", 16);
+            writeAddress(msg);
+            msg.writeInt16(mScenario.port);
+            send(conn, msg);
+            break;
+        }
+
+        case CMSG_MAP_SERVER_CONNECT:
+        {
+            sendAccountId(conn);
+
+            conn->x = mScenario.startX;
+            conn->y = mScenario.startY;
+            MockPacket msg(SMSG_MAP_LOGIN_SUCCESS);
+            msg.writeInt32(getTick());
+            msg.writeCoordinates(conn->x, conn->y, 0);
+            msg.writeInt16(0x0505);
+            send(conn, msg);
+            break;
+        }
+
+        case CMSG_MAP_LOADED:
+        {
+            conn->inGame = true;
+            for (std::vector<Being>::const_iterator it = mBeings.begin(),
+                 it_end = mBeings.end(); it != it_end; ++ it)
+            {
+                sendBeing(conn, *it, false, 0, 0);
+            }
+            std::cout << "Client entered map" << std::endl;
+            break;
+        }
+
+        case CMSG_CLIENT_PING:
+        {
+            MockPacket msg(SMSG_SERVER_PING);
+            msg.writeInt32(getTick());
+            send(conn, msg);
+            break;
+        }
+
+        case CMSG_PLAYER_CHANGE_DEST:
+        {
+            const unsigned char *p
+                = reinterpret_cast<const unsigned char*>(data + 2);
+            const int dstX = (p[0] << 2) | (p[1] >> 6);
+            const int dstY = ((p[1] & 0x3f) << 4) | (p[2] >> 4);
+            MockPacket msg(SMSG_WALK_RESPONSE);
+            msg.writeInt32(getTick());
+            msg.writeCoordinatePair(conn->x, conn->y, dstX, dstY);
+            msg.writeInt8(0);
+            send(conn, msg);
+            conn->x = dstX;
+            conn->y = dstY;
+            break;
+        }
+
+        case 0x0094:  // being name request
+        {
+            const int beingId = readInt16(data, 2) | (readInt16(data, 4) << 16);
+            for (std::vector<Being>::const_iterator it = mBeings.begin(),
+                 it_end = mBeings.end(); it != it_end; ++ it)
+            {
+                if (it->id == beingId)
+                {
+                    MockPacket msg(SMSG_BEING_NAME_RESPONSE);
+                    msg.writeInt32(beingId);
+                    msg.writeString(it->name, 24);
+                    send(conn, msg);
+                    break;
+                }
+            }
+            break;
+        }
+
+        case CMSG_CHAT_MESSAGE:
+        {
+            MockPacket msg(SMSG_PLAYER_CHAT);
+            msg.writeString(std::string(data + 4, len - 4));
+            send(conn, msg);
+            break;
+        }
+
+        case CMSG_CLIENT_QUIT:
+        {
+            MockPacket msg(SMSG_MAP_QUIT_RESPONSE);
+            msg.writeInt16(0);
+            send(conn, msg);
+            break;
+        }
+
+        case CMSG_CLIENT_DISCONNECT:
+            close(conn);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void MockServer::sendAccountId(Connection *const conn)
+{
+    // eAthena sends account id before first answer on char and map server
+    char raw[4];
+    raw[0] = static_cast<char>(mAccountId & 0xff);
+    raw[1] = static_cast<char>((mAccountId >> 8) & 0xff);
+    raw[2] = static_cast<char>((mAccountId >> 16) & 0xff);
+    raw[3] = static_cast<char>((mAccountId >> 24) & 0xff);
+    if (SDLNet_TCP_Send(conn->socket, raw, 4) < 4)
+        close(conn);
+}
+
+void MockServer::writeAddress(MockPacket &packet) const
+{
+    int a = 0;
+    int b = 0;
+    int c = 0;
+    int d = 0;
+    sscanf(mScenario.address.c_str(), "%d.%d.%d.%d", &a, &b, &c, &d);
+    packet.writeInt8(a);
+    packet.writeInt8(b);
+    packet.writeInt8(c);
+    packet.writeInt8(d);
+}
+
+void MockServer::send(Connection *const conn, MockPacket &packet)
+{
+    if (conn->closed)
+        return;
+
+    const std::string &data = packet.getData();
+    const int size = static_cast<int>(data.size());
+    if (SDLNet_TCP_Send(conn->socket, data.data(), size) < size)
+    {
+        close(conn);
+        return;
+    }
+    mOutPackets ++;
+    mOutBytes += size;
+}
+
+void MockServer::sendToGame(MockPacket &packet)
+{
+    for (ConnectionsIter it = mConnections.begin(),
+         it_end = mConnections.end(); it != it_end; ++ it)
+    {
+        if ((*it)->inGame)
+            send(*it, packet);
+    }
+}
+
+void MockServer::close(Connection *const conn)
+{
+    conn->closed = true;
+    conn->inGame = false;
+}
+
+void MockServer::logic()
+{
+    const unsigned int now = SDL_GetTicks();
+    const double dt = (now - mLastLogic) / 1000.0;
+    mLastLogic = now;
+
+    bool inGame = false;
+    for (ConnectionsIter it = mConnections.begin(),
+         it_end = mConnections.end(); it != it_end; ++ it)
+    {
+        if ((*it)->inGame)
+        {
+            inGame = true;
+            break;
+        }
+    }
+
+    if (inGame)
+    {
+        mMoveCounter += mScenario.moveRate * mBeings.size() * dt;
+        mChatCounter += mScenario.chatRate * dt;
+        mDropCounter += mScenario.dropRate * dt;
+        for (; mMoveCounter >= 1; mMoveCounter -= 1)
+            moveBeing();
+        for (; mChatCounter >= 1; mChatCounter -= 1)
+            chat();
+        for (; mDropCounter >= 1; mDropCounter -= 1)
+            dropItem();
+    }
+
+    while (!mItems.empty() && mItems.front().removeTime <= now)
+    {
+        MockPacket msg(SMSG_ITEM_REMOVE);
+        msg.writeInt32(mItems.front().id);
+        sendToGame(msg);
+        mItems.pop_front();
+    }
+
+    if (mScenario.statsInterval > 0 && now - mLastStats
+        >= static_cast<unsigned>(mScenario.statsInterval) * 1000)
+    {
+        printStats();
+        mLastStats = now;
+    }
+}
+
+void MockServer::spawnBeings()
+{
+    mBeings.clear();
+    mBeings.reserve(mScenario.beings);
+    for (int f = 0; f < mScenario.beings; f ++)
+    {
+        Being being;
+        const bool player = rand() % 100 < mScenario.playersPercent;
+        being.id = player ? 2100000 + f : 110000000 + f;
+        being.job = player ? 0 : mScenario.monsterJob;
+        being.x = randomCoord(mScenario.startX);
+        being.y = randomCoord(mScenario.startY);
+        being.name = strprintf(player ? "Player %d" : "Monster %d", f);
+        mBeings.push_back(being);
+    }
+}
+
+void MockServer::sendBeing(Connection *const conn, const Being &being,
+                           bool move, int dstX, int dstY)
+{
+    const bool player = being.job < 1000;
+
+    MockPacket msg(move ? SMSG_BEING_MOVE : SMSG_BEING_VISIBLE);
+    msg.writeInt32(being.id);
+    msg.writeInt16(mScenario.speed);
+    msg.writeInt16(0);                      // opt1
+    msg.writeInt16(0);                      // opt2
+    msg.writeInt16(0);                      // option
+    msg.writeInt16(being.job);
+    msg.writeInt16(player ? 1 + being.id % 10 : 0);  // hair style
+    msg.writeInt16(0);                      // weapon
+    msg.writeInt16(0);                      // head bottom
+    if (move)
+        msg.writeInt32(getTick());
+    msg.writeInt16(0);                      // shield
+    msg.writeInt16(0);                      // head top
+    msg.writeInt16(0);                      // head mid
+    msg.writeInt16(player ? being.id % 8 : 0);  // hair color
+    msg.writeInt16(0);                      // shoes
+    if (player)
+    {
+        msg.writeInt16(0);                  // gloves
+        msg.writeInt32(0);                  // guild
+        msg.writeInt16(0);                  // guild emblem
+    }
+    else
+    {
+        msg.writeInt32(0);                  // hp
+        msg.writeInt32(0);                  // max hp
+    }
+    msg.writeInt16(0);                      // manner
+    msg.writeInt16(0);                      // opt3
+    msg.writeInt8(0);                       // karma
+    msg.writeInt8(being.id & 1);            // gender
+    if (move)
+        msg.writeCoordinatePair(being.x, being.y, dstX, dstY);
+    else
+        msg.writeCoordinates(being.x, being.y, 0);
+
+    if (conn)
+        send(conn, msg);
+    else
+        sendToGame(msg);
+}
+
+void MockServer::moveBeing()
+{
+    if (mBeings.empty())
+        return;
+
+    Being &being = mBeings[rand() % mBeings.size()];
+    const int dstX = randomCoord(mScenario.startX);
+    const int dstY = randomCoord(mScenario.startY);
+    sendBeing(nullptr, being, true, dstX, dstY);
+    being.x = dstX;
+    being.y = dstY;
+}
+
+void MockServer::chat()
+{
+    if (mBeings.empty())
+        return;
+
+    const Being &being = mBeings[rand() % mBeings.size()];
+    const int linesCount = sizeof(chatLines) / sizeof(chatLines[0]);
+    MockPacket msg(SMSG_BEING_CHAT);
+    msg.writeInt32(being.id);
+    msg.writeString(being.name + " : " + chatLines[rand() % linesCount]);
+    sendToGame(msg);
+}
+
+void MockServer::dropItem()
+{
+    FloorItem item;
+    item.id = mNextItemId ++;
+    item.removeTime = SDL_GetTicks() + mScenario.dropLifeTime * 1000;
+    mItems.push_back(item);
+
+    MockPacket msg(SMSG_ITEM_DROPPED);
+    msg.writeInt32(item.id);
+    msg.writeInt16(mScenario.dropItemId);
+    msg.writeInt8(1);                       // identify
+    msg.writeInt16(randomCoord(mScenario.startX));
+    msg.writeInt16(randomCoord(mScenario.startY));
+    msg.writeInt8(rand() % 16);             // sub x
+    msg.writeInt8(rand() % 16);             // sub y
+    msg.writeInt16(1 + rand() % 10);        // amount
+    sendToGame(msg);
+}
+
+void MockServer::printStats()
+{
+    const double seconds = mScenario.statsInterval;
+    std::cout << strprintf("connections %u, in %.1f pkt/s, "
+        "out %.1f pkt/s, %.1f KB/s, floor items %u",
+        static_cast<unsigned>(mConnections.size()),
+        mInPackets / seconds,
+        mOutPackets / seconds,
+        mOutBytes / seconds / 1024,
+        static_cast<unsigned>(mItems.size())) << std::endl;
+    mInPackets = 0;
+    mOutPackets = 0;
+    mOutBytes = 0;
+}
+
+int MockServer::randomCoord(int center) const
+{
+    const int coord = center - mScenario.radius
+        + rand() % (mScenario.radius * 2 + 1);
+    return coord > 0 ? coord : 0;
+}
+
+unsigned int MockServer::getTick() const
+{
+    return SDL_GetTicks() - mStartTime;
+}
@@ -0,0 +1,151 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_MOCKSERVER_H
+#define TEST_MOCKSERVER_H
+
+#include "test/mockscenario.h"
+
+#include <SDL_net.h>
+
+#include <list>
+#include <string>
+#include <vector>
+
+class MockPacket;
+
+/**
+ * Minimal tmwAthena compatible server for client load tests.
+ * Login, char and map server share one port, connection role is detected
+ * by first packet. After map is loaded by client, server spawns beings,
+ * moves them, floods chat and drops items with rates from MockScenario.
+ */
+class MockServer
+{
+    public:
+        MockServer(const MockScenario &scenario);
+
+        ~MockServer();
+
+        bool start();
+
+        void run();
+
+        void stop()
+        { mRunning = false; }
+
+    private:
+        struct Connection
+        {
+            Connection(TCPsocket sock) :
+                socket(sock),
+                inBuffer(),
+                inGame(false),
+                x(0),
+                y(0),
+                closed(false)
+            { }
+
+            TCPsocket socket;
+            std::string inBuffer;
+            bool inGame;
+            int x;
+            int y;
+            bool closed;
+        };
+
+        struct Being
+        {
+            int id;
+            int job;
+            int x;
+            int y;
+            std::string name;
+        };
+
+        struct FloorItem
+        {
+            int id;
+            unsigned int removeTime;
+        };
+
+        typedef std::list<Connection*> Connections;
+        typedef Connections::iterator ConnectionsIter;
+
+        void accept();
+
+        void receive(Connection *const conn);
+
+        void parse(Connection *const conn);
+
+        void handlePacket(Connection *const conn, uint16_t id,
+                          const char *data, int len);
+
+        void sendAccountId(Connection *const conn);
+
+        void writeAddress(MockPacket &packet) const;
+
+        void send(Connection *const conn, MockPacket &packet);
+
+        void sendToGame(MockPacket &packet);
+
+        void close(Connection *const conn);
+
+        void logic();
+
+        void spawnBeings();
+
+        void sendBeing(Connection *const conn, const Being &being,
+                       bool move, int dstX, int dstY);
+
+        void moveBeing();
+
+        void chat();
+
+        void dropItem();
+
+        void printStats();
+
+        int randomCoord(int center) const;
+
+        unsigned int getTick() const;
+
+        MockScenario mScenario;
+        TCPsocket mListenSocket;
+        SDLNet_SocketSet mSocketSet;
+        Connections mConnections;
+        std::vector<Being> mBeings;
+        std::list<FloorItem> mItems;
+        bool mRunning;
+        int mAccountId;
+        int mCharId;
+        int mNextItemId;
+        unsigned int mStartTime;
+        unsigned int mLastLogic;
+        unsigned int mLastStats;
+        double mMoveCounter;
+        double mChatCounter;
+        double mDropCounter;
+        int mOutPackets;
+        int mOutBytes;
+        int mInPackets;
+};
+
+#endif // TEST_MOCKSERVER_H
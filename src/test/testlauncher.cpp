@@ -30,8 +30,10 @@
 
 #include "gui/theme.h"
 
+#include "utils/blitkernels.h"
 #include "utils/gettext.h"
 #include "utils/mkdir.h"
+#include "utils/stringmatcher.h"
 #include "utils/stringutils.h"
 
 #include "resources/image.h"
@@ -74,6 +76,8 @@ int TestLauncher::exec()
         return testVideoDetection();
     else if (mTest == "100")
         return testInternal();
+    else if (mTest == "101")
+        return testChatHighlight();
 
     return -1;
 }
@@ -161,6 +165,7 @@ int TestLauncher::testFps()
     int tFps = calcFps(&start, &end, cnt);
     file << mTest << std::endl;
     file << tFps << std::endl;
+    file << BlitKernels::getModeName() << std::endl;
 
     sleep(1);
     return 0;
@@ -197,6 +202,8 @@ int TestLauncher::testInternal()
                 mainGraphics->drawImage(img[idx], x, y);
                 mainGraphics->drawImage(img[idx], x + 1, y);
                 mainGraphics->drawImage(img[idx], x, y + 5);
+                mainGraphics->setColor(gcn::Color(100, 150, 200, 128));
+                mainGraphics->fillRectangle(gcn::Rectangle(x, y, 20, 25));
 
                 idx ++;
                 if (idx > 3)
@@ -211,6 +218,7 @@ int TestLauncher::testInternal()
     file << mTest << std::endl;
     file << tFps << std::endl;
     file << mem << std::endl;
+    file << BlitKernels::getModeName() << std::endl;
 
     sleep(1);
     return 0;
@@ -224,6 +232,86 @@ int TestLauncher::testVideoDetection()
     return 0;
 }
 
+int TestLauncher::testChatHighlight()
+{
+    // recorded chat log, for example copy of chat log from logs dir
+    const std::string logName = Client::getLocalDataDirectory()
+        + "/chatlog.txt";
+    std::ifstream logFile(logName.c_str(), std::ios::in);
+    if (!logFile.is_open())
+    {
+        logger->log("Chat log for test not found: %s", logName.c_str());
+        return 1;
+    }
+
+    StringVect lines;
+    std::string line;
+    while (std::getline(logFile, line))
+        lines.push_back(line);
+    logFile.close();
+    if (lines.empty())
+        return 1;
+
+    static const char *const words[] =
+    {
+        "buy", "sell", "trade", "party", "guild", "help", "gm", "wts",
+        "wtb", "price", "gold", "armor", "bow", "arrow", "potion", "quest",
+        "boss", "event", "drop", "rare", "scam", "bot", "hack", "kill",
+        "pvp", "exp", "level", "skill", "magic", "spell", "heal", "warp"
+    };
+
+    StringVect patterns;
+    splitToStringVector(patterns, config.getStringValue(
+        "highlightWords"), ',');
+    for (unsigned f = 0; f < sizeof(words) / sizeof(words[0]); f ++)
+        patterns.push_back(words[f]);
+
+    StringMatcher matcher;
+    matcher.add(patterns);
+    matcher.build();
+
+    const int cnt = 50;
+    timeval start;
+    timeval end;
+    int found1 = 0;
+    int found2 = 0;
+
+    gettimeofday(&start, nullptr);
+    for (int k = 0; k < cnt; k ++)
+    {
+        for (StringVectCIter it = lines.begin(), it_end = lines.end();
+             it != it_end; ++ it)
+        {
+            if (findI(*it, patterns) != std::string::npos)
+                found1 ++;
+        }
+    }
+    gettimeofday(&end, nullptr);
+    const int linesFindI = calcFps(&start, &end,
+        cnt * static_cast<int>(lines.size()));
+
+    gettimeofday(&start, nullptr);
+    for (int k = 0; k < cnt; k ++)
+    {
+        for (StringVectCIter it = lines.begin(), it_end = lines.end();
+             it != it_end; ++ it)
+        {
+            if (matcher.find(*it))
+                found2 ++;
+        }
+    }
+    gettimeofday(&end, nullptr);
+    const int linesMatcher = calcFps(&start, &end,
+        cnt * static_cast<int>(lines.size()));
+
+    // lines per second for old and new matching, and matches count
+    file << mTest << std::endl;
+    file << linesFindI << std::endl;
+    file << linesMatcher << std::endl;
+    file << found1 / cnt << " " << found2 / cnt << std::endl;
+    return 0;
+}
+
 int TestLauncher::calcFps(timeval *start, timeval *end, int calls)
 {
     long mtime;
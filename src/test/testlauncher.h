@@ -49,6 +49,8 @@ class TestLauncher
 
         int testVideoDetection();
 
+        int testChatHighlight();
+
     private:
         std::string mTest;
 
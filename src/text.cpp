@@ -39,6 +39,9 @@
 
 #include "debug.h"
 
+IMPLEMENT_POOLED_OBJECT(Text, "Text", 64)
+IMPLEMENT_POOLED_OBJECT(FlashText, "FlashText", 32)
+
 int Text::mInstances = 0;
 ImageRect Text::mBubble;
 Image *Text::mBubbleArrow;
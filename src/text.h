@@ -27,6 +27,8 @@
 #include "graphics.h"
 #include "localconsts.h"
 
+#include "utils/objectpool.h"
+
 #include <guichan/color.hpp>
 
 class TextManager;
@@ -35,6 +37,8 @@ class Text
 {
     friend class TextManager;
 
+    DECLARE_POOLED_OBJECT
+
     public:
         /**
          * Constructor creates a text object to display on the screen.
@@ -86,6 +90,8 @@ class Text
 
 class FlashText : public Text
 {
+    DECLARE_POOLED_OBJECT
+
     public:
         FlashText(const std::string &text, int x, int y,
                   gcn::Graphics::Alignment alignment,
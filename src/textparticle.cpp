@@ -28,6 +28,8 @@
 
 #include "debug.h"
 
+IMPLEMENT_POOLED_OBJECT(TextParticle, "TextParticle", 64)
+
 TextParticle::TextParticle(Map *map, const std::string &text,
                            const gcn::Color *color,
                            gcn::Font *font, bool outline):
@@ -63,7 +65,7 @@ bool TextParticle::draw(Graphics *graphics, int offsetX, int offsetY) const
     }
 
     gcn::Color color = *mColor;
-//    color.a = (int)alpha;
+    color.a = static_cast<int>(alpha);
 
     TextRenderer::renderText(graphics, mText,
             screenX, screenY, gcn::Graphics::CENTER,
@@ -25,8 +25,12 @@
 
 #include "particle.h"
 
+#include "utils/objectpool.h"
+
 class TextParticle : public Particle
 {
+    DECLARE_POOLED_OBJECT
+
     public:
         /**
          * Constructor.
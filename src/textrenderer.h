@@ -25,6 +25,7 @@
 
 #include "graphics.h"
 
+#include "gui/sdlfont.h"
 #include "gui/theme.h"
 
 /**
@@ -49,6 +50,37 @@ class TextRenderer
     {
         graphics->setFont(font);
 
+        SDLFont *const sdlFont = dynamic_cast<SDLFont*>(font);
+        if (sdlFont && (outline || shadow))
+        {
+            // outline and shadow are cached together with text
+            switch (align)
+            {
+                case gcn::Graphics::CENTER:
+                    x -= sdlFont->getWidth(text) / 2;
+                    break;
+                case gcn::Graphics::RIGHT:
+                    x -= sdlFont->getWidth(text);
+                    break;
+                case gcn::Graphics::LEFT:
+                default:
+                    break;
+            }
+
+            unsigned char style = 0;
+            if (outline)
+                style |= SDLFont::TEXT_OUTLINE;
+            if (shadow)
+                style |= SDLFont::TEXT_SHADOW;
+
+            sdlFont->drawStyledString(graphics, text, x, y, color,
+                Theme::getThemeColor(Theme::OUTLINE, alpha),
+                Theme::getThemeColor(Theme::SHADOW, color.a / 2),
+                style);
+            graphics->setColor(color);
+            return;
+        }
+
         // Text shadow
         if (shadow)
         {
@@ -44,6 +44,27 @@ static char base64_table[] =
 };
 static char base64_pad = '=';
 
+/* reverse of base64_table, -1 for characters outside of alphabet */
+static const signed char base64_reverse_table[256] =
+{
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
 unsigned char *php3_base64_encode(const unsigned char *string,
                                   int length, int *ret_length)
 {
@@ -97,7 +118,6 @@ unsigned char *php3_base64_decode(const unsigned char *string,
 {
     const unsigned char *current = string;
     int ch, i = 0, j = 0, k;
-    char *chp;
 
     unsigned char *result = static_cast<unsigned char *>(
         calloc(length + 1, 1));
@@ -120,10 +140,9 @@ unsigned char *php3_base64_decode(const unsigned char *string,
 
         if (ch == ' ') ch = '+';
 
-        chp = strchr(base64_table, ch);
-        if (!chp)
+        ch = base64_reverse_table[ch];
+        if (ch < 0)
             continue;
-        ch = static_cast<int>(chp - base64_table);
 
         switch (i % 4)
         {
@@ -172,3 +191,49 @@ unsigned char *php3_base64_decode(const unsigned char *string,
     result[k] = '\0';
     return result;
 }
+
+/* decodes into preallocated buffer, skipping whitespace. returns length.
+ * plain table loop: for compressed layers inflate takes most of the time,
+ * and fast simd decoders need ssse3 byte shuffles and do not skip
+ * whitespace, which tmx files have in every line. */
+int php3_base64_decode_to(const unsigned char *string,
+                          unsigned char *result, int length)
+{
+    const unsigned char *current = string;
+    unsigned int bits = 0;
+    int ch, i = 0, j = 0;
+
+    while ((ch = *current++) != '\0')
+    {
+        if (ch == base64_pad)
+            break;
+
+        ch = base64_reverse_table[ch];
+        if (ch < 0)
+            continue;
+
+        bits = (bits << 6) | ch;
+        if (++i == 4)
+        {
+            if (j + 3 > length)
+                break;
+            result[j++] = static_cast<unsigned char>(bits >> 16);
+            result[j++] = static_cast<unsigned char>(bits >> 8);
+            result[j++] = static_cast<unsigned char>(bits);
+            bits = 0;
+            i = 0;
+        }
+    }
+
+    /* tail without full quantum */
+    if (i == 2 && j < length)
+    {
+        result[j++] = static_cast<unsigned char>(bits >> 4);
+    }
+    else if (i == 3 && j + 2 <= length)
+    {
+        result[j++] = static_cast<unsigned char>(bits >> 10);
+        result[j++] = static_cast<unsigned char>(bits >> 2);
+    }
+    return j;
+}
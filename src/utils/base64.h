@@ -32,5 +32,6 @@
 
 extern unsigned char *php3_base64_encode(const unsigned char *, int, int *);
 extern unsigned char *php3_base64_decode(const unsigned char *, int, int *);
+extern int php3_base64_decode_to(const unsigned char *, unsigned char *, int);
 
 #endif /* BASE64_H */
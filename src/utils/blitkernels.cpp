@@ -0,0 +1,347 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/blitkernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#ifdef __SSE2__
+#define BLIT_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__clang__) || __GNUC__ > 4 \
+    || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#define BLIT_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#include "debug.h"
+
+// all kernels use same formula for each channel:
+// d = (s * a + d * (256 - a)) >> 8, where alpha 255 is mapped to 256.
+// destination alpha byte is not changed.
+
+static const uint32_t rgbMask = 0x00ffffff;
+
+static void blendRowScalar(uint32_t *const dst, const uint32_t *const src,
+                           const int count, const int alpha)
+{
+    for (int f = 0; f < count; f ++)
+    {
+        const uint32_t s = src[f];
+        unsigned int a = ((s >> 24) * alpha) >> 8;
+        if (!a)
+            continue;
+        a += a >> 7;
+        const unsigned int a1 = 256 - a;
+        const uint32_t d = dst[f];
+        const uint32_t rb = (((s & 0xff00ff) * a
+            + (d & 0xff00ff) * a1) >> 8) & 0xff00ff;
+        const uint32_t g = (((s & 0xff00) * a
+            + (d & 0xff00) * a1) >> 8) & 0xff00;
+        dst[f] = rb | g | (d & ~rgbMask);
+    }
+}
+
+static void fillRowScalar(uint32_t *const dst, const int count,
+                          const uint32_t color, const int alpha)
+{
+    const unsigned int a1 = 256 - alpha;
+    const uint32_t rb = (color & 0xff00ff) * alpha;
+    const uint32_t g = (color & 0xff00) * alpha;
+    for (int f = 0; f < count; f ++)
+    {
+        const uint32_t d = dst[f];
+        dst[f] = (((rb + (d & 0xff00ff) * a1) >> 8) & 0xff00ff)
+            | (((g + (d & 0xff00) * a1) >> 8) & 0xff00)
+            | (d & ~rgbMask);
+    }
+}
+
+#ifdef BLIT_SSE2
+
+// blends two pixels unpacked to 16 bit channels
+static inline __m128i blendSse2(const __m128i s, const __m128i d,
+                                const __m128i alpha, const __m128i c256)
+{
+    __m128i a = _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm_srli_epi16(_mm_mullo_epi16(a, alpha), 8);
+    a = _mm_add_epi16(a, _mm_srli_epi16(a, 7));
+    return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a),
+        _mm_mullo_epi16(d, _mm_sub_epi16(c256, a))), 8);
+}
+
+static void blendRowSse2(uint32_t *const dst, const uint32_t *const src,
+                         const int count, const int alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha16 = _mm_set1_epi16(static_cast<short>(alpha));
+    const __m128i c256 = _mm_set1_epi16(256);
+    const __m128i mask = _mm_set1_epi32(rgbMask);
+    int f = 0;
+    for (; f + 4 <= count; f += 4)
+    {
+        const __m128i s = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + f));
+        // skip fully transparent pixels, common in sprites
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(
+            _mm_srli_epi32(s, 24), zero)) == 0xffff)
+        {
+            continue;
+        }
+        __m128i *const dstPtr = reinterpret_cast<__m128i*>(dst + f);
+        const __m128i d = _mm_loadu_si128(dstPtr);
+        const __m128i lo = blendSse2(_mm_unpacklo_epi8(s, zero),
+            _mm_unpacklo_epi8(d, zero), alpha16, c256);
+        const __m128i hi = blendSse2(_mm_unpackhi_epi8(s, zero),
+            _mm_unpackhi_epi8(d, zero), alpha16, c256);
+        _mm_storeu_si128(dstPtr, _mm_or_si128(
+            _mm_and_si128(_mm_packus_epi16(lo, hi), mask),
+            _mm_andnot_si128(mask, d)));
+    }
+    blendRowScalar(dst + f, src + f, count - f, alpha);
+}
+
+static void fillRowSse2(uint32_t *const dst, const int count,
+                        const uint32_t color, const int alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i sa = _mm_mullo_epi16(_mm_unpacklo_epi8(
+        _mm_set1_epi32(color), zero), _mm_set1_epi16(
+        static_cast<short>(alpha)));
+    const __m128i a1 = _mm_set1_epi16(static_cast<short>(256 - alpha));
+    const __m128i mask = _mm_set1_epi32(rgbMask);
+    int f = 0;
+    for (; f + 4 <= count; f += 4)
+    {
+        __m128i *const dstPtr = reinterpret_cast<__m128i*>(dst + f);
+        const __m128i d = _mm_loadu_si128(dstPtr);
+        const __m128i lo = _mm_srli_epi16(_mm_add_epi16(sa,
+            _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), a1)), 8);
+        const __m128i hi = _mm_srli_epi16(_mm_add_epi16(sa,
+            _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), a1)), 8);
+        _mm_storeu_si128(dstPtr, _mm_or_si128(
+            _mm_and_si128(_mm_packus_epi16(lo, hi), mask),
+            _mm_andnot_si128(mask, d)));
+    }
+    fillRowScalar(dst + f, count - f, color, alpha);
+}
+
+#endif  // BLIT_SSE2
+
+#ifdef BLIT_AVX2
+
+__attribute__((target("avx2")))
+static inline __m256i blendAvx2(const __m256i s, const __m256i d,
+                                const __m256i alpha, const __m256i c256)
+{
+    __m256i a = _mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm256_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm256_srli_epi16(_mm256_mullo_epi16(a, alpha), 8);
+    a = _mm256_add_epi16(a, _mm256_srli_epi16(a, 7));
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s, a),
+        _mm256_mullo_epi16(d, _mm256_sub_epi16(c256, a))), 8);
+}
+
+__attribute__((target("avx2")))
+static void blendRowAvx2(uint32_t *const dst, const uint32_t *const src,
+                         const int count, const int alpha)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha16 = _mm256_set1_epi16(static_cast<short>(alpha));
+    const __m256i c256 = _mm256_set1_epi16(256);
+    const __m256i mask = _mm256_set1_epi32(rgbMask);
+    int f = 0;
+    for (; f + 8 <= count; f += 8)
+    {
+        const __m256i s = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + f));
+        // skip fully transparent pixels, common in sprites
+        if (_mm256_testz_si256(s, _mm256_set1_epi32(
+            static_cast<int>(~rgbMask))))
+        {
+            continue;
+        }
+        __m256i *const dstPtr = reinterpret_cast<__m256i*>(dst + f);
+        const __m256i d = _mm256_loadu_si256(dstPtr);
+        const __m256i lo = blendAvx2(_mm256_unpacklo_epi8(s, zero),
+            _mm256_unpacklo_epi8(d, zero), alpha16, c256);
+        const __m256i hi = blendAvx2(_mm256_unpackhi_epi8(s, zero),
+            _mm256_unpackhi_epi8(d, zero), alpha16, c256);
+        _mm256_storeu_si256(dstPtr, _mm256_or_si256(
+            _mm256_and_si256(_mm256_packus_epi16(lo, hi), mask),
+            _mm256_andnot_si256(mask, d)));
+    }
+    blendRowScalar(dst + f, src + f, count - f, alpha);
+}
+
+__attribute__((target("avx2")))
+static void fillRowAvx2(uint32_t *const dst, const int count,
+                        const uint32_t color, const int alpha)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i sa = _mm256_mullo_epi16(_mm256_unpacklo_epi8(
+        _mm256_set1_epi32(color), zero), _mm256_set1_epi16(
+        static_cast<short>(alpha)));
+    const __m256i a1 = _mm256_set1_epi16(static_cast<short>(256 - alpha));
+    const __m256i mask = _mm256_set1_epi32(rgbMask);
+    int f = 0;
+    for (; f + 8 <= count; f += 8)
+    {
+        __m256i *const dstPtr = reinterpret_cast<__m256i*>(dst + f);
+        const __m256i d = _mm256_loadu_si256(dstPtr);
+        const __m256i lo = _mm256_srli_epi16(_mm256_add_epi16(sa,
+            _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), a1)), 8);
+        const __m256i hi = _mm256_srli_epi16(_mm256_add_epi16(sa,
+            _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), a1)), 8);
+        _mm256_storeu_si256(dstPtr, _mm256_or_si256(
+            _mm256_and_si256(_mm256_packus_epi16(lo, hi), mask),
+            _mm256_andnot_si256(mask, d)));
+    }
+    fillRowScalar(dst + f, count - f, color, alpha);
+}
+
+#endif  // BLIT_AVX2
+
+BlitKernels::BlendRow BlitKernels::mBlendRow = &blendRowScalar;
+BlitKernels::FillRow BlitKernels::mFillRow = &fillRowScalar;
+int BlitKernels::mMode = MODE_SCALAR;
+
+void BlitKernels::init(const bool simd)
+{
+    mBlendRow = &blendRowScalar;
+    mFillRow = &fillRowScalar;
+    mMode = MODE_SCALAR;
+    if (!simd)
+        return;
+
+#ifdef BLIT_AVX2
+    if (__builtin_cpu_supports("avx2"))
+    {
+        mBlendRow = &blendRowAvx2;
+        mFillRow = &fillRowAvx2;
+        mMode = MODE_AVX2;
+        return;
+    }
+#endif
+#ifdef BLIT_SSE2
+    mBlendRow = &blendRowSse2;
+    mFillRow = &fillRowSse2;
+    mMode = MODE_SSE2;
+#endif
+}
+
+const char *BlitKernels::getModeName()
+{
+    switch (mMode)
+    {
+        case MODE_AVX2:
+            return "AVX2";
+        case MODE_SSE2:
+            return "SSE2";
+        case MODE_SCALAR:
+        default:
+            return "scalar";
+    }
+}
+
+bool BlitKernels::canBlend(const SDL_Surface *const src,
+                           const SDL_Surface *const dst)
+{
+    if (!src || !dst)
+        return false;
+
+    const SDL_PixelFormat *const srcFormat = src->format;
+    const SDL_PixelFormat *const dstFormat = dst->format;
+    return srcFormat->BytesPerPixel == 4 && dstFormat->BytesPerPixel == 4
+        && (src->flags & SDL_SRCALPHA) && !(src->flags & SDL_RLEACCEL)
+        && srcFormat->Amask == ~rgbMask
+        && (dstFormat->Amask == 0 || dstFormat->Amask == ~rgbMask)
+        && srcFormat->Rmask == dstFormat->Rmask
+        && srcFormat->Gmask == dstFormat->Gmask
+        && srcFormat->Bmask == dstFormat->Bmask;
+}
+
+bool BlitKernels::canFill(const SDL_Surface *const dst)
+{
+    if (!dst)
+        return false;
+
+    const SDL_PixelFormat *const format = dst->format;
+    return format->BytesPerPixel == 4
+        && (format->Rmask | format->Gmask | format->Bmask) == rgbMask;
+}
+
+void BlitKernels::blend(SDL_Surface *const src,
+                        const SDL_Rect *const srcRect,
+                        SDL_Surface *const dst,
+                        const SDL_Rect *const dstRect,
+                        const int alpha)
+{
+    if (alpha <= 0 || srcRect->w <= 0 || srcRect->h <= 0)
+        return;
+
+    if (SDL_MUSTLOCK(src))
+        SDL_LockSurface(src);
+    if (SDL_MUSTLOCK(dst))
+        SDL_LockSurface(dst);
+
+    const uint8_t *srcRow = static_cast<const uint8_t*>(src->pixels)
+        + srcRect->y * src->pitch + srcRect->x * 4;
+    uint8_t *dstRow = static_cast<uint8_t*>(dst->pixels)
+        + dstRect->y * dst->pitch + dstRect->x * 4;
+    const int width = srcRect->w;
+    const int height = srcRect->h;
+    const int srcPitch = src->pitch;
+    const int dstPitch = dst->pitch;
+
+    for (int y = 0; y < height; y ++)
+    {
+        mBlendRow(reinterpret_cast<uint32_t*>(dstRow),
+            reinterpret_cast<const uint32_t*>(srcRow), width, alpha);
+        srcRow += srcPitch;
+        dstRow += dstPitch;
+    }
+
+    if (SDL_MUSTLOCK(dst))
+        SDL_UnlockSurface(dst);
+    if (SDL_MUSTLOCK(src))
+        SDL_UnlockSurface(src);
+}
+
+void BlitKernels::fill(SDL_Surface *const dst,
+                       const int x1, const int y1,
+                       const int x2, const int y2,
+                       const uint32_t color, const int alpha)
+{
+    if (x2 <= x1 || y2 <= y1)
+        return;
+
+    uint8_t *row = static_cast<uint8_t*>(dst->pixels)
+        + y1 * dst->pitch + x1 * 4;
+    const int width = x2 - x1;
+    const int pitch = dst->pitch;
+    for (int y = y1; y < y2; y ++)
+    {
+        mFillRow(reinterpret_cast<uint32_t*>(row), width, color, alpha);
+        row += pitch;
+    }
+}
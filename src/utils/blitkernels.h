@@ -0,0 +1,110 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_BLITKERNELS_H
+#define UTILS_BLITKERNELS_H
+
+#include <SDL.h>
+
+#include <stdint.h>
+
+/**
+ * Software mode pixel kernels for 32 bit surfaces. Fastest kernels
+ * supported by cpu (AVX2, SSE2 or plain C) are selected at start.
+ * All kernels give same result. Alpha parameters are in 0 - 256 range,
+ * use alphaFromFloat or alphaFromByte to convert.
+ */
+class BlitKernels
+{
+    public:
+        enum Mode
+        {
+            MODE_SCALAR = 0,
+            MODE_SSE2,
+            MODE_AVX2
+        };
+
+        /**
+         * Selects kernels. If simd is false, plain C kernels are used.
+         */
+        static void init(const bool simd);
+
+        static int getMode()
+        { return mMode; }
+
+        static const char *getModeName();
+
+        /**
+         * Checks if source with alpha channel can be blended to destination
+         * by these kernels.
+         */
+        static bool canBlend(const SDL_Surface *const src,
+                             const SDL_Surface *const dst);
+
+        /**
+         * Checks if translucent rectangles can be filled by these kernels.
+         */
+        static bool canFill(const SDL_Surface *const dst);
+
+        /**
+         * Blends already clipped rectangle from source to destination.
+         * Source alpha is multiplied by alpha (0 - 256).
+         */
+        static void blend(SDL_Surface *const src,
+                          const SDL_Rect *const srcRect,
+                          SDL_Surface *const dst,
+                          const SDL_Rect *const dstRect,
+                          const int alpha);
+
+        /**
+         * Blends color (in destination format) with alpha (0 - 256) to
+         * already clipped rectangle. Destination must be locked.
+         */
+        static void fill(SDL_Surface *const dst,
+                         const int x1, const int y1,
+                         const int x2, const int y2,
+                         const uint32_t color, const int alpha);
+
+        /**
+         * Converts alpha 0.0 - 1.0 to kernel alpha.
+         */
+        static int alphaFromFloat(const float alpha)
+        { return static_cast<int>(alpha * 256.0f); }
+
+        /**
+         * Converts alpha 0 - 255 to kernel alpha, 255 is mapped to 256.
+         */
+        static int alphaFromByte(const int alpha)
+        { return alpha + (alpha >> 7); }
+
+    private:
+        typedef void (*BlendRow)(uint32_t *const dst,
+                                 const uint32_t *const src,
+                                 const int count, const int alpha);
+
+        typedef void (*FillRow)(uint32_t *const dst, const int count,
+                                const uint32_t color, const int alpha);
+
+        static BlendRow mBlendRow;
+        static FillRow mFillRow;
+        static int mMode;
+};
+
+#endif  // UTILS_BLITKERNELS_H
@@ -0,0 +1,163 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/blitkernels.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "debug.h"
+
+namespace
+{
+    struct TestSurface
+    {
+        TestSurface(const int width, const int height,
+                    const uint32_t amask) :
+            pixels(width * height)
+        {
+            memset(&format, 0, sizeof(format));
+            memset(&surface, 0, sizeof(surface));
+            format.BytesPerPixel = 4;
+            format.BitsPerPixel = 32;
+            format.Rmask = 0xff0000;
+            format.Gmask = 0xff00;
+            format.Bmask = 0xff;
+            format.Amask = amask;
+            surface.format = &format;
+            surface.w = width;
+            surface.h = height;
+            surface.pitch = static_cast<uint16_t>(width * 4);
+            surface.pixels = &pixels[0];
+            if (amask)
+                surface.flags = SDL_SRCALPHA;
+        }
+
+        SDL_PixelFormat format;
+        SDL_Surface surface;
+        std::vector<uint32_t> pixels;
+    };
+
+    void fillRandom(std::vector<uint32_t> &pixels)
+    {
+        for (unsigned int f = 0; f < pixels.size(); f ++)
+        {
+            uint32_t alpha = rand() % 256;
+            if (f % 3 == 0)
+                alpha = 0;
+            else if (f % 7 == 0)
+                alpha = 255;
+            pixels[f] = (alpha << 24) | (rand() & 0xffffff);
+        }
+    }
+}
+
+TEST(blitkernels, blend)
+{
+    TestSurface src(1, 1, 0xff000000);
+    TestSurface dst(1, 1, 0);
+    SDL_Rect rect;
+    rect.x = 0;
+    rect.y = 0;
+    rect.w = 1;
+    rect.h = 1;
+    BlitKernels::init(false);
+    ASSERT_TRUE(BlitKernels::canBlend(&src.surface, &dst.surface));
+    EXPECT_FALSE(BlitKernels::canBlend(&dst.surface, &src.surface));
+
+    src.pixels[0] = 0xff123456;
+    dst.pixels[0] = 0xabcdef;
+    BlitKernels::blend(&src.surface, &rect, &dst.surface, &rect, 256);
+    EXPECT_EQ(0x123456U, dst.pixels[0]);
+
+    src.pixels[0] = 0x00123456;
+    BlitKernels::blend(&src.surface, &rect, &dst.surface, &rect, 256);
+    EXPECT_EQ(0x123456U, dst.pixels[0]);
+
+    src.pixels[0] = 0x80ffffff;
+    dst.pixels[0] = 0;
+    BlitKernels::blend(&src.surface, &rect, &dst.surface, &rect, 256);
+    EXPECT_EQ(0x808080U, dst.pixels[0]);
+
+    dst.pixels[0] = 0;
+    BlitKernels::blend(&src.surface, &rect, &dst.surface, &rect, 128);
+    EXPECT_EQ(0x3f3f3fU, dst.pixels[0]);
+}
+
+TEST(blitkernels, fill)
+{
+    TestSurface dst(1, 1, 0xff000000);
+    BlitKernels::init(false);
+    ASSERT_TRUE(BlitKernels::canFill(&dst.surface));
+    EXPECT_EQ(256, BlitKernels::alphaFromByte(255));
+    EXPECT_EQ(0, BlitKernels::alphaFromByte(0));
+    EXPECT_EQ(256, BlitKernels::alphaFromFloat(1.0f));
+
+    dst.pixels[0] = 0x80abcdef;
+    BlitKernels::fill(&dst.surface, 0, 0, 1, 1, 0x123456,
+        BlitKernels::alphaFromByte(255));
+    EXPECT_EQ(0x80123456U, dst.pixels[0]);
+
+    dst.pixels[0] = 0;
+    BlitKernels::fill(&dst.surface, 0, 0, 1, 1, 0xffffff, 128);
+    EXPECT_EQ(0x7f7f7fU, dst.pixels[0]);
+}
+
+TEST(blitkernels, simd)
+{
+    const int width = 67;
+    const int height = 5;
+    TestSurface src(width, height, 0xff000000);
+    TestSurface dst(width, height, 0);
+    fillRandom(src.pixels);
+    fillRandom(dst.pixels);
+    const std::vector<uint32_t> start = dst.pixels;
+
+    SDL_Rect srcRect;
+    srcRect.x = 1;
+    srcRect.y = 1;
+    srcRect.w = width - 3;
+    srcRect.h = height - 2;
+    SDL_Rect dstRect = srcRect;
+    dstRect.x = 2;
+
+    const int alphas[] = {256, 200, 1};
+    for (int f = 0; f < 3; f ++)
+    {
+        dst.pixels = start;
+        BlitKernels::init(false);
+        BlitKernels::blend(&src.surface, &srcRect, &dst.surface, &dstRect,
+            alphas[f]);
+        BlitKernels::fill(&dst.surface, 3, 0, width, height, 0x336699,
+            alphas[f]);
+        const std::vector<uint32_t> scalar = dst.pixels;
+
+        dst.pixels = start;
+        BlitKernels::init(true);
+        BlitKernels::blend(&src.surface, &srcRect, &dst.surface, &dstRect,
+            alphas[f]);
+        BlitKernels::fill(&dst.surface, 3, 0, width, height, 0x336699,
+            alphas[f]);
+        EXPECT_TRUE(scalar == dst.pixels) << BlitKernels::getModeName();
+    }
+}
@@ -0,0 +1,199 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/framepacer.h"
+
+#include <SDL_timer.h>
+
+#ifdef WIN32
+#include <windows.h>
+#elif defined __APPLE__
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+#include "debug.h"
+
+long long FramePacer::mStartTime = 0;
+long long FramePacer::mFrameStart = 0;
+long long FramePacer::mInputTime = 0;
+long long FramePacer::mNextFrame = 0;
+long long FramePacer::mStatsTime = 0;
+int FramePacer::mTickLength = 10;
+int FramePacer::mDoneTicks = 0;
+int FramePacer::mFrameTicks = 0;
+int FramePacer::mFramerate = 0;
+int FramePacer::mFrameLength = 0;
+long long FramePacer::mFrameSum = 0;
+int FramePacer::mFrameMax = 0;
+int FramePacer::mFrames = 0;
+long long FramePacer::mLatencySum = 0;
+int FramePacer::mLatencyMax = 0;
+int FramePacer::mLatencies = 0;
+int FramePacer::mDroppedTicks = 0;
+FramePacer::Stats FramePacer::mStats = { 0, 0, 0, 0, 0 };
+
+void FramePacer::init(const int tickLength)
+{
+    mTickLength = tickLength;
+    mStartTime = getTime();
+    mFrameStart = 0;
+    mInputTime = 0;
+    mNextFrame = 0;
+    mStatsTime = mStartTime;
+    mDoneTicks = 0;
+    mFrameTicks = 0;
+}
+
+long long FramePacer::getTime()
+{
+#ifdef WIN32
+    LARGE_INTEGER freq;
+    LARGE_INTEGER counter;
+    if (!QueryPerformanceFrequency(&freq) || !freq.QuadPart
+        || !QueryPerformanceCounter(&counter))
+    {
+        return static_cast<long long>(SDL_GetTicks()) * 1000;
+    }
+    return static_cast<long long>(counter.QuadPart / freq.QuadPart) * 1000000
+        + (counter.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+#elif defined __APPLE__
+    static mach_timebase_info_data_t timebase = { 0, 0 };
+    if (!timebase.denom)
+        mach_timebase_info(&timebase);
+    // divide first, to not overflow in multiply
+    return static_cast<long long>(mach_absolute_time() / 1000
+        * timebase.numer / timebase.denom);
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+int FramePacer::getTicks()
+{
+    return static_cast<int>((getTime() - mStartTime)
+        / (mTickLength * 1000));
+}
+
+void FramePacer::beginFrame()
+{
+    const long long now = getTime();
+    if (mFrameStart)
+    {
+        const int frameTime = static_cast<int>(now - mFrameStart);
+        mFrameSum += frameTime;
+        if (frameTime > mFrameMax)
+            mFrameMax = frameTime;
+        mFrames ++;
+    }
+    mFrameStart = now;
+    mInputTime = 0;
+
+    if (now - mStatsTime >= 1000000)
+    {
+        mStats.frameAvg = mFrames
+            ? static_cast<int>(mFrameSum / mFrames) : 0;
+        mStats.frameMax = mFrameMax;
+        mStats.latencyAvg = mLatencies
+            ? static_cast<int>(mLatencySum / mLatencies) : 0;
+        mStats.latencyMax = mLatencyMax;
+        mStats.droppedTicks = mDroppedTicks;
+        mFrameSum = 0;
+        mFrameMax = 0;
+        mFrames = 0;
+        mLatencySum = 0;
+        mLatencyMax = 0;
+        mLatencies = 0;
+        mDroppedTicks = 0;
+        mStatsTime = now;
+    }
+}
+
+void FramePacer::inputReceived()
+{
+    if (!mInputTime)
+        mInputTime = getTime();
+}
+
+int FramePacer::getLogicSteps()
+{
+    const int ticks = getTicks();
+    // ticks passed while previous frame was running
+    const int frameTicks = ticks - mFrameTicks;
+    mFrameTicks = ticks;
+
+    int due = ticks - mDoneTicks;
+    if (due <= 0)
+        return 0;
+
+    const int stallTicks = STALL_TIME / mTickLength;
+    if (due > stallTicks)
+    {
+        // real stall, skip game time instead of long catch-up
+        mDroppedTicks += due - CATCHUP_STEPS;
+        mDoneTicks += due - CATCHUP_STEPS;
+        due = CATCHUP_STEPS;
+    }
+
+    // slow frames (inactive window) still keep up with game time
+    int steps = frameTicks + CATCHUP_STEPS;
+    if (steps > due)
+        steps = due;
+    mDoneTicks += steps;
+    return steps;
+}
+
+void FramePacer::endFrame()
+{
+    if (!mInputTime)
+        return;
+
+    const int latency = static_cast<int>(getTime() - mInputTime);
+    mLatencySum += latency;
+    if (latency > mLatencyMax)
+        mLatencyMax = latency;
+    mLatencies ++;
+}
+
+void FramePacer::delay()
+{
+    if (!mFrameLength)
+        return;
+
+    const long long now = getTime();
+    mNextFrame += mFrameLength;
+    // after long stall start counting from now, do not run frames in burst
+    if (mNextFrame < now - mFrameLength)
+        mNextFrame = now;
+
+    const long long wait = mNextFrame - now;
+    if (wait >= 1000)
+        SDL_Delay(static_cast<uint32_t>(wait / 1000));
+}
+
+void FramePacer::setFramerate(const int fps)
+{
+    mFramerate = fps > 0 ? fps : 0;
+    mFrameLength = mFramerate ? 1000000 / mFramerate : 0;
+    mNextFrame = 0;
+}
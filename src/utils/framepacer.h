@@ -0,0 +1,126 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_FRAMEPACER_H
+#define UTILS_FRAMEPACER_H
+
+/**
+ * Main loop timing. Game ticks are derived from monotonic clock, so late or
+ * merged SDL timer callbacks can not slow down game time. Logic runs in
+ * fixed steps. Each frame runs all ticks passed since previous frame, and
+ * backlog from slow frames is caught up over several frames, so input,
+ * network and drawing are not blocked by long logic bursts. Game time is
+ * skipped only after real stalls.
+ */
+class FramePacer
+{
+    public:
+        /**
+         * Frame statistics for last second. Times in microseconds.
+         */
+        struct Stats
+        {
+            int frameAvg;
+            int frameMax;
+            int latencyAvg;
+            int latencyMax;
+            int droppedTicks;
+        };
+
+        enum
+        {
+            // extra logic steps in one frame to catch up backlog
+            CATCHUP_STEPS = 8,
+            // lag in milliseconds after which backlog is dropped
+            STALL_TIME = 2000
+        };
+
+        /**
+         * Starts game clock. Tick length in milliseconds.
+         */
+        static void init(const int tickLength);
+
+        /**
+         * Returns monotonic time in microseconds.
+         */
+        static long long getTime();
+
+        /**
+         * Returns ticks since init. Can be called from any thread.
+         */
+        static int getTicks();
+
+        /**
+         * Marks frame start.
+         */
+        static void beginFrame();
+
+        /**
+         * Marks that input events were handled in current frame.
+         */
+        static void inputReceived();
+
+        /**
+         * Returns number of logic steps to run in current frame.
+         */
+        static int getLogicSteps();
+
+        /**
+         * Marks frame end, after screen update.
+         */
+        static void endFrame();
+
+        /**
+         * Waits until next frame time, if frame rate limit is set.
+         */
+        static void delay();
+
+        static void setFramerate(const int fps);
+
+        static int getFramerate()
+        { return mFramerate; }
+
+        static const Stats &getStats()
+        { return mStats; }
+
+    private:
+        static long long mStartTime;
+        static long long mFrameStart;
+        static long long mInputTime;
+        static long long mNextFrame;
+        static long long mStatsTime;
+        static int mTickLength;
+        static int mDoneTicks;
+        static int mFrameTicks;
+        static int mFramerate;
+        static int mFrameLength;
+
+        static long long mFrameSum;
+        static int mFrameMax;
+        static int mFrames;
+        static long long mLatencySum;
+        static int mLatencyMax;
+        static int mLatencies;
+        static int mDroppedTicks;
+
+        static Stats mStats;
+};
+
+#endif  // UTILS_FRAMEPACER_H
@@ -0,0 +1,128 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/nametable.h"
+
+#include <vector>
+
+#include "debug.h"
+
+namespace
+{
+    std::vector<std::string> mNames;
+    std::vector<unsigned int> mHashes;
+    // open addressing table of ids, -1 is empty slot
+    std::vector<int> mSlots;
+    unsigned int mMask = 0;
+
+    unsigned int hashName(const std::string &name)
+    {
+        // FNV-1a
+        unsigned int hash = 2166136261U;
+        const size_t sz = name.size();
+        for (size_t f = 0; f < sz; f ++)
+        {
+            hash ^= static_cast<unsigned char>(name[f]);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+
+    void insertSlot(const int id)
+    {
+        unsigned int pos = mHashes[id] & mMask;
+        while (mSlots[pos] != -1)
+            pos = (pos + 1) & mMask;
+        mSlots[pos] = id;
+    }
+
+    void rehash(const unsigned int slots)
+    {
+        mSlots.assign(slots, -1);
+        mMask = slots - 1;
+        const int sz = static_cast<int>(mNames.size());
+        for (int f = 0; f < sz; f ++)
+            insertSlot(f);
+    }
+
+    int findSlot(const std::string &name, const unsigned int hash)
+    {
+        unsigned int pos = hash & mMask;
+        int id;
+        while ((id = mSlots[pos]) != -1)
+        {
+            if (mHashes[id] == hash && mNames[id] == name)
+                return id;
+            pos = (pos + 1) & mMask;
+        }
+        return -1;
+    }
+
+    void initTable()
+    {
+        mNames.push_back("");
+        mHashes.push_back(hashName(""));
+        rehash(1024);
+    }
+}
+
+int NameTable::intern(const std::string &name)
+{
+    if (mSlots.empty())
+        initTable();
+
+    const unsigned int hash = hashName(name);
+    int id = findSlot(name, hash);
+    if (id != -1)
+        return id;
+
+    id = static_cast<int>(mNames.size());
+    mNames.push_back(name);
+    mHashes.push_back(hash);
+    // keep load factor below 1/2
+    if (mNames.size() * 2 > mSlots.size())
+        rehash(static_cast<unsigned int>(mSlots.size()) * 2);
+    else
+        insertSlot(id);
+    return id;
+}
+
+int NameTable::find(const std::string &name)
+{
+    if (mSlots.empty())
+        initTable();
+
+    return findSlot(name, hashName(name));
+}
+
+const std::string &NameTable::getName(const int id)
+{
+    if (mSlots.empty())
+        initTable();
+
+    if (id < 0 || id >= static_cast<int>(mNames.size()))
+        return mNames[EMPTY];
+    return mNames[id];
+}
+
+int NameTable::size()
+{
+    return static_cast<int>(mNames.size());
+}
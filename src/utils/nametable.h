@@ -0,0 +1,55 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_NAMETABLE_H
+#define UTILS_NAMETABLE_H
+
+#include <string>
+
+/**
+ * Global table of interned names.
+ * Each name gets small stable id for whole session, so hot code can
+ * compare and index by id instead of comparing strings.
+ * Empty name always have id 0.
+ */
+class NameTable
+{
+    public:
+        static const int EMPTY = 0;
+
+        /**
+         * Returns id of name, adding name to table if need.
+         */
+        static int intern(const std::string &name);
+
+        /**
+         * Returns id of name or -1 if name never was interned.
+         */
+        static int find(const std::string &name);
+
+        /**
+         * Returns name for given id, or empty string for bad id.
+         */
+        static const std::string &getName(const int id);
+
+        static int size();
+};
+
+#endif // UTILS_NAMETABLE_H
@@ -0,0 +1,116 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/objectpool.h"
+
+#include "logger.h"
+
+#include <stdlib.h>
+
+#include "debug.h"
+
+ObjectPool *ObjectPool::mFirst = nullptr;
+
+ObjectPool::ObjectPool(const char *name, size_t size,
+                       unsigned int chunkSize) :
+    mName(name),
+    // keep pointer alignment and room for free list link
+    mSize((size + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*)),
+    mChunkSize(chunkSize),
+    mFree(nullptr),
+    mNext(mFirst),
+    mAllocs(0),
+    mReleases(0),
+    mLive(0),
+    mPeak(0),
+    mChunks(0),
+    mFallbacks(0)
+{
+    mFirst = this;
+}
+
+void ObjectPool::allocateChunk()
+{
+    char *chunk = static_cast<char*>(malloc(mSize * mChunkSize));
+    if (!chunk)
+        return;
+
+    mChunks ++;
+    for (unsigned int f = 0; f < mChunkSize; f ++)
+    {
+        void *const ptr = chunk + f * mSize;
+        *static_cast<void**>(ptr) = mFree;
+        mFree = ptr;
+    }
+}
+
+void *ObjectPool::allocate(size_t size)
+{
+    // derived classes inherit operator new with bigger size
+    if (size > mSize)
+    {
+        mFallbacks ++;
+        return ::operator new(size);
+    }
+
+    if (!mFree)
+    {
+        allocateChunk();
+        if (!mFree)
+            return ::operator new(size);
+    }
+
+    void *const ptr = mFree;
+    mFree = *static_cast<void**>(ptr);
+    mAllocs ++;
+    mLive ++;
+    if (mLive > mPeak)
+        mPeak = mLive;
+    return ptr;
+}
+
+void ObjectPool::release(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size > mSize)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    *static_cast<void**>(ptr) = mFree;
+    mFree = ptr;
+    mReleases ++;
+    mLive --;
+}
+
+void ObjectPool::logStats()
+{
+    for (ObjectPool *pool = mFirst; pool; pool = pool->mNext)
+    {
+        logger->log("pool %s: size %u, allocs %u, releases %u, live %u, "
+            "peak %u, chunks %u, fallbacks %u", pool->mName,
+            static_cast<unsigned int>(pool->mSize), pool->mAllocs,
+            pool->mReleases, pool->mLive, pool->mPeak, pool->mChunks,
+            pool->mFallbacks);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <stddef.h>
+
+/**
+ * Free list allocator for objects of one size. Memory is taken from heap
+ * in chunks and never returned, so steady state allocations not touch heap.
+ * Not thread safe, use only from main thread.
+ */
+class ObjectPool
+{
+    public:
+        ObjectPool(const char *name, size_t size, unsigned int chunkSize);
+
+        void *allocate(size_t size);
+
+        void release(void *ptr, size_t size);
+
+        /**
+         * Writes counters of all pools to log.
+         */
+        static void logStats();
+
+    private:
+        void allocateChunk();
+
+        const char *mName;
+        size_t mSize;
+        unsigned int mChunkSize;
+        void *mFree;
+        ObjectPool *mNext;
+
+        unsigned int mAllocs;
+        unsigned int mReleases;
+        unsigned int mLive;
+        unsigned int mPeak;
+        unsigned int mChunks;
+        unsigned int mFallbacks;
+
+        static ObjectPool *mFirst;
+};
+
+// memory debug need see every allocation
+#ifndef ENABLE_MEM_DEBUG
+
+/**
+ * Declares class operators new and delete allocating from pool.
+ * Pool itself defined by IMPLEMENT_POOLED_OBJECT in class source file.
+ */
+#define DECLARE_POOLED_OBJECT \
+    public: \
+        static void *operator new(size_t size); \
+        static void operator delete(void *ptr, size_t size);
+
+#define IMPLEMENT_POOLED_OBJECT(type, name, chunk) \
+    static ObjectPool type##Pool(name, sizeof(type), chunk); \
+    void *type::operator new(size_t size) \
+    { return type##Pool.allocate(size); } \
+    void type::operator delete(void *ptr, size_t size) \
+    { type##Pool.release(ptr, size); }
+
+#else
+
+#define DECLARE_POOLED_OBJECT
+#define IMPLEMENT_POOLED_OBJECT(type, name, chunk)
+
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include "logger.h"
+
+#include <SDL_thread.h>
+
+#include <cstring>
+#include <fstream>
+
+#include <sys/time.h>
+
+#include "debug.h"
+
+Profiler::FrameSample Profiler::mFrames[FRAMES];
+Profiler::Event Profiler::mEvents[EVENTS];
+volatile int Profiler::mCurrentTime[ZONES_NR];
+volatile int Profiler::mCurrentCalls[ZONES_NR];
+volatile unsigned int Profiler::mFramePos = 0;
+volatile unsigned int Profiler::mEventPos = 0;
+long long Profiler::mLastFrame = 0;
+
+static const char *const zoneNames[Profiler::ZONES_NR] =
+{
+    "Frame",
+    "Input",
+    "Logic",
+    "Game::logic",
+    "Actors logic",
+    "Particle::update",
+    "Network::dispatchMessages",
+    "ResourceManager::get",
+    "Gui::draw",
+    "Map::draw",
+    "Screen update"
+};
+
+static const int bucketLimits[Profiler::BUCKETS] =
+{
+    250, 500, 1000, 2000, 4000, 8000, 16000, 0x7fffffff
+};
+
+void Profiler::init()
+{
+    memset(mFrames, 0, sizeof(mFrames));
+    memset(mEvents, 0, sizeof(mEvents));
+    for (int f = 0; f < ZONES_NR; f ++)
+    {
+        mCurrentTime[f] = 0;
+        mCurrentCalls[f] = 0;
+    }
+    mFramePos = 0;
+    mEventPos = 0;
+    mLastFrame = getTime();
+}
+
+long long Profiler::getTime()
+{
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+    return static_cast<long long>(tv.tv_sec) * 1000000 + tv.tv_usec;
+}
+
+void Profiler::addTime(const Zone zone, const long long start)
+{
+    const long long now = getTime();
+    const int duration = static_cast<int>(now - start);
+
+    __sync_fetch_and_add(&mCurrentTime[zone], duration);
+    __sync_fetch_and_add(&mCurrentCalls[zone], 1);
+
+    const unsigned int pos = __sync_fetch_and_add(&mEventPos, 1)
+        & (EVENTS - 1);
+    Event &event = mEvents[pos];
+    event.start = start;
+    event.duration = duration;
+    event.thread = SDL_ThreadID();
+    event.zone = zone;
+}
+
+void Profiler::frame()
+{
+    const long long now = getTime();
+    if (!mLastFrame)
+        mLastFrame = now;
+
+    FrameSample &sample = mFrames[mFramePos & (FRAMES - 1)];
+    for (int f = 0; f < ZONES_NR; f ++)
+    {
+        sample.time[f] = __sync_fetch_and_and(&mCurrentTime[f], 0);
+        sample.calls[f] = __sync_fetch_and_and(&mCurrentCalls[f], 0);
+    }
+    sample.time[ZONE_FRAME] = static_cast<int>(now - mLastFrame);
+    sample.calls[ZONE_FRAME] = 1;
+    mLastFrame = now;
+
+    __sync_synchronize();
+    mFramePos ++;
+}
+
+void Profiler::getStats(const Zone zone, ZoneStats &stats)
+{
+    const unsigned int pos = mFramePos;
+    const unsigned int frames = pos < FRAMES
+        ? pos : static_cast<unsigned int>(FRAMES);
+
+    stats.last = 0;
+    stats.avg = 0;
+    stats.max = 0;
+    stats.calls = 0;
+    for (int f = 0; f < BUCKETS; f ++)
+        stats.histogram[f] = 0;
+
+    if (!frames)
+        return;
+
+    long long sum = 0;
+    for (unsigned int f = 0; f < frames; f ++)
+    {
+        const FrameSample &sample = mFrames[(pos - 1 - f) & (FRAMES - 1)];
+        const int time = sample.time[zone];
+        sum += time;
+        stats.calls += sample.calls[zone];
+        if (time > stats.max)
+            stats.max = time;
+        int bucket = 0;
+        while (time > bucketLimits[bucket])
+            bucket ++;
+        stats.histogram[bucket] ++;
+    }
+    stats.last = mFrames[(pos - 1) & (FRAMES - 1)].time[zone];
+    stats.avg = static_cast<int>(sum / frames);
+    stats.calls /= frames;
+}
+
+const char *Profiler::getZoneName(const Zone zone)
+{
+    const int idx = static_cast<int>(zone);
+    if (idx < 0 || idx >= ZONES_NR)
+        return "";
+    return zoneNames[idx];
+}
+
+int Profiler::getBucketLimit(const int bucket)
+{
+    if (bucket < 0 || bucket >= BUCKETS)
+        return 0;
+    return bucketLimits[bucket];
+}
+
+bool Profiler::dumpTrace(const std::string &fileName)
+{
+    std::ofstream file;
+    file.open(fileName.c_str(), std::ios::out);
+    if (!file.is_open())
+    {
+        logger->log("Cant open profiler trace file: %s", fileName.c_str());
+        return false;
+    }
+
+    const unsigned int pos = mEventPos;
+    const unsigned int events = pos < EVENTS
+        ? pos : static_cast<unsigned int>(EVENTS);
+
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    for (unsigned int f = pos - events; f != pos; f ++)
+    {
+        const Event &event = mEvents[f & (EVENTS - 1)];
+        if (event.zone < 0 || event.zone >= ZONES_NR)
+            continue;
+        if (!first)
+            file << ",";
+        first = false;
+        file << std::endl << "{\"name\":\""
+            << zoneNames[event.zone]
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+            << event.thread
+            << ",\"ts\":" << event.start
+            << ",\"dur\":" << event.duration << "}";
+    }
+    file << std::endl << "]}" << std::endl;
+    file.close();
+    logger->log("Profiler trace saved to: %s", fileName.c_str());
+    return true;
+}
+
+#endif  // ENABLE_PROFILER
@@ -0,0 +1,160 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_PROFILER_H
+#define UTILS_PROFILER_H
+
+#ifdef ENABLE_PROFILER
+
+#include <string>
+
+/**
+ * Hot path profiler. Compiled in only with ENABLE_PROFILER.
+ * Zones time is accumulated per frame and stored in ring of last frames.
+ * Separate ring keeps last timed events for Chrome trace dump.
+ * Both rings lock free, zones can be timed from any thread.
+ */
+class Profiler
+{
+    public:
+        enum Zone
+        {
+            ZONE_FRAME = 0,
+            ZONE_INPUT,
+            ZONE_LOGIC,
+            ZONE_GAME_LOGIC,
+            ZONE_ACTORS,
+            ZONE_PARTICLES,
+            ZONE_NETWORK,
+            ZONE_RESOURCES,
+            ZONE_DRAW,
+            ZONE_MAP_DRAW,
+            ZONE_SCREEN,
+            ZONES_NR
+        };
+
+        enum
+        {
+            FRAMES = 256,
+            EVENTS = 32768,
+            BUCKETS = 8
+        };
+
+        struct ZoneStats
+        {
+            int last;
+            int avg;
+            int max;
+            int calls;
+            int histogram[BUCKETS];
+        };
+
+        static void init();
+
+        /**
+         * Finishes current frame. Called once per main loop iteration.
+         */
+        static void frame();
+
+        /**
+         * Adds zone time. Times in microseconds from getTime().
+         */
+        static void addTime(const Zone zone, const long long start);
+
+        /**
+         * Calculates stats over frames in ring. Times in microseconds.
+         */
+        static void getStats(const Zone zone, ZoneStats &stats);
+
+        static const char *getZoneName(const Zone zone);
+
+        /**
+         * Returns upper bound of histogram bucket in microseconds.
+         */
+        static int getBucketLimit(const int bucket);
+
+        /**
+         * Writes last events in Chrome trace (chrome://tracing) format.
+         */
+        static bool dumpTrace(const std::string &fileName);
+
+        /**
+         * Returns current time in microseconds.
+         */
+        static long long getTime();
+
+    private:
+        struct FrameSample
+        {
+            int time[ZONES_NR];
+            int calls[ZONES_NR];
+        };
+
+        struct Event
+        {
+            long long start;
+            int duration;
+            unsigned int thread;
+            int zone;
+        };
+
+        static FrameSample mFrames[FRAMES];
+        static Event mEvents[EVENTS];
+        static volatile int mCurrentTime[ZONES_NR];
+        static volatile int mCurrentCalls[ZONES_NR];
+        static volatile unsigned int mFramePos;
+        static volatile unsigned int mEventPos;
+        static long long mLastFrame;
+};
+
+class ProfilerScope
+{
+    public:
+        ProfilerScope(const Profiler::Zone zone) :
+            mZone(zone),
+            mStart(Profiler::getTime())
+        { }
+
+        ~ProfilerScope()
+        { Profiler::addTime(mZone, mStart); }
+
+    private:
+        Profiler::Zone mZone;
+        long long mStart;
+};
+
+#define PROFILER_SCOPE(zone) \
+    const ProfilerScope profilerScope(Profiler::zone)
+#define PROFILER_BEGIN(zone) \
+    const long long profilerStart_##zone = Profiler::getTime()
+#define PROFILER_END(zone) \
+    Profiler::addTime(Profiler::zone, profilerStart_##zone)
+#define PROFILER_FRAME() Profiler::frame()
+
+#else  // ENABLE_PROFILER
+
+#define PROFILER_SCOPE(zone)
+#define PROFILER_BEGIN(zone)
+#define PROFILER_END(zone)
+#define PROFILER_FRAME()
+
+#endif  // ENABLE_PROFILER
+
+#endif  // UTILS_PROFILER_H
@@ -0,0 +1,247 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/stringmatcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+#include "debug.h"
+
+/**
+ * Folds one ASCII char or two bytes UTF-8 letter to lower case.
+ * Returns number of bytes consumed.
+ */
+static inline int foldChar(const unsigned char *const p, const size_t left,
+                           unsigned char &c1, unsigned char &c2)
+{
+    c1 = p[0];
+    if (c1 < 0x80)
+    {
+        if (c1 >= 'A' && c1 <= 'Z')
+            c1 += 'a' - 'A';
+        return 1;
+    }
+    if (left < 2 || (c1 != 0xc3 && c1 != 0xd0))
+        return 1;
+
+    c2 = p[1];
+    if (c1 == 0xc3)
+    {
+        // U+00C0 - U+00DE, except U+00D7
+        if (c2 >= 0x80 && c2 <= 0x9e && c2 != 0x97)
+            c2 += 0x20;
+    }
+    else if (c2 >= 0x90 && c2 <= 0x9f)
+    {
+        // U+0410 - U+041F
+        c2 += 0x20;
+    }
+    else if (c2 >= 0xa0 && c2 <= 0xaf)
+    {
+        // U+0420 - U+042F
+        c1 = 0xd1;
+        c2 -= 0x20;
+    }
+    else if (c2 >= 0x80 && c2 <= 0x8f)
+    {
+        // U+0400 - U+040F
+        c1 = 0xd1;
+        c2 += 0x10;
+    }
+    return 2;
+}
+
+StringMatcher::StringMatcher() :
+    mPatterns(),
+    mPatternsCount(0),
+    mAlphabetSize(1),
+    mTable(),
+    mOutput()
+{
+    memset(mClasses, 0, sizeof(mClasses));
+}
+
+void StringMatcher::clear()
+{
+    mPatterns.clear();
+    mPatternsCount = 0;
+    mAlphabetSize = 1;
+    mTable.clear();
+    mOutput.clear();
+    memset(mClasses, 0, sizeof(mClasses));
+}
+
+void StringMatcher::add(const std::string &pattern)
+{
+    if (pattern.empty())
+        return;
+    std::string str = pattern;
+    foldCase(str);
+    if (std::find(mPatterns.begin(), mPatterns.end(), str) != mPatterns.end())
+        return;
+    mPatterns.push_back(str);
+}
+
+void StringMatcher::add(const StringVect &patterns)
+{
+    for (StringVectCIter it = patterns.begin(), it_end = patterns.end();
+         it != it_end; ++ it)
+    {
+        add(*it);
+    }
+}
+
+void StringMatcher::build()
+{
+    mPatternsCount = static_cast<int>(mPatterns.size());
+    mTable.clear();
+    mOutput.clear();
+    memset(mClasses, 0, sizeof(mClasses));
+
+    // class 0 is for bytes not used in any pattern
+    mAlphabetSize = 1;
+    for (StringVectCIter it = mPatterns.begin(), it_end = mPatterns.end();
+         it != it_end; ++ it)
+    {
+        const std::string &str = *it;
+        for (size_t f = 0; f < str.size(); f ++)
+        {
+            const unsigned char c = static_cast<unsigned char>(str[f]);
+            if (!mClasses[c])
+                mClasses[c] = static_cast<unsigned char>(mAlphabetSize ++);
+        }
+    }
+
+    // trie
+    mTable.resize(mAlphabetSize, -1);
+    mOutput.resize(1, 0);
+    for (StringVectCIter it = mPatterns.begin(), it_end = mPatterns.end();
+         it != it_end; ++ it)
+    {
+        const std::string &str = *it;
+        int state = 0;
+        for (size_t f = 0; f < str.size(); f ++)
+        {
+            const int idx = state * mAlphabetSize
+                + getClass(static_cast<unsigned char>(str[f]));
+            if (mTable[idx] == -1)
+            {
+                const int newState = static_cast<int>(mOutput.size());
+                mTable[idx] = newState;
+                mTable.resize(mTable.size() + mAlphabetSize, -1);
+                mOutput.push_back(0);
+            }
+            state = mTable[idx];
+        }
+        mOutput[state] = 1;
+    }
+
+    // failure links folded into full transition table
+    std::vector<int> fail(mOutput.size(), 0);
+    std::queue<int> states;
+    for (int c = 0; c < mAlphabetSize; c ++)
+    {
+        int &next = mTable[c];
+        if (next == -1)
+        {
+            next = 0;
+        }
+        else
+        {
+            fail[next] = 0;
+            states.push(next);
+        }
+    }
+    while (!states.empty())
+    {
+        const int state = states.front();
+        states.pop();
+        const int failState = fail[state];
+        if (mOutput[failState])
+            mOutput[state] = 1;
+        for (int c = 0; c < mAlphabetSize; c ++)
+        {
+            int &next = mTable[state * mAlphabetSize + c];
+            const int failNext = mTable[failState * mAlphabetSize + c];
+            if (next == -1)
+            {
+                next = failNext;
+            }
+            else
+            {
+                fail[next] = failNext;
+                states.push(next);
+            }
+        }
+    }
+}
+
+bool StringMatcher::find(const std::string &text) const
+{
+    if (!mPatternsCount)
+        return false;
+
+    const unsigned char *const data
+        = reinterpret_cast<const unsigned char*>(text.data());
+    const size_t size = text.size();
+    const int *const table = &mTable[0];
+    const char *const output = &mOutput[0];
+    int state = 0;
+    unsigned char c1;
+    unsigned char c2 = 0;
+
+    for (size_t f = 0; f < size; )
+    {
+        const int len = foldChar(data + f, size - f, c1, c2);
+        state = table[state * mAlphabetSize + mClasses[c1]];
+        if (len == 2)
+        {
+            if (output[state])
+                return true;
+            state = table[state * mAlphabetSize + mClasses[c2]];
+        }
+        if (output[state])
+            return true;
+        f += len;
+    }
+    return false;
+}
+
+std::string &StringMatcher::foldCase(std::string &str)
+{
+    const size_t size = str.size();
+    if (!size)
+        return str;
+
+    unsigned char *const data = reinterpret_cast<unsigned char*>(&str[0]);
+    unsigned char c1;
+    unsigned char c2 = 0;
+    for (size_t f = 0; f < size; )
+    {
+        const int len = foldChar(data + f, size - f, c1, c2);
+        data[f] = c1;
+        if (len == 2)
+            data[f + 1] = c2;
+        f += len;
+    }
+    return str;
+}
@@ -0,0 +1,90 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_STRINGMATCHER_H
+#define UTILS_STRINGMATCHER_H
+
+#include "utils/stringvector.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Case insensitive multi pattern matcher (Aho-Corasick automaton).
+ * Patterns compiled once by build(), after that each find() scans
+ * text only once, independent of patterns count.
+ * Case folding handles ASCII, Latin-1 and Cyrillic UTF-8 letters.
+ */
+class StringMatcher
+{
+    public:
+        StringMatcher();
+
+        /**
+         * Removes all patterns.
+         */
+        void clear();
+
+        /**
+         * Adds pattern. Empty and duplicate patterns ignored.
+         * build() must be called before next find().
+         */
+        void add(const std::string &pattern);
+
+        void add(const StringVect &patterns);
+
+        /**
+         * Compiles automaton from added patterns.
+         */
+        void build();
+
+        /**
+         * Returns true if text contains any of patterns.
+         */
+        bool find(const std::string &text) const;
+
+        bool empty() const
+        { return mPatternsCount == 0; }
+
+        int size() const
+        { return mPatternsCount; }
+
+        /**
+         * Converts UTF-8 string to case folded form used by matcher.
+         */
+        static std::string &foldCase(std::string &str);
+
+    private:
+        int getClass(unsigned char c) const
+        { return mClasses[c]; }
+
+        StringVect mPatterns;
+        int mPatternsCount;
+        int mAlphabetSize;
+        unsigned char mClasses[256];
+
+        /** State transitions, mAlphabetSize entries per state. */
+        std::vector<int> mTable;
+
+        /** Non zero if some pattern ends in state. */
+        std::vector<char> mOutput;
+};
+
+#endif // UTILS_STRINGMATCHER_H
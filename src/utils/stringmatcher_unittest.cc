@@ -0,0 +1,129 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2012  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/stringmatcher.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "debug.h"
+
+TEST(stringmatcher, empty)
+{
+    StringMatcher matcher;
+    matcher.build();
+    EXPECT_TRUE(matcher.empty());
+    EXPECT_FALSE(matcher.find(""));
+    EXPECT_FALSE(matcher.find("test"));
+
+    matcher.add("");
+    matcher.build();
+    EXPECT_TRUE(matcher.empty());
+    EXPECT_FALSE(matcher.find("test"));
+}
+
+TEST(stringmatcher, duplicates)
+{
+    StringMatcher matcher;
+    for (int f = 0; f < 3; f ++)
+    {
+        matcher.clear();
+        matcher.add("word");
+        matcher.add("Word");
+        matcher.add("word");
+        matcher.build();
+        EXPECT_EQ(1, matcher.size());
+        EXPECT_TRUE(matcher.find("some words"));
+    }
+}
+
+TEST(stringmatcher, find1)
+{
+    StringMatcher matcher;
+    matcher.add("he");
+    matcher.add("she");
+    matcher.add("his");
+    matcher.add("hers");
+    matcher.build();
+    EXPECT_EQ(4, matcher.size());
+
+    EXPECT_TRUE(matcher.find("ushers"));
+    EXPECT_TRUE(matcher.find("this"));
+    EXPECT_TRUE(matcher.find("he"));
+    EXPECT_TRUE(matcher.find("ahishers"));
+    EXPECT_FALSE(matcher.find(""));
+    EXPECT_FALSE(matcher.find("h"));
+    EXPECT_FALSE(matcher.find("hi s"));
+    EXPECT_FALSE(matcher.find("test line"));
+}
+
+TEST(stringmatcher, find2)
+{
+    StringMatcher matcher;
+    matcher.add("abcd");
+    matcher.add("bc");
+    matcher.build();
+
+    EXPECT_TRUE(matcher.find("xabcx"));
+    EXPECT_TRUE(matcher.find("abcd"));
+    EXPECT_FALSE(matcher.find("abd"));
+    EXPECT_FALSE(matcher.find("acbd"));
+}
+
+TEST(stringmatcher, caseFold)
+{
+    StringMatcher matcher;
+    matcher.add("Player");
+    matcher.add("Привет");
+    matcher.add("ÉTÉ");
+    matcher.build();
+
+    EXPECT_TRUE(matcher.find("hello PLAYER!"));
+    EXPECT_TRUE(matcher.find("hello player"));
+    EXPECT_TRUE(matcher.find("ПРИВЕТ всем"));
+    EXPECT_TRUE(matcher.find("всем привет"));
+    EXPECT_TRUE(matcher.find("un été"));
+    EXPECT_FALSE(matcher.find("play"));
+    EXPECT_FALSE(matcher.find("приве"));
+
+    std::string str = "Test ЁЖИК ÀÉ";
+    EXPECT_EQ("test ёжик àé", StringMatcher::foldCase(str));
+}
+
+TEST(stringmatcher, rebuild)
+{
+    StringMatcher matcher;
+    matcher.add("first");
+    matcher.build();
+    EXPECT_TRUE(matcher.find("first"));
+    EXPECT_FALSE(matcher.find("second"));
+
+    matcher.add("second");
+    matcher.build();
+    EXPECT_TRUE(matcher.find("first"));
+    EXPECT_TRUE(matcher.find("second"));
+
+    matcher.clear();
+    matcher.add("third");
+    matcher.build();
+    EXPECT_FALSE(matcher.find("first"));
+    EXPECT_TRUE(matcher.find("third"));
+}
@@ -196,23 +196,24 @@ const std::string findSameSubstringI(const std::string &s1,
     return s1.substr(0, minLength);
 }
 
-size_t findI(std::string str, std::string subStr)
+size_t findI(const std::string &str, const std::string &subStr)
 {
-    str = toLower(str);
-    subStr = toLower(subStr);
-    return str.find(subStr);
+    std::string text = str;
+    std::string sub = subStr;
+    return toLower(text).find(toLower(sub));
 }
 
-size_t findI(std::string text, StringVect &list)
+size_t findI(const std::string &text, const StringVect &list)
 {
-    std::string str = toLower(text);
+    std::string str = text;
+    toLower(str);
+    std::string subStr;
     size_t idx;
     for (StringVectCIter i = list.begin(), i_end = list.end();
          i != i_end; ++ i)
     {
-        std::string subStr = *i;
-        subStr = toLower(subStr);
-        idx = str.find(subStr);
+        subStr = *i;
+        idx = str.find(toLower(subStr));
         if (idx != std::string::npos)
             return idx;
     }
@@ -473,41 +474,61 @@ void splitToStringSet(std::set<std::string> &tokens, const std::string &text,
     }
 }
 
-std::string combineDye(std::string file, std::string dye)
+std::string combineDye(const std::string &file, const std::string &dye)
 {
     if (dye.empty())
         return file;
-    size_t pos = file.find_last_of("|");
+    const size_t pos = file.find_last_of("|");
+    std::string str;
     if (pos != std::string::npos)
-        return file.substr(0, pos) + "|" + dye;
-    return file + "|" + dye;
+    {
+        str.reserve(pos + dye.length() + 1);
+        str.append(file, 0, pos);
+    }
+    else
+    {
+        str.reserve(file.length() + dye.length() + 1);
+        str.append(file);
+    }
+    str += '|';
+    str.append(dye);
+    return str;
 }
 
-std::string combineDye2(std::string file, std::string dye)
+std::string combineDye2(const std::string &file, const std::string &dye)
 {
     if (dye.empty())
         return file;
 
-    size_t pos = file.find_last_of("|");
-    if (pos != std::string::npos)
-    {
-        std::string dye1 = file.substr(pos + 1);
-        std::string str("");
-        file = file.substr(0, pos);
-        std::list<std::string> list1 = splitToStringList(dye1, ';');
-        std::list<std::string> list2 = splitToStringList(dye, ';');
-        for (std::list<std::string>::const_iterator it1 = list1.begin(),
-             it2 = list2.begin(), it1_end = list1.end(), it2_end = list2.end();
-             it1 != it1_end && it2 != it2_end; ++it1, ++it2)
-        {
-            str += (*it1) + ":" + (*it2) + ";";
-        }
-        return file + "|" + str;
-    }
-    else
-    {
+    const size_t pos = file.find_last_of("|");
+    if (pos == std::string::npos)
         return file;
+
+    // pair channels from file with palettes from dye, without splitting
+    // both strings to lists
+    std::string str;
+    str.reserve(file.length() + dye.length() + 8);
+    str.append(file, 0, pos + 1);
+    const size_t fileLen = file.length();
+    const size_t dyeLen = dye.length();
+    size_t pos1 = pos + 1;
+    size_t pos2 = 0;
+    while (pos1 < fileLen && pos2 < dyeLen)
+    {
+        size_t end1 = file.find(';', pos1);
+        if (end1 == std::string::npos)
+            end1 = fileLen;
+        size_t end2 = dye.find(';', pos2);
+        if (end2 == std::string::npos)
+            end2 = dyeLen;
+        str.append(file, pos1, end1 - pos1);
+        str += ':';
+        str.append(dye, pos2, end2 - pos2);
+        str += ';';
+        pos1 = end1 + 1;
+        pos2 = end2 + 1;
     }
+    return str;
 }
 
 std::string packList(std::list<std::string> &list)
@@ -134,9 +134,9 @@ int compareStrI(const std::string &a, const std::string &b);
  */
 bool isWordSeparator(char chr);
 
-size_t findI(std::string str, std::string subStr);
+size_t findI(const std::string &str, const std::string &subStr);
 
-size_t findI(std::string text, StringVect &list);
+size_t findI(const std::string &text, const StringVect &list);
 
 const std::string encodeStr(unsigned int value, unsigned int size = 0);
 
@@ -185,9 +185,9 @@ void splitToStringVector(StringVect &tokens,
 void splitToStringSet(std::set<std::string> &tokens,
                       const std::string &text, char separator);
 
-std::string combineDye(std::string file, std::string dye);
+std::string combineDye(const std::string &file, const std::string &dye);
 
-std::string combineDye2(std::string file, std::string dye);
+std::string combineDye2(const std::string &file, const std::string &dye);
 
 std::string packList(std::list<std::string> &list);
 
@@ -356,6 +356,8 @@ TEST(stringuntils, combineDye1)
     EXPECT_EQ("test", combineDye("test", ""));
     EXPECT_EQ("|line", combineDye("", "line"));
     EXPECT_EQ("test|line", combineDye("test", "line"));
+    EXPECT_EQ("test|line", combineDye("test|W", "line"));
+    EXPECT_EQ("a|b|line", combineDye("a|b|W", "line"));
 }
 
 TEST(stringuntils, combineDye2)
@@ -370,6 +372,10 @@ TEST(stringuntils, combineDye2)
         combineDye2("test.xml|#43413d,59544f,7a706c", "W"));
     EXPECT_EQ("test.xml|#43413d,59544f,7a706c:W;#123456:B;",
         combineDye2("test.xml|#43413d,59544f,7a706c;#123456", "W;B"));
+    EXPECT_EQ("test.xml|#43413d,59544f,7a706c:W;",
+        combineDye2("test.xml|#43413d,59544f,7a706c;#123456", "W"));
+    EXPECT_EQ("test.xml|R:W;:B;",
+        combineDye2("test.xml|R;;#123456", "W;B"));
 }
 
 TEST(stringuntils, packList1)
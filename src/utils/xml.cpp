@@ -24,6 +24,7 @@
 
 #include "logger.h"
 
+#include "resources/contentpack.h"
 #include "resources/resourcemanager.h"
 
 #include "utils/translation/podict.h"
@@ -48,6 +49,19 @@ namespace XML
         char *data = nullptr;
         if (useResman)
         {
+            // uncompressed files in content pack are parsed in place
+            const char *const packData = ContentPack::getData(filename, size);
+            if (packData)
+            {
+                mDoc = xmlParseMemory(packData, size);
+                if (!mDoc)
+                {
+                    logger->log("Error parsing XML file %s",
+                                filename.c_str());
+                }
+                return;
+            }
+
             ResourceManager *resman = ResourceManager::getInstance();
             data = static_cast<char*>(resman->loadFile(
                 filename.c_str(), size));